@@ -0,0 +1,105 @@
+#ifndef BENCH_FIXTURES_H
+#define BENCH_FIXTURES_H
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include "Catalog.h"
+#include "json.hpp"
+
+using json = nlohmann::json;
+
+namespace bench {
+
+/**
+ * @brief Builds the ID of the n-th synthetic item ("A0", "B0", ..., "Z0", "A1", ...).
+ * @param n Item number.
+ * @return An ID of at most five characters, as accepted by the scanner.
+ */
+inline std::string itemId(std::uint32_t n) {
+    return std::string(1, static_cast<char>('A' + n % 26)) + std::to_string(n / 26);
+}
+
+/**
+ * @brief Builds a synthetic JSON catalog.
+ *
+ * Every fourth item is eligible for Deal Type 1, and there is one Deal Type 2 set per
+ * eight items, each drawn from consecutive items so that sets overlap.
+ *
+ * @param itemCount Number of items.
+ * @param withDeals Whether to include any deals.
+ * @return The catalog data.
+ */
+inline json catalogData(std::uint32_t itemCount, bool withDeals = true) {
+    std::mt19937 random(itemCount);
+    std::uniform_int_distribution<int> cents(25, 2500);
+
+    json data;
+    data["items"] = json::array();
+    for (std::uint32_t i = 0; i < itemCount; ++i) {
+        data["items"].push_back({{"id", itemId(i)}, {"name", "Item " + std::to_string(i)}, {"price", cents(random) / 100.0}});
+    }
+
+    data["deals"] = json::object();
+    data["deals"]["deal_type_1"] = json::array();
+    data["deals"]["deal_type_2"] = json::array();
+    if (withDeals) {
+        for (std::uint32_t i = 0; i < itemCount; i += 4) {
+            data["deals"]["deal_type_1"].push_back(itemId(i));
+        }
+        for (std::uint32_t i = 0; i + 2 < itemCount; i += 8) {
+            data["deals"]["deal_type_2"].push_back({itemId(i), itemId(i + 1), itemId(i + 2)});
+        }
+    }
+    return data;
+}
+
+/**
+ * @brief Builds a synthetic catalog.
+ * @param itemCount Number of items.
+ * @param withDeals Whether to include any deals.
+ * @return The catalog.
+ */
+inline std::shared_ptr<const Catalog> makeCatalog(std::uint32_t itemCount, bool withDeals = true) {
+    return Catalog::fromJson(catalogData(itemCount, withDeals));
+}
+
+/**
+ * @brief Builds the scan lines of a basket.
+ *
+ * The basket holds the first distinctSkus items of the catalog, so that it overlaps the
+ * Deal Type 2 sets built by catalogData.
+ *
+ * @param distinctSkus Number of distinct items in the basket.
+ * @param unitsPerSku Quantity scanned for each item.
+ * @return One scan line per item, in the interactive input format.
+ */
+inline std::vector<std::string> basketLines(std::uint32_t distinctSkus, int unitsPerSku) {
+    std::vector<std::string> lines;
+    for (std::uint32_t i = 0; i < distinctSkus; ++i) {
+        lines.push_back(itemId(i) + " " + std::to_string(unitsPerSku));
+    }
+    return lines;
+}
+
+/**
+ * @class NullBuffer
+ * @brief Stream buffer that discards everything written to it, so formatting is still measured.
+ */
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int ch) override {
+        return ch;
+    }
+
+    std::streamsize xsputn(const char*, std::streamsize count) override {
+        return count;
+    }
+};
+
+} // namespace bench
+
+#endif // BENCH_FIXTURES_H
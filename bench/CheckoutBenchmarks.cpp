@@ -0,0 +1,162 @@
+// CheckoutBenchmarks.cpp
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <map>
+#include <ostream>
+#include "BenchFixtures.h"
+#include "Checkout.h"
+#include "ScanParser.h"
+
+namespace {
+
+// Catalogs are shared between benchmarks, keyed by item count and whether they have deals
+std::shared_ptr<const Catalog> cachedCatalog(std::uint32_t itemCount, bool withDeals = true) {
+    static std::map<std::pair<std::uint32_t, bool>, std::shared_ptr<const Catalog>> catalogs;
+    auto& catalog = catalogs[{itemCount, withDeals}];
+    if (!catalog) {
+        catalog = bench::makeCatalog(itemCount, withDeals);
+    }
+    return catalog;
+}
+
+// Catalog size x distinct SKUs per basket x units per SKU
+void basketArguments(benchmark::internal::Benchmark* benchmark) {
+    benchmark->ArgNames({"catalog", "skus", "units"});
+    benchmark->ArgsProduct({{64, 4096, 65536}, {1, 8, 64}, {1, 3, 10}});
+}
+
+void BM_ParseScanLine(benchmark::State& state) {
+    std::vector<std::string> lines = bench::basketLines(64, 3);
+    for (auto _ : state) {
+        for (const std::string& line : lines) {
+            benchmark::DoNotOptimize(parseScanLine(line));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(lines.size()));
+}
+BENCHMARK(BM_ParseScanLine);
+
+// scanItem is parseScanLine followed by processScannedItem, which also reprices the deals on the item;
+// subtract BM_ParseScanLine for the latter
+void BM_ScanItem(benchmark::State& state) {
+    Checkout checkout(cachedCatalog(static_cast<std::uint32_t>(state.range(0))));
+    checkout.setSink(nullptr);
+    std::vector<std::string> lines =
+        bench::basketLines(static_cast<std::uint32_t>(state.range(1)), static_cast<int>(state.range(2)));
+
+    for (auto _ : state) {
+        checkout.newBasket();
+        for (const std::string& line : lines) {
+            checkout.scanItem(line);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(lines.size()));
+}
+BENCHMARK(BM_ScanItem)->Apply(basketArguments);
+
+// Scan messages are formatted into a discarding stream, as they would be for a terminal
+void BM_ScanItemWithOutput(benchmark::State& state) {
+    bench::NullBuffer buffer;
+    std::ostream output(&buffer);
+    Checkout checkout(cachedCatalog(4096));
+    checkout.setSink(std::make_shared<TextSink>(output));
+    std::vector<std::string> lines = bench::basketLines(static_cast<std::uint32_t>(state.range(0)), 3);
+
+    for (auto _ : state) {
+        checkout.newBasket();
+        for (const std::string& line : lines) {
+            checkout.scanItem(line);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(lines.size()));
+}
+BENCHMARK(BM_ScanItemWithOutput)->ArgName("skus")->Arg(1)->Arg(8)->Arg(64);
+
+// Scans journaled with one commit (write and fdatasync) per batch of scans; subtract BM_ScanItem for the
+// journaling cost per scan. The journal is written to the working directory, so its file system decides
+// what a flush costs.
+void BM_ScanItemJournaled(benchmark::State& state) {
+    std::string path = "bench-scan-journal.wal";
+    std::remove(path.c_str());
+    auto journal = std::make_shared<ScanJournal>(path);
+    Checkout checkout(cachedCatalog(4096));
+    checkout.setSink(nullptr);
+    checkout.setJournal(journal, 1);
+    std::vector<std::string> lines = bench::basketLines(64, 3);
+    const std::size_t batch = static_cast<std::size_t>(state.range(0));
+
+    std::size_t scanned = 0;
+    for (auto _ : state) {
+        checkout.newBasket();
+        for (const std::string& line : lines) {
+            checkout.scanItem(line);
+            if (++scanned % batch == 0) {
+                journal->commit();
+            }
+        }
+    }
+    journal->commit();
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(lines.size()));
+
+    journal.reset();
+    checkout.setJournal(nullptr, 0);
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_ScanItemJournaled)->ArgName("batch")->Arg(1)->Arg(16)->Arg(256);
+
+// The optimal assignment is only searched for when the basket is finalized
+void BM_ApplyDealsOptimal(benchmark::State& state) {
+    Checkout checkout(cachedCatalog(static_cast<std::uint32_t>(state.range(0))));
+    checkout.setSink(nullptr);
+    checkout.setDealStrategy(DealStrategy::OPTIMAL);
+    for (const std::string& line :
+         bench::basketLines(static_cast<std::uint32_t>(state.range(1)), static_cast<int>(state.range(2)))) {
+        checkout.scanItem(line);
+    }
+
+    for (auto _ : state) {
+        checkout.applyDeals();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ApplyDealsOptimal)->Apply(basketArguments);
+
+// A whole basket: scanning with running totals, then finalizing; with greedy deals this matches BM_ScanItem
+void BM_Basket(benchmark::State& state) {
+    Checkout checkout(cachedCatalog(static_cast<std::uint32_t>(state.range(0))));
+    checkout.setSink(nullptr);
+    std::vector<std::string> lines =
+        bench::basketLines(static_cast<std::uint32_t>(state.range(1)), static_cast<int>(state.range(2)));
+
+    for (auto _ : state) {
+        checkout.newBasket();
+        for (const std::string& line : lines) {
+            checkout.scanItem(line);
+        }
+        checkout.applyDeals();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Basket)->Apply(basketArguments);
+
+void BM_GenerateReceipt(benchmark::State& state) {
+    bench::NullBuffer buffer;
+    std::ostream output(&buffer);
+    Checkout checkout(cachedCatalog(static_cast<std::uint32_t>(state.range(0))));
+    checkout.setSink(nullptr);
+    for (const std::string& line :
+         bench::basketLines(static_cast<std::uint32_t>(state.range(1)), static_cast<int>(state.range(2)))) {
+        checkout.scanItem(line);
+    }
+    checkout.applyDeals();
+    checkout.setSink(std::make_shared<TextSink>(output));
+
+    for (auto _ : state) {
+        checkout.generateReceipt();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GenerateReceipt)->Apply(basketArguments);
+
+} // namespace
@@ -0,0 +1,225 @@
+// DealBenchmarks.cpp
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include "BasketArena.h"
+#include "BenchFixtures.h"
+#include "Deal.h"
+#include "DealSolver.h"
+#include "PricedBasket.h"
+
+namespace {
+
+// Basket lines for the first skus items of a catalog, as a checkout session keeps them
+PricedBasket basketItems(const Catalog& catalog, std::uint32_t skus, int units) {
+    PricedBasket basket;
+    for (std::uint32_t i = 0; i < skus; ++i) {
+        basket.setLine(i, units, catalog.getItem(i).getPrice());
+    }
+    return basket;
+}
+
+// Distinct SKUs per basket x units per SKU
+void lineArguments(benchmark::internal::Benchmark* benchmark) {
+    benchmark->ArgNames({"skus", "units"});
+    benchmark->ArgsProduct({{1, 8, 64}, {1, 3, 10}});
+}
+
+// Each iteration clears the deals of every line first; BM_ClearDeals measures that on its own
+void BM_ClearDeals(benchmark::State& state) {
+    std::shared_ptr<const Catalog> catalog = bench::makeCatalog(64);
+    PricedBasket basket =
+        basketItems(*catalog, static_cast<std::uint32_t>(state.range(0)), static_cast<int>(state.range(1)));
+
+    for (auto _ : state) {
+        basket.clearDeals();
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_ClearDeals)->Apply(lineArguments);
+
+// Subtotal, savings and total of a priced basket, each a single pass over its columns
+void BM_BasketTotals(benchmark::State& state) {
+    std::shared_ptr<const Catalog> catalog = bench::makeCatalog(1024);
+    PricedBasket basket = basketItems(*catalog, static_cast<std::uint32_t>(state.range(0)), 3);
+    DealType1 threeForTwo(basket.getItemIndices());
+    for (std::size_t line = 0; line < basket.size(); line += 2) {
+        basket.useInDeal(line, 3);
+        basket.addFreeUnits(line, 1, threeForTwo);
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(basket.getPreDiscountTotal());
+        benchmark::DoNotOptimize(basket.getDiscountTotal());
+        benchmark::DoNotOptimize(basket.getFinalTotal());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BasketTotals)->ArgName("skus")->Arg(8)->Arg(64)->Arg(1024);
+
+// Three-item sets drawn from a large catalog, and a basket holding a spread of its items
+std::vector<DealType2> mixAndMatchSets(std::size_t count) {
+    std::vector<DealType2> sets;
+    std::uint32_t next = 1;
+    for (std::size_t i = 0; i < count; ++i) {
+        std::vector<std::uint32_t> items;
+        for (int j = 0; j < 3; ++j) {
+            next = next * 1103515245u + 12345u;
+            items.push_back((next >> 8) % 4096);
+        }
+        sets.emplace_back(items);
+    }
+    return sets;
+}
+
+PricedBasket spreadBasket(std::uint32_t skus) {
+    PricedBasket basket;
+    for (std::uint32_t i = 0; i < skus; ++i) {
+        basket.setLine(i * (4096 / skus), 1, Money::fromCents(100));
+    }
+    return basket;
+}
+
+// Which of many Deal Type 2 sets a basket satisfies, each checked against the presence bitset
+void BM_DealType2Satisfiable(benchmark::State& state) {
+    std::vector<DealType2> sets = mixAndMatchSets(static_cast<std::size_t>(state.range(0)));
+    PricedBasket basket = spreadBasket(static_cast<std::uint32_t>(state.range(1)));
+
+    for (auto _ : state) {
+        std::size_t satisfiable = 0;
+        for (const DealType2& set : sets) {
+            satisfiable += set.canApply(basket.getPresence());
+        }
+        benchmark::DoNotOptimize(satisfiable);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DealType2Satisfiable)->ArgNames({"sets", "skus"})->ArgsProduct({{1000, 10000}, {8, 1024}});
+
+// The same check made by searching the basket lines for each eligible item
+void BM_DealType2SatisfiableByLines(benchmark::State& state) {
+    std::vector<DealType2> sets = mixAndMatchSets(static_cast<std::size_t>(state.range(0)));
+    PricedBasket basket = spreadBasket(static_cast<std::uint32_t>(state.range(1)));
+
+    for (auto _ : state) {
+        std::size_t satisfiable = 0;
+        for (const DealType2& set : sets) {
+            const std::vector<std::uint32_t>& eligible = set.getEligibleItemIndices();
+            satisfiable += std::all_of(eligible.begin(), eligible.end(), [&](std::uint32_t itemIndex) {
+                std::size_t line = basket.lowerBound(itemIndex);
+                return line < basket.size() && basket.getItemIndex(line) == itemIndex;
+            });
+        }
+        benchmark::DoNotOptimize(satisfiable);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DealType2SatisfiableByLines)->ArgNames({"sets", "skus"})->ArgsProduct({{1000, 10000}, {8, 1024}});
+
+// Applies one deal to a basket of the first skus items, starting from no deals each time
+void applyDealLoop(benchmark::State& state, const Deal& deal) {
+    std::shared_ptr<const Catalog> catalog = bench::makeCatalog(64);
+    PricedBasket basket =
+        basketItems(*catalog, static_cast<std::uint32_t>(state.range(0)), static_cast<int>(state.range(1)));
+    std::vector<DealApplication> appliedDeals;
+
+    for (auto _ : state) {
+        basket.clearDeals();
+        appliedDeals.clear();
+        deal.applyDeal(basket, appliedDeals);
+        benchmark::DoNotOptimize(appliedDeals.data());
+    }
+}
+
+void BM_DealType1ApplyDeal(benchmark::State& state) {
+    applyDealLoop(state, DealType1({0}));
+}
+BENCHMARK(BM_DealType1ApplyDeal)->Apply(lineArguments);
+
+void BM_DealType2ApplyDeal(benchmark::State& state) {
+    applyDealLoop(state, DealType2({0, 1, 2}));
+}
+BENCHMARK(BM_DealType2ApplyDeal)->Apply(lineArguments);
+
+// The same two deals compiled as rules, as the catalog loads them
+void BM_RuleType1ApplyDeal(benchmark::State& state) {
+    applyDealLoop(state, RuleDeal({0}, DealRule::dealType1()));
+}
+BENCHMARK(BM_RuleType1ApplyDeal)->Apply(lineArguments);
+
+void BM_RuleType2ApplyDeal(benchmark::State& state) {
+    applyDealLoop(state, RuleDeal({0, 1, 2}, DealRule::dealType2()));
+}
+BENCHMARK(BM_RuleType2ApplyDeal)->Apply(lineArguments);
+
+// Rules the classic deals cannot express
+void BM_RuleBundleApplyDeal(benchmark::State& state) {
+    DealRule rule = DealRule::dealType2();
+    rule.discountedUnits = 2;
+    rule.percentOff = 50;
+    applyDealLoop(state, RuleDeal({0, 1, 2, 3}, rule));
+}
+BENCHMARK(BM_RuleBundleApplyDeal)->Apply(lineArguments);
+
+void BM_RuleSpendThresholdApplyDeal(benchmark::State& state) {
+    DealRule rule;
+    rule.op = DealRule::Op::TIERED_SPEND;
+    rule.tiers = {{500, 5}, {2000, 10}};
+    applyDealLoop(state, RuleDeal({0, 1, 2, 3}, rule));
+}
+BENCHMARK(BM_RuleSpendThresholdApplyDeal)->Apply(lineArguments);
+
+// Every deal that involves at least one line of the basket, in deal order
+std::vector<const Deal*> touchedDeals(const Catalog& catalog, const PricedBasket& basket) {
+    std::vector<std::uint32_t> dealIndices;
+    for (std::uint32_t itemIndex : basket.getItemIndices()) {
+        const std::vector<std::uint32_t>& itemDeals = catalog.getDealsForItem(itemIndex);
+        dealIndices.insert(dealIndices.end(), itemDeals.begin(), itemDeals.end());
+    }
+    std::sort(dealIndices.begin(), dealIndices.end());
+    dealIndices.erase(std::unique(dealIndices.begin(), dealIndices.end()), dealIndices.end());
+    std::vector<const Deal*> deals;
+    for (std::uint32_t index : dealIndices) {
+        deals.push_back(catalog.getDeals()[index].get());
+    }
+    return deals;
+}
+
+// Latency of the optimal assignment search over every deal the basket touches
+void BM_DealSolver(benchmark::State& state) {
+    std::shared_ptr<const Catalog> catalog = bench::makeCatalog(64);
+    PricedBasket basket =
+        basketItems(*catalog, static_cast<std::uint32_t>(state.range(0)), static_cast<int>(state.range(1)));
+    std::vector<const Deal*> deals = touchedDeals(*catalog, basket);
+
+    DealSolver solver;
+    std::uint64_t nodes = 0;
+    for (auto _ : state) {
+        DealSolver::Result result = solver.solve(basket, deals);
+        nodes += result.nodes;
+        benchmark::DoNotOptimize(result.savings);
+    }
+    state.counters["nodes"] = benchmark::Counter(static_cast<double>(nodes), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_DealSolver)->Apply(lineArguments);
+
+// The same search with its state in a basket arena, released after each basket as a checkout session does
+void BM_DealSolverArena(benchmark::State& state) {
+    std::shared_ptr<const Catalog> catalog = bench::makeCatalog(64);
+    PricedBasket basket =
+        basketItems(*catalog, static_cast<std::uint32_t>(state.range(0)), static_cast<int>(state.range(1)));
+    std::vector<const Deal*> deals = touchedDeals(*catalog, basket);
+
+    DealSolver solver;
+    BasketArena arena;
+    for (auto _ : state) {
+        {
+            DealSolver::Result result = solver.solve(basket, deals, &arena);
+            benchmark::DoNotOptimize(result.savings);
+        }
+        arena.release();
+    }
+}
+BENCHMARK(BM_DealSolverArena)->Apply(lineArguments);
+
+} // namespace
@@ -0,0 +1,81 @@
+#ifndef BASKET_ARENA_H
+#define BASKET_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+/**
+ * @class BasketArena
+ * @brief Monotonic memory resource for the working state of one basket, released in one shot.
+ *
+ * Allocations bump a pointer through a block the arena owns; deallocation does nothing and
+ * release() makes the whole block available again. When a basket needs more than the block
+ * holds, the excess comes from the upstream heap, and release() grows the block to cover it,
+ * so a lane that keeps pricing baskets of similar size stops touching the heap after the
+ * first few.
+ *
+ * Containers using the arena must be gone before release() is called. The arena is not
+ * thread-safe; each checkout session owns one.
+ */
+class BasketArena : public std::pmr::memory_resource {
+public:
+    /// Size of the block when none is given.
+    static constexpr std::size_t DEFAULT_CAPACITY = 16 * 1024;
+
+    /**
+     * @brief Constructs an arena.
+     * @param capacity Initial size of the block in bytes.
+     */
+    explicit BasketArena(std::size_t capacity = DEFAULT_CAPACITY);
+
+    ~BasketArena() override;
+
+    BasketArena(const BasketArena&) = delete;
+    BasketArena& operator=(const BasketArena&) = delete;
+
+    /**
+     * @brief Frees everything allocated since the last release, growing the block if it overflowed.
+     */
+    void release();
+
+    /**
+     * @brief Gets the size of the block.
+     * @return The capacity in bytes.
+     */
+    std::size_t getCapacity() const;
+
+    /**
+     * @brief Gets the bytes handed out since the last release, including any overflow.
+     * @return The number of bytes.
+     */
+    std::size_t getUsed() const;
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+    /**
+     * @struct Overflow
+     * @brief Header of a block taken from the heap once the arena's own block is full.
+     */
+    struct Overflow {
+        Overflow* next;    ///< Previously taken overflow block.
+        std::size_t bytes; ///< Size of the block, including this header.
+    };
+
+    std::unique_ptr<std::byte[]> block; ///< The arena's own block.
+    std::size_t capacity;               ///< Size of the block in bytes.
+    std::size_t offset = 0;             ///< Bytes of the block handed out since the last release.
+    Overflow* overflow = nullptr;       ///< Overflow blocks taken since the last release, newest first.
+    std::size_t overflowBytes = 0;      ///< Bytes handed out from overflow blocks since the last release.
+
+    /**
+     * @brief Returns every overflow block to the heap.
+     */
+    void freeOverflow();
+};
+
+#endif // BASKET_ARENA_H
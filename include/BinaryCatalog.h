@@ -0,0 +1,152 @@
+#ifndef BINARY_CATALOG_H
+#define BINARY_CATALOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Money.h"
+#include "json.hpp"
+
+using json = nlohmann::json;
+
+/**
+ * @class BinaryCatalog
+ * @brief Read-only view of a compiled binary catalog image mapped into memory.
+ *
+ * The image is produced by `catalog-compile` from the JSON catalog and contains:
+ * - a fixed-size header (magic, format version, table offsets and an FNV-1a checksum),
+ * - fixed-size item records sorted by item ID,
+ * - the Deal Type 1 table (item indices) and the Deal Type 2 table (sets of item indices),
+ * - a string table holding item IDs and names.
+ *
+ * Lookups are served directly from the mapping and never allocate. Images are written
+ * in host byte order and are not portable between little- and big-endian machines.
+ */
+class BinaryCatalog {
+public:
+    /// Magic bytes at the start of every catalog image.
+    static constexpr char MAGIC[8] = {'S', 'M', 'C', 'A', 'T', 'L', 'G', '\0'};
+
+    /// Current image format version.
+    static constexpr std::uint32_t FORMAT_VERSION = 1;
+
+    /// Index value used for "no item".
+    static constexpr std::uint32_t NO_ITEM = 0xFFFFFFFFu;
+
+    /**
+     * @struct ItemView
+     * @brief Non-owning view of one item record.
+     */
+    struct ItemView {
+        std::string_view id;   ///< Item ID, pointing into the mapping.
+        std::string_view name; ///< Item name, pointing into the mapping.
+        Money price;           ///< Item price.
+    };
+
+    /**
+     * @struct DealType2View
+     * @brief Non-owning view of one Deal Type 2 set.
+     */
+    struct DealType2View {
+        const std::uint32_t* itemIndices; ///< Indices of the eligible items, sorted by item ID.
+        std::uint32_t size;               ///< Number of eligible items in the set.
+    };
+
+    /**
+     * @brief Maps a catalog image and validates its header and checksum.
+     * @param filename Path to the binary catalog.
+     * @throws std::runtime_error if the file cannot be mapped or is not a valid catalog image.
+     */
+    explicit BinaryCatalog(const std::string& filename);
+
+    /**
+     * @brief Unmaps the image.
+     */
+    ~BinaryCatalog();
+
+    BinaryCatalog(const BinaryCatalog&) = delete;
+    BinaryCatalog& operator=(const BinaryCatalog&) = delete;
+
+    /**
+     * @brief Compiles a JSON catalog into a binary image.
+     * @param data JSON object containing items and deals data.
+     * @param filename Path of the image to write.
+     * @throws InvalidItemException if item data is invalid.
+     * @throws InvalidDealException if deal data is invalid or has deal rules, which the image cannot hold.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    static void compile(const json& data, const std::string& filename);
+
+    /**
+     * @brief Checks whether a file starts with the catalog image magic bytes.
+     * @param filename Path to the file.
+     * @return True if the file looks like a binary catalog image.
+     */
+    static bool isBinaryCatalog(const std::string& filename);
+
+    /**
+     * @brief Gets the number of items in the catalog.
+     * @return The item count.
+     */
+    std::uint32_t getItemCount() const;
+
+    /**
+     * @brief Gets an item by its index in ID order.
+     * @param index Item index, less than getItemCount().
+     * @return A view of the item.
+     */
+    ItemView getItem(std::uint32_t index) const;
+
+    /**
+     * @brief Finds an item by ID using binary search over the sorted records.
+     * @param id The item ID.
+     * @return The item index, or NO_ITEM if the ID is not in the catalog.
+     */
+    std::uint32_t findItem(std::string_view id) const;
+
+    /**
+     * @brief Gets the number of items eligible for Deal Type 1.
+     * @return The Deal Type 1 table size.
+     */
+    std::uint32_t getDealType1Count() const;
+
+    /**
+     * @brief Gets the Deal Type 1 table.
+     * @return Pointer to getDealType1Count() item indices.
+     */
+    const std::uint32_t* getDealType1Items() const;
+
+    /**
+     * @brief Gets the number of Deal Type 2 sets.
+     * @return The Deal Type 2 table size.
+     */
+    std::uint32_t getDealType2Count() const;
+
+    /**
+     * @brief Gets a Deal Type 2 set.
+     * @param index Set index, less than getDealType2Count().
+     * @return A view of the set.
+     */
+    DealType2View getDealType2(std::uint32_t index) const;
+
+private:
+    struct Header;
+    struct ItemRecord;
+    struct DealType2Record;
+
+    const unsigned char* data = nullptr; ///< Start of the mapped image.
+    std::size_t size = 0;                ///< Size of the mapped image in bytes.
+    const Header* header = nullptr;      ///< Image header.
+    const ItemRecord* items = nullptr;   ///< Item records, sorted by ID.
+    const std::uint32_t* dealType1 = nullptr;    ///< Deal Type 1 item indices.
+    const DealType2Record* dealType2 = nullptr;  ///< Deal Type 2 sets.
+    const char* strings = nullptr;       ///< String table.
+
+#ifdef _WIN32
+    std::vector<unsigned char> buffer;   ///< Image contents, read into memory where mmap is unavailable.
+#endif
+};
+
+#endif // BINARY_CATALOG_H
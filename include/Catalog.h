@@ -0,0 +1,169 @@
+#ifndef CATALOG_H
+#define CATALOG_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Item.h"
+#include "Deal.h"
+#include "BinaryCatalog.h"
+#include "ItemIndex.h"
+#include "json.hpp"
+
+using json = nlohmann::json;
+
+/**
+ * @class Catalog
+ * @brief Immutable set of items and deals shared by any number of checkout sessions.
+ *
+ * A catalog is built once by one of the factory functions and is never modified afterwards,
+ * so it can be read from many threads without locking. Items are stored sorted by ID and an
+ * item's position is its dense index. Item IDs and names are views into one string table
+ * owned by the catalog or, for a binary catalog, into the mapped image, which the catalog
+ * keeps mapped for as long as it lives. Deals, the two classic types as well as the catalog's
+ * declarative rules, are compiled into RuleDeals, stored in stage order (see Deal::getStage)
+ * and indexed by the items they involve.
+ */
+class Catalog {
+public:
+    /**
+     * @brief Constructs an empty catalog with no items and no deals.
+     */
+    Catalog();
+
+    Catalog(const Catalog&) = delete;
+    Catalog& operator=(const Catalog&) = delete;
+
+    /**
+     * @brief Loads a catalog from a JSON file or a compiled binary catalog.
+     *
+     * Binary catalogs produced by `catalog-compile` are recognised by their magic bytes.
+     *
+     * @param filename Path to the JSON file or binary catalog.
+     * @return The loaded catalog.
+     * @throws std::runtime_error if the file cannot be opened or is not a valid catalog image.
+     * @throws json::parse_error if the JSON is malformed.
+     * @throws InvalidItemException if item data is invalid.
+     * @throws InvalidDealException if deal data is invalid.
+     */
+    static std::shared_ptr<const Catalog> fromFile(const std::string& filename);
+
+    /**
+     * @brief Builds a catalog from a JSON object.
+     * @param data JSON object containing items and deals data.
+     * @return The loaded catalog.
+     * @throws InvalidItemException if item data is invalid.
+     * @throws InvalidDealException if deal data is invalid.
+     */
+    static std::shared_ptr<const Catalog> fromJson(const json& data);
+
+    /**
+     * @brief Builds a catalog from a mapped binary catalog.
+     *
+     * Item IDs and names are served from the mapping, so no item costs an allocation.
+     *
+     * @param binary The binary catalog; the catalog keeps it mapped.
+     * @return The loaded catalog.
+     */
+    static std::shared_ptr<const Catalog> fromBinary(std::shared_ptr<const BinaryCatalog> binary);
+
+    /**
+     * @brief Gets the number of items.
+     * @return The item count.
+     */
+    std::uint32_t getItemCount() const;
+
+    /**
+     * @brief Gets an item by its dense index.
+     * @param index Item index, less than getItemCount().
+     * @return The item.
+     */
+    const Item& getItem(std::uint32_t index) const;
+
+    /**
+     * @brief Gets all items, sorted by ID.
+     * @return The items.
+     */
+    const std::vector<Item>& getItems() const;
+
+    /**
+     * @brief Finds an item by its exact ID.
+     * @param itemId The item ID.
+     * @return The item index, or ItemIndex::NOT_FOUND.
+     */
+    std::uint32_t findItem(std::string_view itemId) const;
+
+    /**
+     * @brief Finds an item by a scanned ID, ignoring case.
+     * @param itemId The scanned item ID.
+     * @return The item index, or ItemIndex::NOT_FOUND.
+     */
+    std::uint32_t findScannedItem(std::string_view itemId) const;
+
+    /**
+     * @brief Gets all deals, in stage order and otherwise in load order.
+     * @return The deals.
+     */
+    const std::vector<std::shared_ptr<const Deal>>& getDeals() const;
+
+    /**
+     * @brief Gets the deals an item takes part in.
+     * @param itemIndex Item index, less than getItemCount().
+     * @return Ascending indices into getDeals().
+     */
+    const std::vector<std::uint32_t>& getDealsForItem(std::uint32_t itemIndex) const;
+
+private:
+    // Items, sorted by item ID; an item's position is its dense index
+    std::vector<Item> items;
+
+    // IDs and names of items loaded from JSON, which the items refer to
+    std::string strings;
+
+    // Mapped image the items of a binary catalog refer to
+    std::shared_ptr<const BinaryCatalog> binary;
+
+    // Hash index from packed item ID to dense item index
+    ItemIndex itemIndex;
+
+    // Deals, in stage order (see Deal::getStage), otherwise load order
+    std::vector<std::shared_ptr<const Deal>> deals;
+
+    // Indices into deals of the deals each item takes part in, by dense item index
+    std::vector<std::vector<std::uint32_t>> dealsByItem;
+
+    /**
+     * @brief Loads items from a JSON object.
+     * @param data JSON object containing item data.
+     * @throws InvalidItemException if item data is invalid.
+     */
+    void loadItems(const json& data);
+
+    /**
+     * @brief Loads deals from a JSON object.
+     * @param data JSON object containing deals data.
+     * @throws InvalidDealException if deal data is invalid.
+     */
+    void loadDeals(const json& data);
+
+    /**
+     * @brief Compiles one declarative deal rule and adds its deals.
+     * @param rule JSON object of the rule.
+     * @throws InvalidDealException if the rule is invalid.
+     */
+    void loadRule(const json& rule);
+
+    /**
+     * @brief Builds the item index after the items are loaded.
+     */
+    void buildItemIndex();
+
+    /**
+     * @brief Orders the deals by stage and builds the item-to-deal index after the deals are loaded.
+     */
+    void buildDealIndex();
+};
+
+#endif // CATALOG_H
@@ -0,0 +1,81 @@
+#ifndef CATALOG_STORE_H
+#define CATALOG_STORE_H
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include "Catalog.h"
+
+/**
+ * @class CatalogStore
+ * @brief Publishes the current catalog to checkout sessions and swaps it atomically on reload.
+ *
+ * Readers take a reference to the current catalog with current() when a basket starts and keep
+ * using that catalog until the basket is finished, so an in-flight basket is never affected by
+ * a reload. A reload builds the new catalog completely, off the scan path, and then publishes it
+ * with a single atomic pointer swap; the old catalog is freed when the last basket using it ends.
+ * All member functions are safe to call from any thread.
+ */
+class CatalogStore {
+public:
+    /**
+     * @brief Constructs a store publishing an empty catalog.
+     */
+    CatalogStore();
+
+    /**
+     * @brief Constructs a store publishing the given catalog.
+     * @param catalog The initial catalog; must not be null.
+     */
+    explicit CatalogStore(std::shared_ptr<const Catalog> catalog);
+
+    CatalogStore(const CatalogStore&) = delete;
+    CatalogStore& operator=(const CatalogStore&) = delete;
+
+    /**
+     * @brief Gets the catalog new baskets should use.
+     * @return The current catalog.
+     */
+    std::shared_ptr<const Catalog> current() const;
+
+    /**
+     * @brief Gets the number of catalogs published so far, including the initial one.
+     * @return The current catalog version, starting at 1.
+     */
+    std::uint64_t getVersion() const;
+
+    /**
+     * @brief Replaces the current catalog.
+     * @param catalog The new catalog; must not be null.
+     * @throws std::invalid_argument if catalog is null.
+     */
+    void publish(std::shared_ptr<const Catalog> catalog);
+
+    /**
+     * @brief Loads a catalog from a JSON file or binary catalog and publishes it.
+     *
+     * If loading fails, the current catalog stays in place.
+     *
+     * @param filename Path to the JSON file or binary catalog.
+     * @throws std::exception as thrown by Catalog::fromFile.
+     */
+    void reloadFromFile(const std::string& filename);
+
+    /**
+     * @brief Loads and publishes a catalog on a background thread.
+     * @param filename Path to the JSON file or binary catalog.
+     * @return A future that becomes ready once the catalog is published, or holds the loading error.
+     */
+    std::future<void> reloadFromFileAsync(const std::string& filename);
+
+private:
+    // Current catalog; only accessed through the std::atomic_load/std::atomic_store overloads
+    std::shared_ptr<const Catalog> catalog;
+
+    // Number of catalogs published so far
+    std::atomic<std::uint64_t> version;
+};
+
+#endif // CATALOG_STORE_H
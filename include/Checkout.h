@@ -6,12 +6,23 @@
 #include <map>
 #include <memory>
 #include <set>
-#include <regex>
+#include <string_view>
 #include <algorithm>
 #include <cctype>
+#include <iostream>
 #include "Item.h"
-#include "PurchasedItem.h"
+#include "PricedBasket.h"
 #include "Deal.h"
+#include "BasketArena.h"
+#include "BinaryCatalog.h"
+#include "Catalog.h"
+#include "CatalogStore.h"
+#include "ItemIndex.h"
+#include "DealSolver.h"
+#include "OutputSink.h"
+#include "Receipt.h"
+#include "ScanJournal.h"
+#include "ScanParser.h"
 #include "CustomExceptions.h"
 #include "json.hpp"
 
@@ -20,106 +31,313 @@ using json = nlohmann::json;
 /**
  * @class Checkout
  * @brief Manages the checkout process for a supermarket, including item scanning, deal application, and receipt generation.
+ *
+ * A Checkout is one lane's session: it holds only the cart and the basket being priced, and
+ * reads items and deals from a shared, immutable Catalog. Many sessions may share one catalog
+ * and run on different threads; a single session is not safe to use from several threads.
  */
 class Checkout {
 public:
     /**
-     * @brief Constructs a Checkout object.
+     * @struct Totals
+     * @brief Money totals of the priced basket.
+     */
+    struct Totals {
+        int lines = 0;          ///< Number of distinct items in the basket.
+        int units = 0;          ///< Number of units in the basket.
+        Money preDiscount;      ///< Total before discounts.
+        Money savings;          ///< Total discount from applied deals.
+        Money total;            ///< Total after discounts.
+        int deals = 0;          ///< Number of deal sets applied.
+    };
+
+    /**
+     * @brief Constructs a Checkout object with an empty catalog.
      */
     Checkout();
 
     /**
-     * @brief Loads items and deals from a JSON file.
-     * @param filename Path to the JSON file.
-     * @throws std::runtime_error if the file cannot be opened.
+     * @brief Constructs a Checkout session over a shared catalog.
+     * @param catalog The catalog to price baskets against; must not be null.
+     */
+    explicit Checkout(std::shared_ptr<const Catalog> catalog);
+
+    /**
+     * @brief Constructs a Checkout session that follows a catalog store.
+     *
+     * The session uses the store's current catalog and picks up a newer one each time
+     * newBasket is called; a basket in progress keeps the catalog it started with.
+     *
+     * @param store The catalog store; must not be null.
+     */
+    explicit Checkout(std::shared_ptr<const CatalogStore> store);
+
+    /**
+     * @brief Loads items and deals from a JSON file or a compiled binary catalog.
+     *
+     * Binary catalogs produced by `catalog-compile` are recognised by their magic bytes.
+     * Prints the error and exits if the catalog cannot be loaded.
+     *
+     * @param filename Path to the JSON file or binary catalog.
      */
     void loadItemsAndDeals(const std::string& filename);
 
     /**
      * @brief Loads items and deals from a JSON object.
+     *
+     * Loading replaces any previously loaded items and deals and empties the cart.
+     *
      * @param data JSON object containing items and deals data.
      */
     void loadItemsAndDeals(const json& data);
 
+    /**
+     * @brief Loads items and deals from a mapped binary catalog.
+     * @param catalog The binary catalog; the loaded catalog keeps it mapped.
+     */
+    void loadItemsAndDeals(std::shared_ptr<const BinaryCatalog> catalog);
+
+    /**
+     * @brief Switches the session to another catalog and empties the cart.
+     *
+     * The session stops following any catalog store it was constructed with.
+     *
+     * @param catalog The new catalog; must not be null.
+     */
+    void setCatalog(std::shared_ptr<const Catalog> catalog);
+
+    /**
+     * @brief Gets the catalog this session prices against.
+     * @return The shared catalog.
+     */
+    const std::shared_ptr<const Catalog>& getCatalog() const;
+
+    /**
+     * @brief Empties the cart to start the next basket.
+     *
+     * A session that follows a catalog store switches to the store's current catalog here.
+     */
+    void newBasket();
+
     /**
      * @brief Scans an item, updating the cart.
-     * @param input Item ID and quantity to be scanned.
-     * @throws std::invalid_argument if the input format is invalid or item ID is not found.
+     * @param input Item ID and quantity to be scanned, parsed by parseScanLine.
      */
-    void scanItem(const std::string& input);
+    void scanItem(std::string_view input);
 
     /**
-     * @brief Applies all available deals to the items in the cart.
+     * @brief Removes every unit of an item from the cart.
+     *
+     * Reports ScanEvent::ITEM_REMOVED, or ScanEvent::ITEM_NOT_FOUND for an unknown ID, to the sink.
+     *
+     * @param itemId ID of the item, matched as scanned IDs are.
+     */
+    void voidItem(std::string_view itemId);
+
+    /**
+     * @brief Finalizes deal application for the basket.
+     *
+     * Deals are applied greedily as each item is scanned, so with DealStrategy::GREEDY this does
+     * nothing: the basket is already priced exactly as a from-scratch pass would price it. With
+     * DealStrategy::OPTIMAL the solver assigns deals across the whole basket here.
      */
     void applyDeals();
 
     /**
-     * @brief Generates and prints the final receipt, including applied deals.
+     * @brief Generates the final receipt, including applied deals, and sends its text to the sink.
      */
     void generateReceipt() const;
 
+    /**
+     * @brief Builds the receipt of the basket as currently priced.
+     *
+     * The receipt's buffers are reused, so one Receipt can be filled basket after basket.
+     *
+     * @param receipt The receipt to fill; its number is left unchanged.
+     */
+    void buildReceipt(Receipt& receipt) const;
+
+    /**
+     * @brief Gets the receipt of the basket as currently priced.
+     * @return The receipt, numbered 0.
+     */
+    Receipt getReceipt() const;
+
+    /**
+     * @brief Gets the running totals of the basket.
+     *
+     * Totals are updated on every scan, in time proportional to the deals that can interact
+     * with the scanned item rather than to the size of the basket.
+     *
+     * @return The basket totals.
+     */
+    Totals getTotals() const;
+
     /**
      * @brief Gets the quantity of a specific item in the cart.
      * @param itemId ID of the item.
      * @return Quantity of the item in the cart.
      */
-    int getCartQuantity(const std::string& itemId) const;
+    int getCartQuantity(std::string_view itemId) const;
 
     /**
      * @brief Gets a list of applied deals.
-     * @return Vector of strings containing descriptions of applied deals.
+     *
+     * Descriptions are formatted on each call; use getDealApplications for the amounts.
+     *
+     * @return Vector of strings containing descriptions of applied deals, one per set.
      */
-    const std::vector<std::string>& getAppliedDeals() const;
+    std::vector<std::string> getAppliedDeals() const;
+
+    /**
+     * @brief Gets the deals applied to the basket.
+     * @return The deal applications, in application order.
+     */
+    const std::vector<DealApplication>& getDealApplications() const;
+
+    /**
+     * @brief Chooses how overlapping deals are assigned.
+     *
+     * The default is DealStrategy::GREEDY. With DealStrategy::OPTIMAL, running totals are still
+     * kept greedily; applyDeals then has a DealSolver search for the assignment with the largest
+     * savings, falling back to the best assignment found so far (never worse than greedy) when
+     * the time budget runs out. Changing the strategy reprices the basket greedily.
+     *
+     * @param strategy The deal strategy.
+     * @param timeBudget Maximum time the solver may spend per basket.
+     */
+    void setDealStrategy(DealStrategy strategy, std::chrono::microseconds timeBudget = std::chrono::microseconds(500));
+
+    /**
+     * @brief Sets where scan feedback, help and the receipt are sent.
+     *
+     * The default is an unbuffered TextSink over std::cout. Loading and deal errors still go to std::cerr.
+     *
+     * @param sink The sink, or nullptr to discard all output.
+     */
+    void setSink(std::shared_ptr<OutputSink> sink);
+
+    /**
+     * @brief Gets the sink scan feedback, help and the receipt are sent to.
+     * @return The sink.
+     */
+    const std::shared_ptr<OutputSink>& getSink() const;
+
+    /**
+     * @brief Records every change to the cart in a journal, so the cart can be rebuilt after a crash.
+     *
+     * Each scan or void records the item's new quantity, and starting the next basket records
+     * the basket as closed. Records are only buffered; the caller decides when to commit them.
+     *
+     * @param journal The journal, or nullptr to stop journaling.
+     * @param lane Lane the session's records are filed under.
+     */
+    void setJournal(std::shared_ptr<ScanJournal> journal, std::uint32_t lane);
+
+    /**
+     * @brief Puts a cart recovered from a journal back, replacing the quantities of its items.
+     *
+     * Nothing is sent to the sink. Items no longer in the catalog are skipped, and quantities
+     * are clamped to the range a scan allows.
+     *
+     * @param lines The recovered cart.
+     * @return Number of lines restored.
+     */
+    std::size_t restoreCart(const std::vector<ScanJournal::CartLine>& lines);
 
 private:
-    // Available items in the store, keyed by item ID
-    std::map<std::string, Item> availableItems;
+    /**
+     * @struct CartEntry
+     * @brief Quantity of one item in the cart.
+     */
+    struct CartEntry {
+        std::uint32_t itemIndex; ///< Dense index of the item in the catalog.
+        int quantity;            ///< Quantity in the cart.
+    };
+
+    // Shared, immutable items and deals used by the current basket
+    std::shared_ptr<const Catalog> catalog;
+
+    // Store new baskets take their catalog from, if the session follows one
+    std::shared_ptr<const CatalogStore> catalogStore;
+
+    // Scratch list of deals touched by the current cart, reused between calls to repriceBasket
+    std::vector<std::uint32_t> candidateDeals;
+
+    // Scratch list of the candidate deals handed to the solver
+    std::vector<const Deal*> solverDeals;
+
+    // Working memory of the deal solver, released when the basket is cleared
+    std::unique_ptr<BasketArena> arena = std::make_unique<BasketArena>();
+
+    // Scratch lists of the items and deals repriceItem has to revisit
+    std::vector<std::uint32_t> componentItems;
+    std::vector<std::uint32_t> componentDeals;
+
+    // Scratch lists of the applications repriceItem produces, and their deal indices
+    std::vector<DealApplication> newDeals;
+    std::vector<std::uint32_t> newDealIndices;
+
+    // Running totals of the basket
+    Totals totals;
+
+    // Where scan feedback, help and the receipt are sent
+    std::shared_ptr<OutputSink> sink;
+
+    // Journal cart changes are recorded in, if any, and the lane they are filed under
+    std::shared_ptr<ScanJournal> journal;
+    std::uint32_t journalLane = 0;
+
+    // How overlapping deals are assigned
+    DealStrategy dealStrategy = DealStrategy::GREEDY;
+
+    // Solver used by DealStrategy::OPTIMAL
+    DealSolver dealSolver;
 
-    // List of available deals
-    std::vector<std::shared_ptr<Deal>> deals;
+    // Priced lines (one per item with a positive quantity, sorted by item index) with deal-specific information
+    PricedBasket basket;
 
-    // List of purchased items with deal-specific information
-    std::vector<PurchasedItem> purchasedItems;
+    // Items that have been scanned into the cart, sorted by item index
+    std::vector<CartEntry> cart;
 
-    // Map to track quantities of each item in the cart
-    std::map<std::string, int> cart;
+    // Deals applied to the basket, in deal order
+    std::vector<DealApplication> appliedDeals;
 
-    // List of applied deals descriptions
-    std::vector<std::string> appliedDeals;
+    // Catalog deal index of each entry in appliedDeals
+    std::vector<std::uint32_t> appliedDealIndices;
 
     /**
-     * @brief Gets an item ID by its name.
-     * @param itemName The name of the item.
-     * @return The corresponding item ID, or an empty string if not found.
+     * @brief Empties the cart and discards any priced basket.
      */
-    std::string getItemIdByName(const std::string& itemName) const;
+    void clearCart();
 
     /**
-     * @brief Loads items from a JSON object.
-     * @param data JSON object containing item data.
-     * @throws std::runtime_error if item data is invalid.
+     * @brief Sets an item's quantity and re-applies the deals whose result can change.
+     * @param itemIndex Dense catalog index of the item.
+     * @param quantity The item's new cart quantity.
      */
-    void loadItems(const json& data);
+    void repriceItem(std::uint32_t itemIndex, int quantity);
 
     /**
-     * @brief Loads deals from a JSON object.
-     * @param data JSON object containing deals data.
-     * @throws std::runtime_error if deal data is invalid.
+     * @brief Restores deal order after repriceItem appends applications.
+     * @param middle Start of the appended applications.
      */
-    void loadDeals(const json& data);
+    void mergeDealRuns(std::size_t middle);
 
     /**
-     * @brief Prepares purchased items by iterating through the cart and converting to PurchasedItem instances.
+     * @brief Clears every line and applies all candidate deals again.
+     * @param optimal Whether to assign deals with the DealSolver rather than greedily.
      */
-    void preparePurchasedItems();
+    void repriceBasket(bool optimal);
 
     /**
      * @brief Processes the scanning of an item, adding or removing it from the cart.
      * @param itemIdInput The item ID.
      * @param quantity The quantity to add or remove.
-     * @throws std::invalid_argument if item ID is invalid.
+     *
+     * The outcome, including an unknown item ID, is reported to the sink.
      */
-    void processScannedItem(const std::string& itemIdInput, int quantity);
+    void processScannedItem(std::string_view itemIdInput, int quantity);
 
     /**
      * @brief Displays help information for the user, detailing the commands available.
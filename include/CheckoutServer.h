@@ -0,0 +1,297 @@
+#ifndef CHECKOUT_SERVER_H
+#define CHECKOUT_SERVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "CatalogStore.h"
+#include "ScanJournal.h"
+
+/**
+ * @class CheckoutServer
+ * @brief Daemon that hosts one checkout session per connected lane on a single epoll event loop.
+ *
+ * Lanes connect over a Unix domain socket or to a localhost TCP port. Each connection gets its
+ * own Checkout session over the shared CatalogStore, so a published catalog reload reaches each
+ * lane at its next basket. reloadCatalog() reloads the store from the catalog file on a background
+ * thread while the loop keeps serving lanes. Sockets are non-blocking and every request is
+ * answered as soon as it has been read; the loop never waits on a single lane.
+ *
+ * Requests and responses are frames: a 32-bit payload length in host byte order followed by the
+ * payload. A request payload is a Command byte followed by its argument:
+ *
+ * - SCAN: a scan line, as typed at the prompt (e.g. "A1 3").
+ * - VOID_ITEM: an item ID; every unit of the item is removed.
+ * - TOTAL: no argument.
+ * - RECEIPT: an optional ReceiptFormat byte (binary if omitted). Finalizes the basket, returns
+ *   its receipt and starts the next basket.
+ * - ATTACH: a 32-bit lane number. Names the lane, which must not be attached on another
+ *   connection, before anything is scanned; the lane gets back any cart it left in progress.
+ * - METRICS: no argument. Returns the process's Metrics snapshot as written by Metrics::writeJson.
+ *
+ * A response payload is a Status byte followed by the result. SCAN and VOID_ITEM return a
+ * TotalsRecord followed by one BinarySink::Record per scan message; TOTAL and ATTACH return a
+ * TotalsRecord; RECEIPT returns the receipt as written by ReceiptWriter. Frames longer than
+ * MAX_FRAME close the connection.
+ *
+ * A lane that sends faster than it reads its responses is held back: once MAX_PENDING_OUTPUT
+ * response bytes are waiting to be sent, the server stops reading from the lane until the
+ * backlog has been written, and a backlog past MAX_OUTPUT closes the connection.
+ *
+ * With a ScanJournal, attached lanes journal every cart change. Requests read in one pass of
+ * the event loop are committed together with a single flush before any of their responses is
+ * sent, so an answered scan survives a crash and restart of the daemon. If the commit fails
+ * (e.g. the disk is full), those responses carry Status::JOURNAL_ERROR instead of OK and the
+ * loop keeps serving; the changes stay pending and go out with the next successful commit. A
+ * lane that disconnects mid-basket gets its cart back when it attaches again.
+ *
+ * Only available on Linux; elsewhere the constructors throw.
+ */
+class CheckoutServer {
+public:
+    /// Largest payload accepted in a request frame.
+    static constexpr std::uint32_t MAX_FRAME = 64 * 1024;
+
+    /// Unsent response bytes at which a connection's requests stop being read.
+    static constexpr std::size_t MAX_PENDING_OUTPUT = 1024 * 1024;
+
+    /// Unsent response bytes past which a connection is closed.
+    static constexpr std::size_t MAX_OUTPUT = 16 * 1024 * 1024;
+
+    /**
+     * @enum Command
+     * @brief First byte of a request payload.
+     */
+    enum class Command : std::uint8_t {
+        SCAN = 1,      ///< Scan a line into the cart.
+        VOID_ITEM = 2, ///< Remove every unit of an item.
+        TOTAL = 3,     ///< Get the running totals.
+        RECEIPT = 4,   ///< Finalize the basket and get its receipt.
+        ATTACH = 5,    ///< Identify the lane and resume its cart.
+        METRICS = 6    ///< Get the latency histograms and counters as JSON.
+    };
+
+    /**
+     * @enum Status
+     * @brief First byte of a response payload.
+     */
+    enum class Status : std::uint8_t {
+        OK = 0,           ///< The command was carried out.
+        BAD_REQUEST = 1,  ///< Unknown command or malformed argument; nothing was changed.
+        JOURNAL_ERROR = 2 ///< The command was carried out, but the journal could not be committed, so it may not survive a restart.
+    };
+
+    /**
+     * @enum ReceiptFormat
+     * @brief Argument of Command::RECEIPT.
+     */
+    enum class ReceiptFormat : std::uint8_t {
+        TEXT = 0,       ///< ReceiptWriter::writeText.
+        JSON_LINES = 1, ///< ReceiptWriter::writeJsonLine.
+        CSV = 2,        ///< ReceiptWriter::writeCsv, without a header row.
+        BINARY = 3      ///< ReceiptWriter::writeBinary.
+    };
+
+    /**
+     * @struct TotalsRecord
+     * @brief Running totals of a lane's basket (40 bytes), amounts in cents.
+     */
+    struct TotalsRecord {
+        std::int32_t lines;       ///< Number of distinct items in the basket.
+        std::int32_t units;       ///< Number of units in the basket.
+        std::int64_t preDiscount; ///< Total before discounts.
+        std::int64_t savings;     ///< Total discount from applied deals.
+        std::int64_t total;       ///< Total after discounts.
+        std::int32_t deals;       ///< Number of deal sets applied.
+        std::int32_t reserved;    ///< Zero.
+    };
+
+    /**
+     * @brief Listens on a Unix domain socket, replacing any stale socket file at the path.
+     * @param store Catalogs the lane sessions price against; must not be null.
+     * @param socketPath Filesystem path of the socket; removed again on destruction.
+     * @throws std::runtime_error if the socket cannot be set up.
+     */
+    CheckoutServer(std::shared_ptr<CatalogStore> store, const std::string& socketPath);
+
+    /**
+     * @brief Listens on a TCP port of the loopback interface.
+     * @param store Catalogs the lane sessions price against; must not be null.
+     * @param port The port, or 0 to pick a free one (see getPort()).
+     * @throws std::runtime_error if the socket cannot be set up.
+     */
+    CheckoutServer(std::shared_ptr<CatalogStore> store, std::uint16_t port);
+
+    /**
+     * @brief Closes every connection and the listening socket.
+     */
+    ~CheckoutServer();
+
+    CheckoutServer(const CheckoutServer&) = delete;
+    CheckoutServer& operator=(const CheckoutServer&) = delete;
+
+    /**
+     * @brief Gets the TCP port the server listens on.
+     * @return The port, or 0 for a Unix domain socket.
+     */
+    std::uint16_t getPort() const;
+
+    /**
+     * @brief Journals the carts of attached lanes; carts recovered by the journal go back to their lanes.
+     *
+     * Must be called before run().
+     *
+     * @param journal The journal, or nullptr to stop journaling.
+     */
+    void setJournal(std::shared_ptr<ScanJournal> journal);
+
+    /**
+     * @brief Sets the file reloadCatalog() loads the catalog from.
+     *
+     * Must be called before run().
+     *
+     * @param path Path to the JSON file or binary catalog, or empty to ignore reload requests.
+     */
+    void setCatalogPath(const std::string& path);
+
+    /**
+     * @brief Makes run() reload the catalog from the catalog path and publish it to the store.
+     *
+     * The catalog is loaded on a background thread; lanes pick it up at their next basket. If
+     * loading fails, the current catalog stays in place and the error is written to stderr.
+     * Requests made while a reload is running are served by one more reload once it finishes.
+     * Safe to call from another thread or a signal handler.
+     */
+    void reloadCatalog();
+
+    /**
+     * @brief Serves lanes on the calling thread until stop() is called.
+     * @throws std::runtime_error if waiting for events fails.
+     */
+    void run();
+
+    /**
+     * @brief Makes run() return. Safe to call from another thread or a signal handler.
+     */
+    void stop();
+
+private:
+    struct Connection;
+
+    // Sessions get their catalog from here
+    std::shared_ptr<CatalogStore> store;
+
+    // File the catalog is reloaded from, empty to ignore reload requests
+    std::string catalogPath;
+
+    // Path of the Unix domain socket, empty for TCP
+    std::string socketPath;
+
+    // TCP port, or 0 for a Unix domain socket
+    std::uint16_t port = 0;
+
+    int listenFd = -1; ///< Listening socket.
+    int epollFd = -1;  ///< Event loop.
+    int stopFd = -1;   ///< eventfd written by stop().
+    int reloadFd = -1; ///< eventfd written by reloadCatalog().
+
+    // Catalog reload running in the background, if any
+    std::future<void> reloading;
+
+    // Whether another reload was requested while one was running
+    bool reloadQueued = false;
+
+    // Open lane connections by socket
+    std::unordered_map<int, std::unique_ptr<Connection>> connections;
+
+    // Journal of attached lanes' carts, if any
+    std::shared_ptr<ScanJournal> journal;
+
+    // Socket of each attached lane
+    std::unordered_map<std::uint32_t, int> lanes;
+
+    // Carts of lanes that disconnected mid-basket, kept until they attach again
+    std::unordered_map<std::uint32_t, std::vector<ScanJournal::CartLine>> parkedCarts;
+
+    // Connections whose responses wait for the journal to be committed
+    std::vector<int> awaitingCommit;
+
+    /**
+     * @brief Creates the event loop and starts watching the listening socket.
+     */
+    void startLoop();
+
+    /**
+     * @brief Starts a background catalog reload, or queues one if a reload is already running.
+     */
+    void startReload();
+
+    /**
+     * @brief Reports a finished background reload and starts the queued one, if any.
+     */
+    void finishReload();
+
+    /**
+     * @brief Accepts every pending connection.
+     */
+    void acceptConnections();
+
+    /**
+     * @brief Reads request bytes from a connection, no more than a frame ahead of what has been answered.
+     * @param connection The connection.
+     * @return False if the connection was closed.
+     */
+    bool readRequests(Connection& connection);
+
+    /**
+     * @brief Answers the complete requests read from a connection, in order, until its responses back up.
+     * @param connection The connection.
+     * @return False if the connection broke the protocol or its responses are past MAX_OUTPUT.
+     */
+    bool answerRequests(Connection& connection);
+
+    /**
+     * @brief Carries out one request and appends its response frame.
+     * @param connection The connection the request came from.
+     * @param payload The request payload.
+     * @param size Payload size in bytes.
+     */
+    void handleRequest(Connection& connection, const char* payload, std::size_t size);
+
+    /**
+     * @brief Attaches a connection to a lane and gives it back the lane's cart.
+     * @param connection The connection.
+     * @param lane The lane.
+     * @return False if the connection or the lane is already attached, or its basket is not empty.
+     */
+    bool attachLane(Connection& connection, std::uint32_t lane);
+
+    /**
+     * @brief Marks the responses waiting for a failed journal commit with Status::JOURNAL_ERROR.
+     * @param connection A connection whose responses waited for the commit.
+     */
+    void failUncommitted(Connection& connection);
+
+    /**
+     * @brief Writes as much pending output as the socket takes, then updates the events watched.
+     *
+     * The connection is read from while fewer than MAX_PENDING_OUTPUT bytes are left, and
+     * watched for writability while output is left or a request read earlier is still unanswered.
+     *
+     * @param connection The connection.
+     * @return False if the connection broke.
+     */
+    bool writeResponses(Connection& connection);
+
+    /**
+     * @brief Closes a connection and discards its session.
+     * @param fd The connection's socket.
+     */
+    void closeConnection(int fd);
+};
+
+#endif // CHECKOUT_SERVER_H
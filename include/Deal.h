@@ -1,16 +1,36 @@
 #ifndef DEAL_H
 #define DEAL_H
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <set>
-#include "PurchasedItem.h"
+#include "Item.h"
+#include "ItemBitset.h"
+#include "PricedBasket.h"
+
+class Deal;
+
+/**
+ * @struct DealApplication
+ * @brief Record of a deal applied to a basket: which deal, how often, and what it saved.
+ *
+ * Applications carry numeric amounts only; Deal::describe turns one into the text shown on the receipt.
+ */
+struct DealApplication {
+    const Deal* deal;        ///< The deal that was applied.
+    std::uint32_t itemIndex; ///< Dense catalog index of the item made free by each set.
+    int sets;                ///< Number of times the deal was applied.
+    Money discount;          ///< Discount of a single set.
+};
 
 /**
  * @class Deal
  * @brief Abstract base class representing a promotional deal.
  * 
  * This class provides a common interface for all types of deals that can be applied to purchased items.
+ * Deals are immutable once constructed and only modify the basket passed to them,
+ * so one deal can be applied from many checkout sessions concurrently.
  */
 class Deal {
 public:
@@ -20,12 +40,112 @@ public:
     virtual ~Deal() {}
 
     /**
-     * @brief Pure virtual function to apply a deal to the given items.
+     * @brief Applies the deal to the given items as many times as possible.
      * 
-     * @param items The list of purchased items to which the deal may be applied.
-     * @param appliedDeals The list to store descriptions of applied deals.
+     * @param basket The basket whose lines the deal may be applied to.
+     * @param appliedDeals The list the application, if any, is appended to.
+     */
+    void applyDeal(PricedBasket& basket, std::vector<DealApplication>& appliedDeals) const;
+
+    /**
+     * @brief Pure virtual function to apply a deal to the given items at most a given number of times.
+     * 
+     * @param basket The basket whose lines the deal may be applied to.
+     * @param appliedDeals The list the applications, if any, are appended to.
+     * @param maxSets The maximum number of sets to apply (per eligible item for Deal Type 1).
+     */
+    virtual void applyDeal(PricedBasket& basket, std::vector<DealApplication>& appliedDeals, int maxSets) const = 0;
+
+    /**
+     * @brief Describes one set of an application of this deal, as shown on the receipt.
+     *
+     * @param application An application of this deal.
+     * @param items The catalog items, indexed by dense item index.
+     * @return The description, e.g. "Deal Type 1 applied to 3 x Apple (-$1.00)".
+     */
+    std::string describe(const DealApplication& application, const std::vector<Item>& items) const;
+
+    /**
+     * @brief Appends the description of one set of an application of this deal to a buffer.
+     *
+     * Item names are appended straight from the catalog, so a reused buffer needs no allocation.
+     *
+     * @param application An application of this deal.
+     * @param items The catalog items, indexed by dense item index.
+     * @param output Buffer the description is appended to.
+     */
+    virtual void describe(const DealApplication& application, const std::vector<Item>& items,
+                          std::string& output) const = 0;
+
+    /**
+     * @brief Retrieves the type of the deal.
+     *
+     * @return The deal type.
+     */
+    virtual DealType getType() const = 0;
+
+    /**
+     * @brief Retrieves the name of the deal, as shown on the receipt.
+     *
+     * @return The name, e.g. "Deal Type 1" or the name of a catalog rule.
+     */
+    virtual std::string_view getName() const = 0;
+
+    /**
+     * @brief Retrieves the stage the deal is applied in.
+     *
+     * Deals are applied in ascending stage and in load order within a stage: deals on a single
+     * item's units (such as Deal Type 1) first, then sets of different items (such as Deal
+     * Type 2), then thresholds over whatever units are left.
+     *
+     * @return The stage.
+     */
+    virtual int getStage() const = 0;
+
+    /**
+     * @brief Retrieves the items that take part in the deal.
+     *
+     * @return Sorted, unique dense catalog indices of the eligible items.
      */
-    virtual void applyDeal(std::vector<PurchasedItem>& items, std::vector<std::string>& appliedDeals) = 0;
+    const std::vector<std::uint32_t>& getEligibleItemIndices() const;
+
+    /**
+     * @brief Retrieves the eligible items compiled into bitset words.
+     *
+     * @return The words of an ItemBitset the eligible items fall in, with their masks.
+     */
+    const std::vector<ItemBitset::Word>& getEligibleWords() const;
+
+    /**
+     * @brief Checks whether the deal only applies with every eligible item in the basket.
+     *
+     * @return True for sets of items, false for deals that apply to any eligible item present.
+     */
+    bool needsEveryItem() const;
+
+    /**
+     * @brief Checks, from item presence alone, whether the deal can apply to a basket.
+     *
+     * The eligible items are compiled into bitset words when the deal is built, so the
+     * check is one AND per word the items fall in and never searches the basket's lines.
+     *
+     * @param present The items in the basket.
+     * @return True if every eligible item is present, or any of them if the deal does not need every item.
+     */
+    bool canApply(const ItemBitset& present) const;
+
+protected:
+    /**
+     * @brief Initialises the eligible items of a deal.
+     *
+     * @param eligibleItemIndices Dense catalog indices of the eligible items, in any order.
+     * @param needsEveryItem Whether the deal only applies with every eligible item present.
+     */
+    Deal(const std::vector<std::uint32_t>& eligibleItemIndices, bool needsEveryItem);
+
+    std::vector<std::uint32_t> eligibleItemIndices; ///< Sorted, unique indices of eligible items.
+    std::vector<ItemBitset::Word> eligibleWords;    ///< Eligible items compiled into bitset words.
+    bool everyItem;                                 ///< Whether every eligible item must be present.
 };
 
 /**
@@ -37,22 +157,46 @@ public:
     /**
      * @brief Constructs a DealType1 object.
      * 
-     * @param eligibleItemIds The set of item IDs eligible for this deal.
+     * @param eligibleItemIndices Dense catalog indices of the items eligible for this deal.
      */
-    DealType1(const std::set<std::string>& eligibleItemIds);
+    DealType1(const std::vector<std::uint32_t>& eligibleItemIndices);
 
     /**
      * @brief Applies the deal to the given items.
      * 
-     * If three identical items are present, the customer only pays for two of them.
+     * For every three available units of an eligible item, the customer only pays for two of them.
      * 
-     * @param items The list of purchased items to which the deal may be applied.
-     * @param appliedDeals The list to store descriptions of applied deals.
+     * @param basket The basket whose lines the deal may be applied to.
+     * @param appliedDeals The list one application per discounted item is appended to.
+     * @param maxSets The maximum number of sets to apply to each eligible item.
      */
-    void applyDeal(std::vector<PurchasedItem>& items, std::vector<std::string>& appliedDeals) override;
+    void applyDeal(PricedBasket& basket, std::vector<DealApplication>& appliedDeals, int maxSets) const override;
+    using Deal::applyDeal;
 
-private:
-    std::set<std::string> eligibleItemIds; ///< Set of eligible item IDs for this deal.
+    void describe(const DealApplication& application, const std::vector<Item>& items,
+                  std::string& output) const override;
+    using Deal::describe;
+
+    /**
+     * @brief Retrieves the type of the deal.
+     *
+     * @return DealType::TYPE1.
+     */
+    DealType getType() const override;
+
+    /**
+     * @brief Retrieves the name of the deal.
+     *
+     * @return "Deal Type 1".
+     */
+    std::string_view getName() const override;
+
+    /**
+     * @brief Retrieves the stage the deal is applied in.
+     *
+     * @return 0, as the deal uses units of a single item.
+     */
+    int getStage() const override;
 };
 
 /**
@@ -64,22 +208,165 @@ public:
     /**
      * @brief Constructs a DealType2 object.
      * 
-     * @param eligibleItemIds The set of item IDs eligible for this deal.
+     * @param eligibleItemIndices Dense catalog indices of the items eligible for this deal.
      */
-    DealType2(const std::set<std::string>& eligibleItemIds);
+    DealType2(const std::vector<std::uint32_t>& eligibleItemIndices);
 
     /**
      * @brief Applies the deal to the given items.
      * 
-     * If three different eligible items are present, the cheapest item is provided for free.
+     * For every complete set of three different eligible items, the cheapest item is provided for free.
      * 
-     * @param items The list of purchased items to which the deal may be applied.
-     * @param appliedDeals The list to store descriptions of applied deals.
+     * @param basket The basket whose lines the deal may be applied to.
+     * @param appliedDeals The list the application, if any, is appended to.
+     * @param maxSets The maximum number of sets to apply.
      */
-    void applyDeal(std::vector<PurchasedItem>& items, std::vector<std::string>& appliedDeals) override;
+    void applyDeal(PricedBasket& basket, std::vector<DealApplication>& appliedDeals, int maxSets) const override;
+    using Deal::applyDeal;
+
+    void describe(const DealApplication& application, const std::vector<Item>& items,
+                  std::string& output) const override;
+    using Deal::describe;
+
+    /**
+     * @brief Retrieves the type of the deal.
+     *
+     * @return DealType::TYPE2.
+     */
+    DealType getType() const override;
+
+    /**
+     * @brief Retrieves the name of the deal.
+     *
+     * @return "Deal Type 2".
+     */
+    std::string_view getName() const override;
+
+    /**
+     * @brief Retrieves the stage the deal is applied in.
+     *
+     * @return 1, as the deal uses a set of different items.
+     */
+    int getStage() const override;
+};
+
+/**
+ * @struct DealRule
+ * @brief A promotion from the catalog's declarative rules, compiled into an opcode and integer operands.
+ *
+ * Rules are compiled once when the catalog is loaded; applying one is a single switch on its
+ * opcode followed by loops over integer columns of the basket, the same work DealType1 and
+ * DealType2 do. Percentages are whole numbers and each discount is rounded to the nearest cent.
+ */
+struct DealRule {
+    /**
+     * @enum Op
+     * @brief What a rule does with the units of its eligible items.
+     */
+    enum class Op : std::uint8_t {
+        MULTI_BUY,    ///< Per item: every groupUnits units, discountedUnits of them are percentOff off.
+        BUNDLE,       ///< One unit of every item per set: the discountedUnits cheapest are percentOff off.
+        TIERED_UNITS, ///< All units of the items are discounted by the highest tier their count reaches.
+        TIERED_SPEND  ///< All units of the items are discounted by the highest tier their price reaches.
+    };
+
+    /**
+     * @struct Tier
+     * @brief One step of a tiered rule.
+     */
+    struct Tier {
+        std::int64_t threshold; ///< Units, or cents of spend, needed to reach the tier.
+        int percentOff;         ///< Discount on every unit once the tier is reached.
+    };
+
+    Op op = Op::MULTI_BUY;   ///< What the rule does.
+    int groupUnits = 0;      ///< Units of one item per set (MULTI_BUY).
+    int discountedUnits = 0; ///< Units per set that are discounted (MULTI_BUY and BUNDLE).
+    int percentOff = 100;    ///< Discount on each discounted unit (MULTI_BUY and BUNDLE).
+    std::vector<Tier> tiers; ///< Tiers in ascending threshold order (TIERED_UNITS and TIERED_SPEND).
+    std::string name;        ///< Name shown on the receipt.
+
+    /**
+     * @brief Builds the rule of Deal Type 1: buy 3 identical items, pay for 2.
+     * @return A MULTI_BUY rule.
+     */
+    static DealRule dealType1();
+
+    /**
+     * @brief Builds the rule of Deal Type 2: buy a set of different items, the cheapest is free.
+     * @return A BUNDLE rule.
+     */
+    static DealRule dealType2();
+};
+
+/**
+ * @class RuleDeal
+ * @brief A deal that applies a compiled DealRule to its eligible items.
+ *
+ * Deal Type 1 and Deal Type 2 are rules too: a rule with their shape and their default name
+ * reports their type and prints the same receipt lines as DealType1 and DealType2. A rule of
+ * that shape under another name reports DealType::RULE.
+ * MULTI_BUY rules should be given a single eligible item, like Deal Type 1 deals.
+ */
+class RuleDeal : public Deal {
+public:
+    /**
+     * @brief Constructs a RuleDeal object.
+     *
+     * @param eligibleItemIndices Dense catalog indices of the items the rule applies to.
+     * @param rule The compiled rule.
+     */
+    RuleDeal(const std::vector<std::uint32_t>& eligibleItemIndices, DealRule rule);
+
+    /**
+     * @brief Applies the rule to the given items.
+     *
+     * @param basket The basket whose lines the rule may be applied to.
+     * @param appliedDeals The list the applications, if any, are appended to.
+     * @param maxSets The maximum number of sets to apply (per eligible item for MULTI_BUY; tiered rules apply once).
+     */
+    void applyDeal(PricedBasket& basket, std::vector<DealApplication>& appliedDeals, int maxSets) const override;
+    using Deal::applyDeal;
+
+    void describe(const DealApplication& application, const std::vector<Item>& items,
+                  std::string& output) const override;
+    using Deal::describe;
+
+    /**
+     * @brief Retrieves the type of the deal.
+     *
+     * @return DealType::TYPE1 or DealType::TYPE2 for rules of their shape and name, DealType::RULE otherwise.
+     */
+    DealType getType() const override;
+
+    /**
+     * @brief Retrieves the name of the rule.
+     *
+     * @return The rule's name.
+     */
+    std::string_view getName() const override;
+
+    /**
+     * @brief Retrieves the stage the deal is applied in.
+     *
+     * @return 0 for MULTI_BUY, 1 for BUNDLE and 2 for tiered rules.
+     */
+    int getStage() const override;
+
+    /**
+     * @brief Retrieves the compiled rule.
+     *
+     * @return The rule.
+     */
+    const DealRule& getRule() const;
 
 private:
-    std::set<std::string> eligibleItemIds; ///< Set of eligible item IDs for this deal.
+    void applyMultiBuy(PricedBasket& basket, std::vector<DealApplication>& appliedDeals, int maxSets) const;
+    void applyBundle(PricedBasket& basket, std::vector<DealApplication>& appliedDeals, int maxSets) const;
+    void applyTiered(PricedBasket& basket, std::vector<DealApplication>& appliedDeals) const;
+
+    DealRule rule; ///< The compiled rule.
+    DealType type; ///< Type reported for the rule's shape.
 };
 
 #endif // DEAL_H
@@ -0,0 +1,83 @@
+#ifndef DEAL_SOLVER_H
+#define DEAL_SOLVER_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+#include "Deal.h"
+#include "Money.h"
+#include "PricedBasket.h"
+
+/**
+ * @enum DealStrategy
+ * @brief How overlapping deals are assigned to the items in the cart.
+ */
+enum class DealStrategy {
+    GREEDY, ///< Apply every Deal Type 1 deal as often as possible, then Deal Type 2 deals in catalog order.
+    OPTIMAL ///< Search for the assignment with the largest total savings, within a time budget; baskets with other rules are priced greedily.
+};
+
+/**
+ * @class DealSolver
+ * @brief Finds how many times to apply each deal so that total savings are maximised.
+ *
+ * Each Deal Type 2 deal uses one unit of each of its items per set and saves the price of
+ * the cheapest; each Deal Type 1 deal uses three units of its item per set and saves one
+ * unit's price. The solver runs a depth-first branch-and-bound over the Deal Type 2 set
+ * counts; once those are fixed, the best Deal Type 1 counts follow directly from the units
+ * left over. The greedy assignment is the starting incumbent and is only replaced by a
+ * strictly better one, so the result never saves less than greedy and ties keep the
+ * familiar greedy receipt. If the time budget runs out, the best assignment found so far
+ * is returned.
+ */
+class DealSolver {
+public:
+    /**
+     * @struct Result
+     * @brief Assignment found by the solver.
+     */
+    struct Result {
+        /**
+         * @brief Constructs an empty result.
+         * @param resource Memory resource the set counts are allocated from.
+         */
+        explicit Result(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+        std::pmr::vector<int> sets; ///< Number of sets to apply for each deal, in the order given to solve().
+        Money savings;         ///< Total savings of the assignment.
+        Money greedySavings;   ///< Total savings of the greedy assignment, for comparison.
+        bool optimal = true;   ///< False if the search stopped at the time budget.
+        std::uint64_t nodes = 0; ///< Number of search nodes visited.
+    };
+
+    /**
+     * @brief Constructs a DealSolver.
+     * @param timeBudget Maximum time to spend searching for one basket.
+     */
+    explicit DealSolver(std::chrono::microseconds timeBudget = std::chrono::microseconds(500));
+
+    /**
+     * @brief Solves the deal assignment for a basket.
+     * @param basket The basket, with no deals applied yet.
+     * @param deals The deals to consider, Deal Type 1 deals first. Deal Type 1 deals must have a single eligible item;
+     *              several of them may share an item, in which case only one of them is given sets. Other rules
+     *              (DealType::RULE) are not supported.
+     * @param arena Memory resource the search state and the result are allocated from, e.g. a BasketArena.
+     * @return The number of sets to apply for each deal.
+     * @throws std::invalid_argument if a Deal Type 1 deal has more than one eligible item or a deal is another rule.
+     */
+    Result solve(const PricedBasket& basket, const std::vector<const Deal*>& deals,
+                 std::pmr::memory_resource* arena = std::pmr::get_default_resource()) const;
+
+    /**
+     * @brief Gets the time budget.
+     * @return The maximum time spent searching for one basket.
+     */
+    std::chrono::microseconds getTimeBudget() const;
+
+private:
+    std::chrono::microseconds timeBudget; ///< Maximum time to spend searching for one basket.
+};
+
+#endif // DEAL_SOLVER_H
@@ -1,11 +1,17 @@
 #ifndef ITEM_H
 #define ITEM_H
 
+#include <memory>
 #include <string>
+#include <string_view>
+#include "Money.h"
 
 /**
  * @class Item
  * @brief Represents a store item with an ID, name, and price.
+ *
+ * An item either owns a copy of its ID and name or refers to characters owned by its catalog,
+ * such as a shared string table or a mapped binary catalog; catalog items cost no allocation.
  */
 class Item {
 public:
@@ -16,33 +22,55 @@ public:
      * @param name Name of the item.
      * @param price Price of the item.
      */
+    Item(const std::string& id, const std::string& name, Money price);
+
+    /**
+     * @brief Constructs an Item object from a price in currency units.
+     * 
+     * @param id Unique identifier for the item.
+     * @param name Name of the item.
+     * @param price Price of the item, rounded to the nearest cent.
+     */
     Item(const std::string& id, const std::string& name, double price);
 
+    /**
+     * @brief Constructs an Item that refers to an ID and name it does not own.
+     *
+     * @param id Unique identifier for the item; its characters must outlive the item and its copies.
+     * @param name Name of the item; its characters must outlive the item and its copies.
+     * @param price Price of the item.
+     * @return The item.
+     */
+    static Item view(std::string_view id, std::string_view name, Money price);
+
     /**
      * @brief Retrieves the ID of the item.
      * 
      * @return The ID of the item.
      */
-    std::string getId() const;
+    std::string_view getId() const;
 
     /**
      * @brief Retrieves the name of the item.
      * 
      * @return The name of the item.
      */
-    std::string getName() const;
+    std::string_view getName() const;
 
     /**
      * @brief Retrieves the price of the item.
      * 
      * @return The price of the item.
      */
-    double getPrice() const;
+    Money getPrice() const;
 
 private:
-    std::string id;   ///< Unique identifier for the item.
-    std::string name; ///< Name of the item.
-    double price;     ///< Price of the item.
+    Item(std::string_view id, std::string_view name, Money price, std::shared_ptr<const std::string> storage);
+
+    std::shared_ptr<const std::string> storage; ///< ID and name characters, if the item owns them.
+    std::string_view id;                        ///< Unique identifier for the item.
+    std::string_view name;                      ///< Name of the item.
+    Money price;                                ///< Price of the item.
 };
 
 #endif // ITEM_H
@@ -0,0 +1,79 @@
+#ifndef ITEM_BITSET_H
+#define ITEM_BITSET_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class ItemBitset
+ * @brief Set of dense item indices stored as one bit per catalog item.
+ *
+ * A group of items, such as the items of a deal, is compiled once into Words: the 64-bit
+ * words its bits fall in, each with the mask of its bits there. Checking whether a set holds
+ * all or any of the group is then one AND per word, typically a single word for a deal.
+ * The set grows as higher indices are added, so it needs no catalog size up front.
+ */
+class ItemBitset {
+public:
+    /**
+     * @struct Word
+     * @brief The bits of a group of items that fall in one 64-bit word of the set.
+     */
+    struct Word {
+        std::uint32_t index; ///< Position of the word in the set.
+        std::uint64_t mask;  ///< Bits of the group's items within the word.
+    };
+
+    /**
+     * @brief Compiles a group of items into the words their bits fall in.
+     * @param itemIndices Dense catalog indices of the items, in any order.
+     * @return One Word per distinct word touched, in word order.
+     */
+    static std::vector<Word> compile(const std::vector<std::uint32_t>& itemIndices);
+
+    /**
+     * @brief Adds an item to the set.
+     * @param itemIndex Dense catalog index of the item.
+     */
+    void set(std::uint32_t itemIndex);
+
+    /**
+     * @brief Removes an item from the set.
+     * @param itemIndex Dense catalog index of the item.
+     */
+    void reset(std::uint32_t itemIndex);
+
+    /**
+     * @brief Checks whether an item is in the set.
+     * @param itemIndex Dense catalog index of the item.
+     * @return True if the item is in the set.
+     */
+    bool test(std::uint32_t itemIndex) const;
+
+    /**
+     * @brief Checks whether the set holds every item of a compiled group.
+     * @param group The group, as returned by compile().
+     * @return True if all of the group's items are in the set; true for an empty group.
+     */
+    bool containsAll(const std::vector<Word>& group) const;
+
+    /**
+     * @brief Checks whether the set holds every item of a compiled group, counting one more item as present.
+     * @param group The group, as returned by compile().
+     * @param assumed Dense catalog index of an item treated as in the set.
+     * @return True if all of the group's items other than assumed are in the set.
+     */
+    bool containsAll(const std::vector<Word>& group, std::uint32_t assumed) const;
+
+    /**
+     * @brief Checks whether the set holds at least one item of a compiled group.
+     * @param group The group, as returned by compile().
+     * @return True if any of the group's items is in the set.
+     */
+    bool containsAny(const std::vector<Word>& group) const;
+
+private:
+    std::vector<std::uint64_t> words; ///< Bit i % 64 of word i / 64 is set for each item i in the set.
+};
+
+#endif // ITEM_BITSET_H
@@ -0,0 +1,52 @@
+#ifndef ITEM_INDEX_H
+#define ITEM_INDEX_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class ItemIndex
+ * @brief Open-addressing hash index from packed item IDs to dense item indices.
+ *
+ * Item IDs of up to eight bytes are packed into a 64-bit key, first character in the
+ * most significant byte, so that comparing keys orders IDs the same way as comparing
+ * the strings. The index is built once when the catalog is loaded and maps each key to
+ * the item's position in the catalog, which is then used by the cart and the deals.
+ */
+class ItemIndex {
+public:
+    /// Value returned when a key is not in the index.
+    static constexpr std::uint32_t NOT_FOUND = 0xFFFFFFFFu;
+
+    /// Maximum length of an ID that can be packed into a key.
+    static constexpr std::size_t MAX_KEY_LENGTH = 8;
+
+    /**
+     * @brief Packs an item ID into a 64-bit key.
+     * @param id The item ID.
+     * @param toUpper Whether to upper-case ASCII letters while packing.
+     * @return The packed key, or 0 if the ID is empty or longer than MAX_KEY_LENGTH.
+     */
+    static std::uint64_t pack(std::string_view id, bool toUpper = false);
+
+    /**
+     * @brief Builds the index so that keys[i] maps to i.
+     * @param keys Packed keys of the items, in dense index order. Keys equal to 0 are skipped.
+     */
+    void build(const std::vector<std::uint64_t>& keys);
+
+    /**
+     * @brief Looks up a packed key.
+     * @param key The packed key.
+     * @return The dense item index, or NOT_FOUND.
+     */
+    std::uint32_t find(std::uint64_t key) const;
+
+private:
+    std::vector<std::uint64_t> slotKeys;    ///< Key stored in each slot; 0 marks an empty slot.
+    std::vector<std::uint32_t> slotIndices; ///< Dense index stored in each slot.
+    std::uint64_t mask = 0;                 ///< Table size minus one (table size is a power of two).
+};
+
+#endif // ITEM_INDEX_H
@@ -0,0 +1,92 @@
+#ifndef LOAD_GENERATOR_H
+#define LOAD_GENERATOR_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include "Catalog.h"
+#include "json.hpp"
+
+using json = nlohmann::json;
+
+/**
+ * @enum PriceDistribution
+ * @brief How generated item prices are spread between the minimum and maximum price.
+ */
+enum class PriceDistribution {
+    UNIFORM,  ///< Every price in the range is equally likely.
+    LOG_NORMAL ///< Most prices cluster around the geometric mean of the range, with a long tail.
+};
+
+/**
+ * @class LoadGenerator
+ * @brief Generates synthetic catalogs and basket streams for benchmarks and soak tests.
+ *
+ * Output is fully determined by the options, including the seed, and is the same on every
+ * platform: the generator uses std::mt19937_64 directly rather than the standard library
+ * distributions, whose results are implementation-defined.
+ */
+class LoadGenerator {
+public:
+    /**
+     * @struct CatalogOptions
+     * @brief Shape of a generated catalog.
+     */
+    struct CatalogOptions {
+        std::uint32_t items = 1000;          ///< Number of items.
+        double priceMin = 0.25;              ///< Lowest price.
+        double priceMax = 25.00;             ///< Highest price.
+        PriceDistribution priceDistribution = PriceDistribution::UNIFORM; ///< Price spread.
+        double dealType1Coverage = 0.10;     ///< Fraction of items eligible for Deal Type 1.
+        double dealType2Density = 0.05;      ///< Number of Deal Type 2 sets per item.
+        double dealType2Pool = 1.00;         ///< Fraction of items Deal Type 2 sets are drawn from; smaller pools overlap more.
+        std::uint64_t seed = 1;              ///< Random seed.
+    };
+
+    /**
+     * @struct BasketOptions
+     * @brief Shape of a generated basket stream.
+     */
+    struct BasketOptions {
+        std::uint64_t baskets = 1000;  ///< Number of baskets.
+        double zipfExponent = 1.0;     ///< Skew of item popularity; 0 makes every item equally popular.
+        double meanLines = 8.0;        ///< Average number of scan lines per basket, before removals.
+        int maxQuantity = 5;           ///< Largest quantity on one scan line.
+        double removalRate = 0.05;     ///< Probability that a scan line is followed by a removal.
+        std::uint64_t seed = 1;        ///< Random seed.
+    };
+
+    /// Largest catalog whose IDs fit the five characters the scanner accepts.
+    static constexpr std::uint32_t MAX_ITEMS = 26u * 36u * 36u * 36u * 36u;
+
+    /**
+     * @brief Builds the ID of the n-th generated item: a letter followed by base-36 digits.
+     * @param n Item number, less than MAX_ITEMS.
+     * @return The item ID, at most five characters long.
+     */
+    static std::string itemId(std::uint32_t n);
+
+    /**
+     * @brief Generates a catalog in the JSON schema read by Catalog::fromJson.
+     * @param options Shape of the catalog.
+     * @return The catalog data.
+     * @throws std::invalid_argument if the options are out of range.
+     */
+    static json generateCatalog(const CatalogOptions& options);
+
+    /**
+     * @brief Writes a basket stream in the format read by ReplayDriver.
+     *
+     * Each basket is a list of scan lines followed by a blank line. Item popularity follows a
+     * Zipf distribution over a seeded random ranking of the catalog's items, and removals are
+     * written as negative quantities of an item already scanned in the same basket.
+     *
+     * @param catalog The catalog to draw items from.
+     * @param options Shape of the stream.
+     * @param output Where the baskets are written.
+     * @throws std::invalid_argument if the catalog is empty or the options are out of range.
+     */
+    static void generateBaskets(const Catalog& catalog, const BasketOptions& options, std::ostream& output);
+};
+
+#endif // LOAD_GENERATOR_H
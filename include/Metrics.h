@@ -0,0 +1,265 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @enum MetricsPhase
+ * @brief Timed phases of checkout work.
+ */
+enum class MetricsPhase : std::uint8_t {
+    SCAN_ITEM,            ///< Checkout::scanItem, end to end.
+    PARSE,                ///< Parsing the scanned line.
+    LOOKUP,               ///< Finding the scanned item in the catalog.
+    PROCESS_SCANNED_ITEM, ///< Updating the cart and repricing the basket.
+    DEAL_TYPE1,           ///< Applying one Deal Type 1 deal.
+    DEAL_TYPE2,           ///< Applying one Deal Type 2 deal.
+    DEAL_RULE,            ///< Applying one deal of any other rule.
+    APPLY_DEALS,          ///< Checkout::applyDeals.
+    BUILD_RECEIPT,        ///< Checkout::buildReceipt.
+    GENERATE_RECEIPT,     ///< Checkout::generateReceipt, including formatting the text.
+    COUNT                 ///< Number of phases.
+};
+
+/**
+ * @enum MetricsCounter
+ * @brief Counted checkout events.
+ */
+enum class MetricsCounter : std::uint8_t {
+    SCANS,           ///< Lines scanned.
+    PARSE_ERRORS,    ///< Lines rejected by the parser.
+    ITEMS_NOT_FOUND, ///< Scans of IDs missing from the catalog.
+    QUANTITY_CLAMPS, ///< Scans capped at the quantity limit.
+    RECEIPTS,        ///< Receipts built.
+    COUNT            ///< Number of counters.
+};
+
+/**
+ * @class LatencyHistogram
+ * @brief Log-linear latency histogram in nanoseconds, in the style of HdrHistogram.
+ *
+ * Values below 32 ns get a bucket each; above that, every power of two is split into 32
+ * buckets, so a recorded value is off by at most 1/32 (about 3%). Values of 2^36 ns (about
+ * 69 s) and more land in the last bucket.
+ *
+ * A histogram has a single writer: record() uses relaxed loads and stores rather than atomic
+ * read-modify-write instructions. Other threads may read it at any time and see a slightly
+ * stale, but never torn, count in each bucket.
+ */
+class LatencyHistogram {
+public:
+    /// Buckets per power of two.
+    static constexpr std::uint32_t SUB_BUCKETS = 32;
+
+    /// Total number of buckets.
+    static constexpr std::uint32_t BUCKETS = 1024;
+
+    /**
+     * @brief Records one value. Only the owning thread may call this.
+     * @param nanos The value in nanoseconds.
+     */
+    void record(std::uint64_t nanos) {
+        std::atomic<std::uint64_t>& bucket = buckets[bucketOf(nanos)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        total.store(total.load(std::memory_order_relaxed) + nanos, std::memory_order_relaxed);
+        if (nanos > maximum.load(std::memory_order_relaxed)) {
+            maximum.store(nanos, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Gets the bucket a value is counted in.
+     * @param nanos The value in nanoseconds.
+     * @return The bucket index.
+     */
+    static std::uint32_t bucketOf(std::uint64_t nanos);
+
+    /**
+     * @brief Gets the smallest value counted in a bucket.
+     * @param bucket The bucket index.
+     * @return The value in nanoseconds.
+     */
+    static std::uint64_t lowestValueOf(std::uint32_t bucket);
+
+    /**
+     * @brief Gets the largest value counted in a bucket.
+     * @param bucket The bucket index.
+     * @return The value in nanoseconds.
+     */
+    static std::uint64_t highestValueOf(std::uint32_t bucket);
+
+    /**
+     * @brief Gets how many values were counted in a bucket.
+     * @param bucket The bucket index.
+     * @return The count.
+     */
+    std::uint64_t getCount(std::uint32_t bucket) const;
+
+    /**
+     * @brief Gets the sum of all recorded values.
+     * @return The sum in nanoseconds.
+     */
+    std::uint64_t getTotal() const;
+
+    /**
+     * @brief Gets the largest recorded value.
+     * @return The value in nanoseconds, or 0 if nothing was recorded.
+     */
+    std::uint64_t getMaximum() const;
+
+    /**
+     * @brief Zeroes every bucket. Values recorded concurrently may be lost.
+     */
+    void reset();
+
+private:
+    std::array<std::atomic<std::uint64_t>, BUCKETS> buckets{};
+    std::atomic<std::uint64_t> total{0};
+    std::atomic<std::uint64_t> maximum{0};
+};
+
+/**
+ * @class Metrics
+ * @brief Process-wide latency histograms per phase and event counters, kept per thread.
+ *
+ * Every thread that records gets its own shard of histograms and counters, so recording takes
+ * no locks and never contends; snapshot() merges the shards of all threads, including threads
+ * that have exited.
+ *
+ * Checkout records through the SUPERMARKET_METRICS_TIME and SUPERMARKET_METRICS_COUNT macros,
+ * which compile to nothing unless SUPERMARKET_ENABLE_METRICS is defined (CMake option of the
+ * same name). Without it, snapshots are empty and the reports say metrics are disabled.
+ */
+class Metrics {
+public:
+    /// Whether this build records metrics.
+#ifdef SUPERMARKET_ENABLE_METRICS
+    static constexpr bool ENABLED = true;
+#else
+    static constexpr bool ENABLED = false;
+#endif
+
+    /**
+     * @struct PhaseSnapshot
+     * @brief Merged latency statistics of one phase, in nanoseconds.
+     */
+    struct PhaseSnapshot {
+        std::uint64_t count = 0; ///< Number of timed calls.
+        std::uint64_t total = 0; ///< Time spent in all calls.
+        std::uint64_t p50 = 0;   ///< Median.
+        std::uint64_t p90 = 0;   ///< 90th percentile.
+        std::uint64_t p99 = 0;   ///< 99th percentile.
+        std::uint64_t p999 = 0;  ///< 99.9th percentile.
+        std::uint64_t max = 0;   ///< Slowest call.
+    };
+
+    /**
+     * @struct Snapshot
+     * @brief Metrics of all threads at one point in time.
+     */
+    struct Snapshot {
+        bool enabled = ENABLED;                                                              ///< Whether metrics were recorded.
+        std::array<PhaseSnapshot, static_cast<std::size_t>(MetricsPhase::COUNT)> phases{};   ///< By MetricsPhase.
+        std::array<std::uint64_t, static_cast<std::size_t>(MetricsCounter::COUNT)> counters{}; ///< By MetricsCounter.
+    };
+
+    /**
+     * @class ScopedTimer
+     * @brief Records the time from construction to destruction in a phase's histogram.
+     */
+    class ScopedTimer {
+    public:
+        /**
+         * @brief Starts timing.
+         * @param phase The phase.
+         */
+        explicit ScopedTimer(MetricsPhase phase) : phase(phase), start(std::chrono::steady_clock::now()) {}
+
+        ~ScopedTimer() {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            Metrics::record(phase, static_cast<std::uint64_t>(
+                                       std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        MetricsPhase phase;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    /**
+     * @brief Records the duration of one call in the calling thread's shard.
+     * @param phase The phase.
+     * @param nanos The duration in nanoseconds.
+     */
+    static void record(MetricsPhase phase, std::uint64_t nanos);
+
+    /**
+     * @brief Adds to a counter in the calling thread's shard.
+     * @param counter The counter.
+     * @param amount The amount to add.
+     */
+    static void increment(MetricsCounter counter, std::uint64_t amount = 1);
+
+    /**
+     * @brief Merges the shards of all threads.
+     * @return The snapshot.
+     */
+    static Snapshot snapshot();
+
+    /**
+     * @brief Zeroes every shard. Values recorded concurrently may be lost.
+     */
+    static void reset();
+
+    /**
+     * @brief Gets the name of a phase as used in reports.
+     * @param phase The phase.
+     * @return The name, e.g. "scan_item".
+     */
+    static const char* nameOf(MetricsPhase phase);
+
+    /**
+     * @brief Gets the name of a counter as used in reports.
+     * @param counter The counter.
+     * @return The name, e.g. "scans".
+     */
+    static const char* nameOf(MetricsCounter counter);
+
+    /**
+     * @brief Writes a snapshot as an aligned text table, latencies in microseconds.
+     * @param snapshot The snapshot.
+     * @param output Buffer the text is appended to.
+     */
+    static void writeText(const Snapshot& snapshot, std::string& output);
+
+    /**
+     * @brief Writes a snapshot as one JSON object on a single line, latencies in nanoseconds.
+     * @param snapshot The snapshot.
+     * @param output Buffer the JSON is appended to.
+     */
+    static void writeJson(const Snapshot& snapshot, std::string& output);
+};
+
+#define SUPERMARKET_METRICS_CONCAT_(a, b) a##b
+#define SUPERMARKET_METRICS_CONCAT(a, b) SUPERMARKET_METRICS_CONCAT_(a, b)
+
+#ifdef SUPERMARKET_ENABLE_METRICS
+/// Times the rest of the enclosing scope as the given MetricsPhase.
+#define SUPERMARKET_METRICS_TIME(phase) \
+    Metrics::ScopedTimer SUPERMARKET_METRICS_CONCAT(metricsTimer, __LINE__)(phase)
+/// Adds one to the given MetricsCounter.
+#define SUPERMARKET_METRICS_COUNT(counter) Metrics::increment(counter)
+#else
+#define SUPERMARKET_METRICS_TIME(phase) static_cast<void>(0)
+#define SUPERMARKET_METRICS_COUNT(counter) static_cast<void>(0)
+#endif
+
+#endif // METRICS_H
@@ -0,0 +1,90 @@
+#ifndef MONEY_H
+#define MONEY_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/**
+ * @class Money
+ * @brief Fixed-point monetary amount stored as a whole number of cents.
+ *
+ * All prices, discounts and totals are kept in integer cents so that sums are exact
+ * regardless of basket size. Conversion from floating point happens once, when the
+ * catalog is loaded, and rounds to the nearest cent with halves rounded away from zero.
+ */
+class Money {
+public:
+    /**
+     * @brief Constructs a zero amount.
+     */
+    constexpr Money() : cents(0) {}
+
+    /**
+     * @brief Creates an amount from a number of cents.
+     *
+     * @param cents The amount in cents.
+     * @return The corresponding Money value.
+     */
+    static constexpr Money fromCents(std::int64_t cents) { return Money(cents); }
+
+    /**
+     * @brief Creates an amount from a floating-point value in currency units.
+     *
+     * The value is rounded to the nearest cent, with halves rounded away from zero.
+     *
+     * @param amount The amount in currency units (e.g. 1.25 for $1.25).
+     * @return The corresponding Money value.
+     * @throws std::out_of_range if the amount is not finite or cannot be represented.
+     */
+    static Money fromDouble(double amount);
+
+    /**
+     * @brief Retrieves the amount in cents.
+     *
+     * @return The amount in cents.
+     */
+    constexpr std::int64_t getCents() const { return cents; }
+
+    /**
+     * @brief Converts the amount to a floating-point value in currency units.
+     *
+     * @return The amount in currency units.
+     */
+    double toDouble() const;
+
+    /**
+     * @brief Formats the amount with exactly two decimal places (e.g. "12.05", "-0.50").
+     *
+     * @return The formatted amount, without a currency symbol.
+     */
+    std::string toString() const;
+
+    constexpr Money& operator+=(Money other) { cents += other.cents; return *this; }
+    constexpr Money& operator-=(Money other) { cents -= other.cents; return *this; }
+
+    friend constexpr Money operator+(Money a, Money b) { return Money(a.cents + b.cents); }
+    friend constexpr Money operator-(Money a, Money b) { return Money(a.cents - b.cents); }
+    friend constexpr Money operator-(Money a) { return Money(-a.cents); }
+    friend constexpr Money operator*(Money a, std::int64_t quantity) { return Money(a.cents * quantity); }
+    friend constexpr Money operator*(std::int64_t quantity, Money a) { return Money(a.cents * quantity); }
+
+    friend constexpr bool operator==(Money a, Money b) { return a.cents == b.cents; }
+    friend constexpr bool operator!=(Money a, Money b) { return a.cents != b.cents; }
+    friend constexpr bool operator<(Money a, Money b) { return a.cents < b.cents; }
+    friend constexpr bool operator>(Money a, Money b) { return a.cents > b.cents; }
+    friend constexpr bool operator<=(Money a, Money b) { return a.cents <= b.cents; }
+    friend constexpr bool operator>=(Money a, Money b) { return a.cents >= b.cents; }
+
+    /**
+     * @brief Writes the amount formatted by toString(), honouring the stream's field width.
+     */
+    friend std::ostream& operator<<(std::ostream& os, Money amount);
+
+private:
+    constexpr explicit Money(std::int64_t cents) : cents(cents) {}
+
+    std::int64_t cents; ///< Amount in cents.
+};
+
+#endif // MONEY_H
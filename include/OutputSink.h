@@ -0,0 +1,176 @@
+#ifndef OUTPUT_SINK_H
+#define OUTPUT_SINK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+/**
+ * @enum ScanEvent
+ * @brief What happened to a scanned line.
+ */
+enum class ScanEvent : std::uint8_t {
+    QUANTITY_UPDATED = 1,      ///< The item's cart quantity changed.
+    QUANTITY_CLAMPED = 2,      ///< The requested quantity exceeded the limit and was capped; an update follows.
+    ITEM_REMOVED = 3,          ///< The item's cart quantity dropped to zero or below and was reset to zero.
+    ITEM_NOT_FOUND = 4,        ///< The scanned ID is not in the catalog.
+    INVALID_FORMAT = 5,        ///< The line could not be parsed.
+    QUANTITY_OUT_OF_RANGE = 6, ///< The quantity did not fit in an int.
+    ERROR = 7                  ///< Scanning failed unexpectedly; detail holds the reason.
+};
+
+/**
+ * @struct ScanMessage
+ * @brief Feedback for one scanned line. Views are only valid for the duration of the call.
+ */
+struct ScanMessage {
+    /**
+     * @brief Constructs a message with no item attached.
+     * @param event What happened.
+     */
+    explicit ScanMessage(ScanEvent event) : event(event) {}
+
+    ScanEvent event;                        ///< What happened.
+    std::uint32_t itemIndex = 0xFFFFFFFFu;  ///< Dense index of the item, or 0xFFFFFFFF if there is none.
+    std::string_view itemId;                ///< Item ID as stored, or as scanned for ITEM_NOT_FOUND.
+    std::string_view itemName;              ///< Item name, if the item was found.
+    int quantity = 0;                       ///< New cart quantity for QUANTITY_UPDATED and QUANTITY_CLAMPED.
+    std::string_view detail;                ///< Error text for ERROR.
+};
+
+/**
+ * @class OutputSink
+ * @brief Destination for everything a checkout session reports: scan feedback, help and receipts.
+ *
+ * Sessions never write to std::cout directly; they hand structured scan messages and
+ * preformatted text blocks to their sink, which decides whether and how to emit them.
+ */
+class OutputSink {
+public:
+    virtual ~OutputSink() = default;
+
+    /**
+     * @brief Reports the outcome of a scanned line.
+     * @param message The scan feedback.
+     */
+    virtual void scanMessage(const ScanMessage& message) = 0;
+
+    /**
+     * @brief Writes a block of human-readable text, such as the help screen or a receipt.
+     * @param text The text.
+     */
+    virtual void text(std::string_view text) = 0;
+
+    /**
+     * @brief Tells sessions whether text blocks are used at all, so they can skip formatting them.
+     * @return True if text() output is kept.
+     */
+    virtual bool wantsText() const;
+
+    /**
+     * @brief Writes out anything the sink has buffered.
+     */
+    virtual void flush();
+};
+
+/**
+ * @class NullSink
+ * @brief Sink that discards all output.
+ */
+class NullSink : public OutputSink {
+public:
+    void scanMessage(const ScanMessage& message) override;
+    void text(std::string_view text) override;
+    bool wantsText() const override;
+};
+
+/**
+ * @class TextSink
+ * @brief Sink that writes the interactive checkout messages to a stream.
+ *
+ * Messages are formatted with plain string appends. With a buffer size of zero each message
+ * is written as soon as it arrives, which keeps it in step with an interactive prompt; with a
+ * larger buffer, output is written once the buffer fills, on flush(), and on destruction.
+ * The stream itself is only flushed by flush().
+ */
+class TextSink : public OutputSink {
+public:
+    /**
+     * @brief Constructs a TextSink.
+     * @param stream The stream to write to; must outlive the sink.
+     * @param bufferSize Number of bytes to collect before writing to the stream.
+     */
+    explicit TextSink(std::ostream& stream, std::size_t bufferSize = 0);
+
+    /**
+     * @brief Writes any buffered output.
+     */
+    ~TextSink() override;
+
+    void scanMessage(const ScanMessage& message) override;
+    void text(std::string_view text) override;
+    void flush() override;
+
+    /**
+     * @brief Formats a scan message as the interactive checkout shows it.
+     * @param message The scan feedback.
+     * @param output Buffer the text is appended to.
+     */
+    static void formatScanMessage(const ScanMessage& message, std::string& output);
+
+private:
+    std::ostream& stream;   ///< Destination stream.
+    std::size_t bufferSize; ///< Bytes to collect before writing.
+    std::string buffer;     ///< Output not yet written.
+
+    /**
+     * @brief Writes the buffer once it reaches the buffer size.
+     */
+    void writeIfFull();
+};
+
+/**
+ * @class BinarySink
+ * @brief Sink that writes scan messages as fixed-size binary records; text blocks are dropped.
+ *
+ * Records are written in host byte order, in the order the messages arrive.
+ */
+class BinarySink : public OutputSink {
+public:
+    /**
+     * @struct Record
+     * @brief On-disk layout of one scan message (12 bytes).
+     */
+    struct Record {
+        std::uint8_t event;       ///< ScanEvent value.
+        std::uint8_t reserved[3]; ///< Zero.
+        std::uint32_t itemIndex;  ///< Dense item index, or 0xFFFFFFFF if there is none.
+        std::int32_t quantity;    ///< New cart quantity, or zero.
+    };
+
+    /**
+     * @brief Constructs a BinarySink.
+     * @param stream The stream to write to; must outlive the sink.
+     * @param bufferSize Number of bytes to collect before writing to the stream.
+     */
+    explicit BinarySink(std::ostream& stream, std::size_t bufferSize = 64 * 1024);
+
+    /**
+     * @brief Writes any buffered records.
+     */
+    ~BinarySink() override;
+
+    void scanMessage(const ScanMessage& message) override;
+    void text(std::string_view text) override;
+    bool wantsText() const override;
+    void flush() override;
+
+private:
+    std::ostream& stream;   ///< Destination stream.
+    std::size_t bufferSize; ///< Bytes to collect before writing.
+    std::string buffer;     ///< Records not yet written.
+};
+
+#endif // OUTPUT_SINK_H
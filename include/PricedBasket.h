@@ -0,0 +1,235 @@
+#ifndef PRICED_BASKET_H
+#define PRICED_BASKET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ItemBitset.h"
+#include "Money.h"
+
+class Deal;
+
+/**
+ * @enum DealType
+ * @brief Represents the type of deal applied to an item.
+ */
+enum class DealType {
+    NONE,  ///< No deal applied.
+    TYPE1, ///< Buy 3 Identical Items, Pay for 2.
+    TYPE2, ///< Buy 3 Different Items from a Set, Cheapest is Free.
+    RULE   ///< Any other promotion declared in the catalog's deal rules.
+};
+
+/**
+ * @class PricedBasket
+ * @brief The cart lines of a basket, with deal and price information, stored as parallel arrays.
+ *
+ * Each line is one item and the quantity purchased. Lines are kept sorted by dense item index
+ * and addressed by position. Every field lives in its own array (item index, quantity, unit
+ * price, units used by deals, discount and last deal), so the totals are plain loops over
+ * contiguous integers that the compiler can vectorize, with no pointer to follow per line.
+ *
+ * The items with a line are also kept in an ItemBitset, so whether an item, or every item of
+ * a deal, is in the basket is answered from bits before any line is searched for.
+ *
+ * Deals operate on whole lines rather than on individual units, so the cost of applying
+ * deals depends on the number of distinct items in the cart, not on the number of units.
+ */
+class PricedBasket {
+public:
+    /// Position returned by find() for an item without a line.
+    static constexpr std::size_t NPOS = static_cast<std::size_t>(-1);
+
+    /**
+     * @brief Gets the number of lines.
+     * @return The number of lines.
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Checks whether the basket has no lines.
+     * @return True if there are no lines.
+     */
+    bool empty() const;
+
+    /**
+     * @brief Finds where an item's line is, or would be inserted.
+     * @param itemIndex Dense catalog index of the item.
+     * @return Position of the first line whose item index is not less than itemIndex.
+     */
+    std::size_t lowerBound(std::uint32_t itemIndex) const;
+
+    /**
+     * @brief Finds an item's line.
+     * @param itemIndex Dense catalog index of the item.
+     * @return Position of the line, or NPOS if the item has none.
+     */
+    std::size_t find(std::uint32_t itemIndex) const;
+
+    /**
+     * @brief Checks whether an item has a line.
+     * @param itemIndex Dense catalog index of the item.
+     * @return True if the item is in the basket.
+     */
+    bool contains(std::uint32_t itemIndex) const;
+
+    /**
+     * @brief Gets the set of items that have a line.
+     * @return The items in the basket, one bit per catalog item.
+     */
+    const ItemBitset& getPresence() const;
+
+    /**
+     * @brief Sets the quantity of an item, adding or removing its line as needed.
+     *
+     * The line starts over with no deals applied.
+     *
+     * @param itemIndex Dense catalog index of the item.
+     * @param quantity Number of units; 0 removes the line.
+     * @param unitPrice Price of one unit.
+     */
+    void setLine(std::uint32_t itemIndex, int quantity, Money unitPrice);
+
+    /**
+     * @brief Removes every line.
+     */
+    void clear();
+
+    /**
+     * @brief Removes the deals applied to one line.
+     * @param line Position of the line.
+     */
+    void clearDeals(std::size_t line);
+
+    /**
+     * @brief Removes the deals applied to every line.
+     */
+    void clearDeals();
+
+    /**
+     * @brief Retrieves the dense catalog index of a line's item.
+     * @param line Position of the line.
+     * @return The item index.
+     */
+    std::uint32_t getItemIndex(std::size_t line) const;
+
+    /**
+     * @brief Retrieves the number of units on a line.
+     * @param line Position of the line.
+     * @return The quantity purchased.
+     */
+    int getQuantity(std::size_t line) const;
+
+    /**
+     * @brief Retrieves the price of one unit on a line.
+     * @param line Position of the line.
+     * @return The unit price.
+     */
+    Money getUnitPrice(std::size_t line) const;
+
+    /**
+     * @brief Checks if any unit on a line is used in a deal.
+     * @param line Position of the line.
+     * @return True if at least one unit is used in a deal, false otherwise.
+     */
+    bool isUsedInDeal(std::size_t line) const;
+
+    /**
+     * @brief Retrieves the number of units on a line not yet used in any deal.
+     * @param line Position of the line.
+     * @return The quantity still available to deals.
+     */
+    int getAvailableQuantity(std::size_t line) const;
+
+    /**
+     * @brief Marks units of a line as used in a deal.
+     * @param line Position of the line.
+     * @param units Number of units consumed by the deal.
+     */
+    void useInDeal(std::size_t line, int units);
+
+    /**
+     * @brief Makes units of a line free as the result of a deal.
+     * @param line Position of the line.
+     * @param units Number of units that are free.
+     * @param deal The deal that made the units free.
+     */
+    void addFreeUnits(std::size_t line, int units, const Deal& deal);
+
+    /**
+     * @brief Takes an amount off a line as the result of a deal.
+     * @param line Position of the line.
+     * @param amount The discount.
+     * @param deal The deal that gave the discount.
+     */
+    void addDiscount(std::size_t line, Money amount, const Deal& deal);
+
+    /**
+     * @brief Retrieves the discount deals gave on a line.
+     * @param line Position of the line.
+     * @return The total discount deals gave on the line.
+     */
+    Money getDiscount(std::size_t line) const;
+
+    /**
+     * @brief Retrieves the final price of a line, considering applied deals.
+     * @param line Position of the line.
+     * @return The line subtotal minus its discount.
+     */
+    Money getFinalPrice(std::size_t line) const;
+
+    /**
+     * @brief Retrieves the last deal that discounted a line.
+     * @param line Position of the line.
+     * @return The deal, or nullptr if no deal discounted the line.
+     */
+    const Deal* getDeal(std::size_t line) const;
+
+    /**
+     * @brief Retrieves the type of the last deal that discounted a line.
+     * @param line Position of the line.
+     * @return The deal type applied to the line.
+     */
+    DealType getDealType(std::size_t line) const;
+
+    /**
+     * @brief Gets the item index of every line, in line order.
+     * @return The item indices, sorted.
+     */
+    const std::vector<std::uint32_t>& getItemIndices() const;
+
+    /**
+     * @brief Sums the quantities of all lines.
+     * @return The number of units in the basket.
+     */
+    int getUnits() const;
+
+    /**
+     * @brief Sums the lines before discounts.
+     * @return The total before discounts.
+     */
+    Money getPreDiscountTotal() const;
+
+    /**
+     * @brief Sums the discounts of all lines.
+     * @return The total discount.
+     */
+    Money getDiscountTotal() const;
+
+    /**
+     * @brief Sums the final prices of all lines.
+     * @return The total after discounts.
+     */
+    Money getFinalTotal() const;
+
+private:
+    std::vector<std::uint32_t> itemIndices; ///< Dense catalog index of each line's item, sorted.
+    std::vector<std::int32_t> quantities;   ///< Number of units on each line.
+    std::vector<std::int64_t> unitPrices;   ///< Price of one unit of each line, in cents.
+    std::vector<std::int32_t> usedInDeal;   ///< Units of each line used in a deal.
+    std::vector<std::int64_t> discounts;    ///< Discount of each line from deals, in cents.
+    std::vector<const Deal*> lastDeals;     ///< Last deal applied to each line, or nullptr.
+    ItemBitset presence;                    ///< Items that have a line.
+};
+
+#endif // PRICED_BASKET_H
@@ -0,0 +1,136 @@
+#ifndef RECEIPT_H
+#define RECEIPT_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Catalog.h"
+#include "Deal.h"
+#include "Money.h"
+
+/**
+ * @struct ReceiptLine
+ * @brief One item on a receipt.
+ */
+struct ReceiptLine {
+    std::uint32_t itemIndex = 0;          ///< Dense catalog index of the item.
+    int quantity = 0;                     ///< Units bought.
+    Money unitPrice;                      ///< Catalog price of one unit.
+    Money preDiscount;                    ///< Line total before discounts.
+    Money discount;                       ///< Discount from deals on this line.
+    Money total;                          ///< Line total after discounts.
+    DealType dealType = DealType::NONE;   ///< Type of the deal that discounted the line, if any.
+    const Deal* deal = nullptr;           ///< Last deal that discounted the line, if any.
+};
+
+/**
+ * @struct Receipt
+ * @brief A priced basket as plain data, ready to be written by a ReceiptWriter.
+ *
+ * There is one line per item bought, in the order the text receipt lists them: by item name,
+ * then by item ID for items that share a name. Amounts are numeric; nothing is formatted until
+ * the receipt is written.
+ */
+struct Receipt {
+    std::uint64_t number = 0;                ///< Receipt number, e.g. the basket's sequence number.
+    std::shared_ptr<const Catalog> catalog;  ///< Catalog the basket was priced against.
+    std::vector<ReceiptLine> lines;          ///< Items bought.
+    std::vector<DealApplication> deals;      ///< Deals applied, in application order.
+    int units = 0;                           ///< Number of units bought.
+    Money preDiscount;                       ///< Total before discounts.
+    Money savings;                           ///< Total discount from applied deals.
+    Money total;                             ///< Total after discounts.
+};
+
+/**
+ * @class ReceiptWriter
+ * @brief Serializes receipts for people and for downstream systems.
+ *
+ * Every writer appends to a caller-owned buffer, so one buffer can be reused across receipts.
+ */
+class ReceiptWriter {
+public:
+    /**
+     * @struct BinaryHeader
+     * @brief Start of a binary receipt (48 bytes), followed by its lines and then its deals.
+     */
+    struct BinaryHeader {
+        char magic[4];            ///< "RCP1".
+        std::uint32_t lineCount;  ///< Number of BinaryLine records that follow.
+        std::uint32_t dealCount;  ///< Number of BinaryDeal records after the lines.
+        std::int32_t units;       ///< Number of units bought.
+        std::uint64_t number;     ///< Receipt number.
+        std::int64_t preDiscount; ///< Total before discounts, in cents.
+        std::int64_t savings;     ///< Total discount, in cents.
+        std::int64_t total;       ///< Total after discounts, in cents.
+    };
+
+    /**
+     * @struct BinaryLine
+     * @brief One receipt line in a binary receipt (40 bytes).
+     */
+    struct BinaryLine {
+        std::uint32_t itemIndex;  ///< Dense catalog index of the item.
+        std::int32_t quantity;    ///< Units bought.
+        std::int64_t unitPrice;   ///< Price of one unit, in cents.
+        std::int64_t discount;    ///< Discount on the line, in cents.
+        std::int64_t total;       ///< Line total after discounts, in cents.
+        std::uint8_t dealType;    ///< DealType value.
+        std::uint8_t reserved[7]; ///< Zero.
+    };
+
+    /**
+     * @struct BinaryDeal
+     * @brief One deal application in a binary receipt (24 bytes).
+     */
+    struct BinaryDeal {
+        /// dealIndex of a deal that is not in the receipt's catalog.
+        static constexpr std::uint32_t NO_DEAL_INDEX = 0xFFFFFFFF;
+
+        std::uint8_t dealType;    ///< DealType value.
+        std::uint8_t reserved[3]; ///< Zero.
+        std::uint32_t itemIndex;  ///< Dense catalog index of the item made free by each set.
+        std::int32_t sets;        ///< Number of times the deal was applied.
+        std::uint32_t dealIndex;  ///< Index of the deal in Catalog::getDeals(), or NO_DEAL_INDEX.
+        std::int64_t discount;    ///< Discount of a single set, in cents.
+    };
+
+    /**
+     * @brief Writes the receipt as the interactive checkout prints it.
+     * @param receipt The receipt.
+     * @param output Buffer the text is appended to.
+     */
+    static void writeText(const Receipt& receipt, std::string& output);
+
+    /**
+     * @brief Writes the receipt as one JSON object on a single line, with a trailing newline.
+     * @param receipt The receipt.
+     * @param output Buffer the line is appended to.
+     */
+    static void writeJsonLine(const Receipt& receipt, std::string& output);
+
+    /**
+     * @brief Writes the CSV header row matching writeCsv.
+     * @param output Buffer the row is appended to.
+     */
+    static void writeCsvHeader(std::string& output);
+
+    /**
+     * @brief Writes one CSV row per receipt line; deals are reflected in each line's discount.
+     *
+     * Discounted lines name the type and the name of the last deal that discounted them.
+     * @param receipt The receipt.
+     * @param output Buffer the rows are appended to.
+     */
+    static void writeCsv(const Receipt& receipt, std::string& output);
+
+    /**
+     * @brief Writes the receipt as fixed-size records in host byte order.
+     * @param receipt The receipt.
+     * @param output Buffer the records are appended to.
+     */
+    static void writeBinary(const Receipt& receipt, std::string& output);
+};
+
+#endif // RECEIPT_H
@@ -0,0 +1,140 @@
+#ifndef REPLAY_DRIVER_H
+#define REPLAY_DRIVER_H
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Catalog.h"
+#include "Checkout.h"
+#include "WorkStealingPool.h"
+
+/**
+ * @class ReplayDriver
+ * @brief Replays a log of scanned baskets without prompts and writes one result line per basket.
+ *
+ * The input holds one scan command per line, in the same format as the interactive prompt.
+ * A basket ends at a blank line, a line reading `done`, or the end of the input; baskets with
+ * no scan lines are skipped. Each basket is scanned, has its deals applied, and is written as
+ * a single JSON object on its own line:
+ *
+ *     {"basket":1,"lines":3,"units":6,"subtotal":7.50,"savings":1.50,"total":6.00,"deals":2}
+ *
+ * Scan messages are discarded. Baskets are numbered from 1 in input order. Instead of the summary
+ * line, each basket's full receipt can be written in any of the ReceiptWriter formats.
+ *
+ * With more than one thread, the input is read in chunks of baskets that are priced on a
+ * WorkStealingPool, each worker with its own Checkout session over the shared catalog. Results
+ * are written in input order, so the output is byte-identical to a single-threaded replay.
+ */
+class ReplayDriver {
+public:
+    /**
+     * @enum Format
+     * @brief What is written for each basket.
+     */
+    enum class Format {
+        SUMMARY,    ///< One JSON summary line per basket (the default).
+        TEXT,       ///< The text receipt, as the interactive checkout prints it.
+        JSON_LINES, ///< ReceiptWriter::writeJsonLine.
+        CSV,        ///< ReceiptWriter::writeCsv, after a single header row.
+        BINARY      ///< ReceiptWriter::writeBinary.
+    };
+
+    /**
+     * @struct Summary
+     * @brief Counts of what a replay processed.
+     */
+    struct Summary {
+        std::uint64_t baskets = 0; ///< Number of baskets priced.
+        std::uint64_t scans = 0;   ///< Number of scan lines processed.
+    };
+
+    /**
+     * @brief Constructs a ReplayDriver.
+     * @param catalog The catalog baskets are priced against; must not be null.
+     * @param strategy How overlapping deals are assigned.
+     * @param threads Number of worker threads; 1 replays on the calling thread, 0 uses every hardware thread.
+     */
+    explicit ReplayDriver(std::shared_ptr<const Catalog> catalog, DealStrategy strategy = DealStrategy::GREEDY,
+                          unsigned threads = 1);
+
+    /**
+     * @brief Chooses what is written for each basket.
+     * @param format The output format.
+     */
+    void setFormat(Format format);
+
+    /**
+     * @brief Gets the number of threads baskets are priced on.
+     * @return The thread count.
+     */
+    unsigned getThreadCount() const;
+
+    /**
+     * @brief Replays every basket in a stream.
+     * @param input The scan log.
+     * @param output Where the result lines are written.
+     * @return Counts of the baskets and scans replayed.
+     */
+    Summary run(std::istream& input, std::ostream& output);
+
+    /**
+     * @brief Formats the result line of a priced basket, without the trailing newline.
+     * @param basket The basket number.
+     * @param checkout The session holding the priced basket.
+     * @param result Buffer the line is appended to.
+     */
+    static void formatResult(std::uint64_t basket, const Checkout& checkout, std::string& result);
+
+private:
+    /// Baskets read from the input before they are priced in parallel.
+    static constexpr std::size_t CHUNK_BASKETS = 16384;
+
+    /// Baskets priced by one pool task.
+    static constexpr std::size_t BATCH_BASKETS = 64;
+
+    // One session per worker, reused for every basket that worker prices
+    std::vector<Checkout> sessions;
+
+    // One receipt per worker, refilled for every basket that worker prices
+    std::vector<Receipt> receipts;
+
+    // What is written for each basket
+    Format format = Format::SUMMARY;
+
+    // Workers for parallel replay; null when replaying on the calling thread
+    std::unique_ptr<WorkStealingPool> pool;
+
+    /**
+     * @brief Replays on the calling thread, one basket at a time.
+     * @param input The scan log.
+     * @param output Where the result lines are written.
+     * @return Counts of the baskets and scans replayed.
+     */
+    Summary runSerial(std::istream& input, std::ostream& output);
+
+    /**
+     * @brief Replays chunks of baskets on the worker pool.
+     * @param input The scan log.
+     * @param output Where the result lines are written.
+     * @return Counts of the baskets and scans replayed.
+     */
+    Summary runParallel(std::istream& input, std::ostream& output);
+
+    /**
+     * @brief Scans, prices and formats one basket.
+     * @param worker Index of the session and receipt to use.
+     * @param basket The basket number.
+     * @param begin First scan line of the basket.
+     * @param end One past the last scan line of the basket.
+     * @param result Buffer the result is appended to.
+     */
+    void priceBasket(unsigned worker, std::uint64_t basket, const std::string* begin, const std::string* end,
+                     std::string& result);
+};
+
+#endif // REPLAY_DRIVER_H
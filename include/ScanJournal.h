@@ -0,0 +1,172 @@
+#ifndef SCAN_JOURNAL_H
+#define SCAN_JOURNAL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class ScanJournal
+ * @brief Append-only write-ahead journal of cart changes, used to rebuild carts after a crash.
+ *
+ * Sessions record every change to a cart as it happens; records are only buffered in memory
+ * until commit() writes them out and flushes them to disk with a single fdatasync, so one
+ * flush covers every scan made since the last commit (group commit). A caller that has to
+ * acknowledge a scan as durable commits before answering it.
+ *
+ * The file starts with an 8-byte header (magic "SJNL" and a format version) followed by
+ * variable-size records in host byte order: a 16-byte RecordHeader and, for
+ * RecordType::QUANTITY, the item ID. Quantities are absolute, so replaying the journal in
+ * order gives the final cart of every lane regardless of how it was reached. Records carry an
+ * FNV-1a checksum; a record torn by a crash ends the journal and is cut off on recovery.
+ *
+ * Opening a journal recovers the carts still in progress and compacts the file down to just
+ * those carts, so the journal does not grow across restarts. Items are recorded by ID rather
+ * than catalog index, so carts survive a catalog reload between crash and restart.
+ *
+ * A journal is not safe to use from several threads.
+ */
+class ScanJournal {
+public:
+    /// Magic bytes at the start of every journal.
+    static constexpr char MAGIC[4] = {'S', 'J', 'N', 'L'};
+
+    /// Current journal format version.
+    static constexpr std::uint32_t FORMAT_VERSION = 1;
+
+    /**
+     * @enum RecordType
+     * @brief Kind of change a record describes.
+     */
+    enum class RecordType : std::uint8_t {
+        QUANTITY = 1,      ///< An item's quantity in a lane's cart changed; 0 removes it.
+        BASKET_CLOSED = 2  ///< The lane's basket was finished or abandoned; its cart is empty.
+    };
+
+    /**
+     * @struct RecordHeader
+     * @brief Fixed part of a journal record (16 bytes).
+     */
+    struct RecordHeader {
+        std::uint32_t checksum;   ///< FNV-1a hash of the rest of the header and the item ID.
+        std::uint32_t lane;       ///< Lane whose cart changed.
+        std::int32_t quantity;    ///< New quantity of the item (QUANTITY only).
+        std::uint8_t type;        ///< RecordType value.
+        std::uint8_t reserved;    ///< Zero.
+        std::uint16_t idLength;   ///< Length of the item ID that follows the header.
+    };
+
+    /**
+     * @struct CartLine
+     * @brief One item of a recovered cart.
+     */
+    struct CartLine {
+        std::string itemId; ///< Item ID, as recorded.
+        int quantity;       ///< Quantity in the cart.
+    };
+
+    /**
+     * @brief Opens or creates a journal, recovering the carts it holds.
+     * @param path Path of the journal file.
+     * @throws std::runtime_error if the file cannot be read, rewritten or opened for appending,
+     *         or is not a journal.
+     */
+    explicit ScanJournal(const std::string& path);
+
+    /**
+     * @brief Commits any pending records and closes the journal.
+     */
+    ~ScanJournal();
+
+    ScanJournal(const ScanJournal&) = delete;
+    ScanJournal& operator=(const ScanJournal&) = delete;
+
+    /**
+     * @brief Gets the carts that were in progress when the journal was opened.
+     * @return Recovered carts by lane, each in the order its items were first scanned.
+     */
+    const std::map<std::uint32_t, std::vector<CartLine>>& getRecoveredCarts() const;
+
+    /**
+     * @brief Hands over a lane's recovered cart.
+     * @param lane The lane.
+     * @return The cart, or an empty cart if none was recovered or it was already taken.
+     */
+    std::vector<CartLine> takeRecoveredCart(std::uint32_t lane);
+
+    /**
+     * @brief Records an item's new quantity in a lane's cart.
+     * @param lane The lane.
+     * @param itemId The item ID.
+     * @param quantity The item's quantity after the change.
+     */
+    void recordQuantity(std::uint32_t lane, std::string_view itemId, int quantity);
+
+    /**
+     * @brief Records that a lane's basket has been closed.
+     * @param lane The lane.
+     */
+    void recordBasketClosed(std::uint32_t lane);
+
+    /**
+     * @brief Checks whether records are waiting for commit().
+     * @return True if there are uncommitted records.
+     */
+    bool hasPending() const;
+
+    /**
+     * @brief Writes every pending record and flushes the journal to disk.
+     *
+     * If the records cannot be written or flushed, the file is cut back to its size after the
+     * last successful commit and the records stay pending, so the next commit() writes them
+     * again without leaving a torn record in front of them.
+     *
+     * @throws std::runtime_error if the records cannot be written or flushed.
+     */
+    void commit();
+
+private:
+    // Path of the journal file
+    std::string path;
+
+    // File descriptor opened for appending
+    int fd = -1;
+
+    // Records not yet committed
+    std::string pending;
+
+    // Size of the file after the last successful commit
+    std::uint64_t committedSize = 0;
+
+    // Whether a failed commit may have left bytes past committedSize
+    bool torn = false;
+
+    // Carts in progress when the journal was opened, by lane
+    std::map<std::uint32_t, std::vector<CartLine>> recoveredCarts;
+
+    /**
+     * @brief Reads the journal, if there is one, into recoveredCarts.
+     */
+    void recover();
+
+    /**
+     * @brief Replaces the journal with one holding only the recovered carts.
+     */
+    void compact();
+
+    /**
+     * @brief Appends one record to a buffer.
+     * @param buffer The buffer.
+     * @param type The record type.
+     * @param lane The lane.
+     * @param itemId The item ID, empty for RecordType::BASKET_CLOSED.
+     * @param quantity The quantity.
+     */
+    static void appendRecord(std::string& buffer, RecordType type, std::uint32_t lane, std::string_view itemId,
+                             int quantity);
+};
+
+#endif // SCAN_JOURNAL_H
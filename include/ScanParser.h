@@ -0,0 +1,49 @@
+#ifndef SCAN_PARSER_H
+#define SCAN_PARSER_H
+
+#include <string_view>
+
+/**
+ * @enum ScanParseError
+ * @brief Reasons a scanned line can be rejected by parseScanLine.
+ */
+enum class ScanParseError {
+    NONE,                 ///< The line was parsed successfully.
+    INVALID_FORMAT,       ///< The line does not match the "ID [quantity]" grammar.
+    QUANTITY_OUT_OF_RANGE ///< The quantity does not fit in an int.
+};
+
+/**
+ * @enum ScanCommandType
+ * @brief Kinds of commands a scanned line can contain.
+ */
+enum class ScanCommandType {
+    SCAN, ///< Add or remove a quantity of an item.
+    HELP  ///< Display the help message.
+};
+
+/**
+ * @struct ScanCommand
+ * @brief Result of parsing one scanned line.
+ */
+struct ScanCommand {
+    ScanCommandType type = ScanCommandType::SCAN; ///< The kind of command.
+    ScanParseError error = ScanParseError::NONE;  ///< Why the line was rejected, if it was.
+    std::string_view itemId;                      ///< Item ID as typed (not upper-cased), pointing into the input.
+    int quantity = 1;                             ///< Quantity to add (negative to remove); 1 if omitted.
+};
+
+/**
+ * @brief Parses a scanned line of the form "ID [quantity]".
+ *
+ * Leading and trailing whitespace is ignored. The ID is 1 to 5 ASCII letters or digits,
+ * optionally followed by whitespace and an integer quantity with an optional leading '-'.
+ * The line "help" is recognised as a help command. The parser never allocates; the
+ * returned item ID refers to the input.
+ *
+ * @param input The scanned line.
+ * @return The parsed command, with error set if the line is invalid.
+ */
+ScanCommand parseScanLine(std::string_view input) noexcept;
+
+#endif // SCAN_PARSER_H
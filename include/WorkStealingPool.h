@@ -0,0 +1,94 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class WorkStealingPool
+ * @brief Fixed set of worker threads that run indexed tasks with work stealing.
+ *
+ * parallelFor deals the task indices out to the workers' queues in contiguous blocks. Each
+ * worker takes tasks from the front of its own queue and, once that is empty, steals from the
+ * back of another worker's queue, so uneven tasks keep every worker busy. Tasks are told which
+ * worker runs them, so per-worker state can be used without locking.
+ */
+class WorkStealingPool {
+public:
+    /**
+     * @brief Starts the worker threads.
+     * @param threads Number of workers; 0 uses the number of hardware threads.
+     */
+    explicit WorkStealingPool(unsigned threads);
+
+    /**
+     * @brief Stops and joins the worker threads.
+     */
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /**
+     * @brief Gets the number of workers.
+     * @return The worker count.
+     */
+    unsigned size() const;
+
+    /**
+     * @brief Runs task(worker, index) for every index in [0, count) and waits for all of them.
+     *
+     * Must not be called from a task or from several threads at once.
+     *
+     * @param count Number of tasks.
+     * @param task The task; worker is in [0, size()).
+     * @throws The first exception thrown by a task, after all tasks have finished.
+     */
+    void parallelFor(std::size_t count, const std::function<void(unsigned worker, std::size_t index)>& task);
+
+private:
+    /**
+     * @struct Queue
+     * @brief One worker's queue of task indices.
+     */
+    struct Queue {
+        std::mutex mutex;              ///< Guards tasks.
+        std::deque<std::size_t> tasks; ///< Task indices not yet started.
+    };
+
+    std::vector<std::thread> workers;            ///< Worker threads.
+    std::vector<std::unique_ptr<Queue>> queues;  ///< One queue per worker.
+
+    std::mutex mutex;                  ///< Guards the job state below.
+    std::condition_variable jobReady;  ///< Signalled when a job starts or the pool stops.
+    std::condition_variable jobDone;   ///< Signalled when the last worker finishes a job.
+    const std::function<void(unsigned, std::size_t)>* job = nullptr; ///< Current job.
+    std::uint64_t generation = 0;      ///< Incremented for every job.
+    unsigned running = 0;              ///< Workers still working on the current job.
+    bool stopping = false;             ///< Set when the pool is being destroyed.
+    std::exception_ptr error;          ///< First exception thrown by the current job.
+
+    /**
+     * @brief Worker thread body.
+     * @param worker The worker's index.
+     */
+    void workerLoop(unsigned worker);
+
+    /**
+     * @brief Takes the next task for a worker, stealing if its own queue is empty.
+     * @param worker The worker's index.
+     * @param index Set to the task index.
+     * @return False once every queue is empty.
+     */
+    bool nextTask(unsigned worker, std::size_t& index);
+};
+
+#endif // WORK_STEALING_POOL_H
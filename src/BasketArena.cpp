@@ -0,0 +1,68 @@
+// BasketArena.cpp
+#include "BasketArena.h"
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+BasketArena::BasketArena(std::size_t capacity)
+    : block(new std::byte[capacity]), capacity(capacity) {}
+
+BasketArena::~BasketArena() {
+    freeOverflow();
+}
+
+void BasketArena::release() {
+    freeOverflow();
+
+    // Grow the block to what this basket needed, so the next one like it stays inside it
+    if (overflowBytes > 0) {
+        capacity = std::max(capacity * 2, offset + overflowBytes);
+        block.reset(new std::byte[capacity]);
+    }
+    offset = 0;
+    overflowBytes = 0;
+}
+
+std::size_t BasketArena::getCapacity() const {
+    return capacity;
+}
+
+std::size_t BasketArena::getUsed() const {
+    return offset + overflowBytes;
+}
+
+void* BasketArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+    std::uintptr_t start = reinterpret_cast<std::uintptr_t>(block.get());
+    std::uintptr_t aligned = (start + offset + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+    if (aligned + bytes <= start + capacity) {
+        offset = aligned + bytes - start;
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    // The block is full: take one from the heap, large enough to align the allocation after its header
+    std::size_t size = sizeof(Overflow) + alignment + bytes;
+    Overflow* taken = static_cast<Overflow*>(::operator new(size));
+    taken->next = overflow;
+    taken->bytes = size;
+    overflow = taken;
+    overflowBytes += bytes + alignment;
+
+    std::uintptr_t data = reinterpret_cast<std::uintptr_t>(taken + 1);
+    return reinterpret_cast<void*>((data + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1));
+}
+
+void BasketArena::do_deallocate(void*, std::size_t, std::size_t) {
+    // Memory is reclaimed all at once by release()
+}
+
+bool BasketArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+void BasketArena::freeOverflow() {
+    while (overflow) {
+        Overflow* next = overflow->next;
+        ::operator delete(overflow);
+        overflow = next;
+    }
+}
@@ -0,0 +1,389 @@
+// BinaryCatalog.cpp
+#include "BinaryCatalog.h"
+#include "CustomExceptions.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <set>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+struct BinaryCatalog::Header {
+    char magic[8];               ///< Must equal MAGIC.
+    std::uint32_t version;       ///< Image format version.
+    std::uint32_t headerSize;    ///< sizeof(Header), for sanity checking.
+    std::uint32_t itemCount;     ///< Number of item records.
+    std::uint32_t dealType1Count;///< Number of Deal Type 1 entries.
+    std::uint32_t dealType2Count;///< Number of Deal Type 2 sets.
+    std::uint32_t reserved;      ///< Always zero.
+    std::uint64_t itemsOffset;   ///< Offset of the item records.
+    std::uint64_t dealType1Offset; ///< Offset of the Deal Type 1 table.
+    std::uint64_t dealType2Offset; ///< Offset of the Deal Type 2 table.
+    std::uint64_t stringsOffset; ///< Offset of the string table.
+    std::uint64_t stringsSize;   ///< Size of the string table in bytes.
+    std::uint64_t checksum;      ///< FNV-1a hash of everything after the header.
+};
+
+struct BinaryCatalog::ItemRecord {
+    std::int64_t priceCents;     ///< Price in cents.
+    std::uint32_t idOffset;      ///< Offset of the ID in the string table.
+    std::uint32_t nameOffset;    ///< Offset of the name in the string table.
+    std::uint16_t idLength;      ///< Length of the ID.
+    std::uint16_t nameLength;    ///< Length of the name.
+    std::uint32_t reserved;      ///< Always zero.
+};
+
+struct BinaryCatalog::DealType2Record {
+    std::uint32_t size;          ///< Number of eligible items (at most 3).
+    std::uint32_t itemIndices[3];///< Eligible item indices, sorted by item ID.
+};
+
+namespace {
+
+constexpr std::size_t ALIGNMENT = 8;
+
+std::uint64_t fnv1a(const unsigned char* bytes, std::size_t length) {
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    for (std::size_t i = 0; i < length; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+std::size_t alignUp(std::size_t value) {
+    return (value + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+template <typename T>
+void appendRaw(std::vector<unsigned char>& image, const T& value) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+    image.insert(image.end(), bytes, bytes + sizeof(T));
+}
+
+void padTo(std::vector<unsigned char>& image, std::size_t offset) {
+    image.resize(offset, 0);
+}
+
+[[noreturn]] void invalidImage(const std::string& reason) {
+    throw std::runtime_error("Invalid binary catalog: " + reason);
+}
+
+} // namespace
+
+void BinaryCatalog::compile(const json& data, const std::string& filename) {
+    if (!data.contains("items") || !data["items"].is_array()) {
+        throw InvalidItemException("Invalid or missing 'items' array in JSON data.");
+    }
+
+    // Items keyed by ID; as with the JSON loader, the first occurrence of an ID wins
+    std::map<std::string, std::pair<std::string, Money>> items;
+    for (const auto& itemData : data["items"]) {
+        if (!itemData.contains("id") || !itemData.contains("name") || !itemData.contains("price")) {
+            throw InvalidItemException("Item data missing required fields (id, name, price).");
+        }
+
+        std::string id = itemData["id"].get<std::string>();
+        std::string name = itemData["name"].get<std::string>();
+        double price = itemData["price"].get<double>();
+
+        if (id.empty() || name.empty() || price < 0.0) {
+            throw InvalidItemException("Invalid item data: ID, name cannot be empty, price cannot be negative.");
+        }
+        if (id.size() > 0xFFFF || name.size() > 0xFFFF) {
+            throw InvalidItemException("Invalid item data: ID and name must be shorter than 65536 bytes.");
+        }
+
+        items.emplace(id, std::make_pair(name, Money::fromDouble(price)));
+    }
+
+    std::map<std::string, std::uint32_t> indexById;
+    for (const auto& pair : items) {
+        indexById.emplace(pair.first, static_cast<std::uint32_t>(indexById.size()));
+    }
+
+    if (!data.contains("deals") || !data["deals"].is_object()) {
+        throw InvalidDealException("Invalid or missing 'deals' object in JSON data.");
+    }
+    const auto& dealsData = data["deals"];
+
+    // The image only has tables for the two classic deal types; dropping rules would misprice baskets
+    if (dealsData.contains("rules") && !dealsData["rules"].empty()) {
+        throw InvalidDealException("Deal rules cannot be compiled into a binary catalog; load the JSON catalog.");
+    }
+
+    std::set<std::string> dealType1Items;
+    if (dealsData.contains("deal_type_1")) {
+        if (!dealsData["deal_type_1"].is_array()) {
+            throw InvalidDealException("'deal_type_1' should be an array.");
+        }
+        for (const auto& itemId : dealsData["deal_type_1"]) {
+            std::string id = itemId.get<std::string>();
+            if (indexById.find(id) == indexById.end()) {
+                throw InvalidDealException("Deal Type 1 contains unknown item ID: " + id);
+            }
+            dealType1Items.insert(id);
+        }
+    }
+
+    std::vector<DealType2Record> dealType2Records;
+    if (dealsData.contains("deal_type_2")) {
+        if (!dealsData["deal_type_2"].is_array()) {
+            throw InvalidDealException("'deal_type_2' should be an array.");
+        }
+        for (const auto& dealSet : dealsData["deal_type_2"]) {
+            if (!dealSet.is_array() || dealSet.size() != 3) {
+                throw InvalidDealException("Each 'deal_type_2' entry should be an array of exactly 3 item IDs.");
+            }
+
+            std::set<std::string> dealType2Items;
+            for (const auto& itemId : dealSet) {
+                std::string id = itemId.get<std::string>();
+                if (indexById.find(id) == indexById.end()) {
+                    throw InvalidDealException("Deal Type 2 contains unknown item ID: " + id);
+                }
+                dealType2Items.insert(id);
+            }
+
+            DealType2Record record{};
+            for (const std::string& id : dealType2Items) {
+                record.itemIndices[record.size++] = indexById.at(id);
+            }
+            dealType2Records.push_back(record);
+        }
+    }
+
+    // Build the string table and item records
+    std::vector<unsigned char> stringTable;
+    std::vector<ItemRecord> itemRecords;
+    itemRecords.reserve(items.size());
+    for (const auto& pair : items) {
+        if (stringTable.size() + pair.first.size() + pair.second.first.size() > 0xFFFFFFFFu) {
+            throw std::runtime_error("Catalog string table exceeds 4 GiB.");
+        }
+
+        ItemRecord record{};
+        record.priceCents = pair.second.second.getCents();
+        record.idOffset = static_cast<std::uint32_t>(stringTable.size());
+        record.idLength = static_cast<std::uint16_t>(pair.first.size());
+        stringTable.insert(stringTable.end(), pair.first.begin(), pair.first.end());
+        record.nameOffset = static_cast<std::uint32_t>(stringTable.size());
+        record.nameLength = static_cast<std::uint16_t>(pair.second.first.size());
+        stringTable.insert(stringTable.end(), pair.second.first.begin(), pair.second.first.end());
+        itemRecords.push_back(record);
+    }
+    // Lay out the image: header, items, Deal Type 1, Deal Type 2, strings
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = FORMAT_VERSION;
+    header.headerSize = sizeof(Header);
+    header.itemCount = static_cast<std::uint32_t>(itemRecords.size());
+    header.dealType1Count = static_cast<std::uint32_t>(dealType1Items.size());
+    header.dealType2Count = static_cast<std::uint32_t>(dealType2Records.size());
+    header.itemsOffset = alignUp(sizeof(Header));
+    header.dealType1Offset = alignUp(header.itemsOffset + itemRecords.size() * sizeof(ItemRecord));
+    header.dealType2Offset = alignUp(header.dealType1Offset + dealType1Items.size() * sizeof(std::uint32_t));
+    header.stringsOffset = alignUp(header.dealType2Offset + dealType2Records.size() * sizeof(DealType2Record));
+    header.stringsSize = stringTable.size();
+
+    std::vector<unsigned char> image;
+    image.reserve(header.stringsOffset + stringTable.size());
+    appendRaw(image, header);
+    padTo(image, header.itemsOffset);
+    for (const ItemRecord& record : itemRecords) {
+        appendRaw(image, record);
+    }
+    padTo(image, header.dealType1Offset);
+    for (const std::string& id : dealType1Items) {
+        appendRaw(image, indexById.at(id));
+    }
+    padTo(image, header.dealType2Offset);
+    for (const DealType2Record& record : dealType2Records) {
+        appendRaw(image, record);
+    }
+    padTo(image, header.stringsOffset);
+    image.insert(image.end(), stringTable.begin(), stringTable.end());
+
+    header.checksum = fnv1a(image.data() + sizeof(Header), image.size() - sizeof(Header));
+    std::memcpy(image.data(), &header, sizeof(Header));
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("Cannot open output file: " + filename);
+    }
+    file.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+    if (!file) {
+        throw std::runtime_error("Cannot write output file: " + filename);
+    }
+}
+
+bool BinaryCatalog::isBinaryCatalog(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    char magic[sizeof(MAGIC)] = {};
+    if (!file.read(magic, sizeof(magic))) {
+        return false;
+    }
+    return std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+BinaryCatalog::BinaryCatalog(const std::string& filename) {
+#ifdef _WIN32
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file) {
+        throw std::runtime_error("Cannot open catalog file: " + filename);
+    }
+    buffer.resize(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    data = buffer.data();
+    size = buffer.size();
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open catalog file: " + filename);
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot read catalog file: " + filename);
+    }
+    size = static_cast<std::size_t>(info.st_size);
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Cannot map catalog file: " + filename);
+    }
+    data = static_cast<const unsigned char*>(mapping);
+#endif
+
+    try {
+        if (size < sizeof(Header)) {
+            invalidImage("file is too small");
+        }
+        header = reinterpret_cast<const Header*>(data);
+        if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0) {
+            invalidImage("bad magic");
+        }
+        if (header->version != FORMAT_VERSION) {
+            invalidImage("unsupported format version " + std::to_string(header->version));
+        }
+        if (header->headerSize != sizeof(Header)) {
+            invalidImage("unexpected header size");
+        }
+
+        auto checkTable = [this](std::uint64_t offset, std::uint64_t count, std::uint64_t recordSize) {
+            if (offset % ALIGNMENT != 0 || offset > size || count > (size - offset) / recordSize) {
+                invalidImage("table out of bounds");
+            }
+        };
+        checkTable(header->itemsOffset, header->itemCount, sizeof(ItemRecord));
+        checkTable(header->dealType1Offset, header->dealType1Count, sizeof(std::uint32_t));
+        checkTable(header->dealType2Offset, header->dealType2Count, sizeof(DealType2Record));
+        checkTable(header->stringsOffset, header->stringsSize, 1);
+
+        if (fnv1a(data + sizeof(Header), size - sizeof(Header)) != header->checksum) {
+            invalidImage("checksum mismatch");
+        }
+
+        items = reinterpret_cast<const ItemRecord*>(data + header->itemsOffset);
+        dealType1 = reinterpret_cast<const std::uint32_t*>(data + header->dealType1Offset);
+        dealType2 = reinterpret_cast<const DealType2Record*>(data + header->dealType2Offset);
+        strings = reinterpret_cast<const char*>(data + header->stringsOffset);
+
+        // Validate every reference once so that lookups need no bounds checks
+        for (std::uint32_t i = 0; i < header->itemCount; ++i) {
+            const ItemRecord& record = items[i];
+            if (std::uint64_t(record.idOffset) + record.idLength > header->stringsSize ||
+                std::uint64_t(record.nameOffset) + record.nameLength > header->stringsSize ||
+                record.idLength == 0 || record.nameLength == 0) {
+                invalidImage("item string out of bounds");
+            }
+            if (i > 0 && !(getItem(i - 1).id < getItem(i).id)) {
+                invalidImage("items are not sorted by ID");
+            }
+        }
+        for (std::uint32_t i = 0; i < header->dealType1Count; ++i) {
+            if (dealType1[i] >= header->itemCount) {
+                invalidImage("Deal Type 1 references an unknown item");
+            }
+        }
+        for (std::uint32_t i = 0; i < header->dealType2Count; ++i) {
+            const DealType2Record& record = dealType2[i];
+            if (record.size == 0 || record.size > 3) {
+                invalidImage("Deal Type 2 set has an invalid size");
+            }
+            for (std::uint32_t j = 0; j < record.size; ++j) {
+                if (record.itemIndices[j] >= header->itemCount) {
+                    invalidImage("Deal Type 2 references an unknown item");
+                }
+            }
+        }
+    } catch (...) {
+#ifndef _WIN32
+        ::munmap(const_cast<unsigned char*>(data), size);
+#endif
+        throw;
+    }
+}
+
+BinaryCatalog::~BinaryCatalog() {
+#ifndef _WIN32
+    ::munmap(const_cast<unsigned char*>(data), size);
+#endif
+}
+
+std::uint32_t BinaryCatalog::getItemCount() const {
+    return header->itemCount;
+}
+
+BinaryCatalog::ItemView BinaryCatalog::getItem(std::uint32_t index) const {
+    const ItemRecord& record = items[index];
+    return ItemView{
+        std::string_view(strings + record.idOffset, record.idLength),
+        std::string_view(strings + record.nameOffset, record.nameLength),
+        Money::fromCents(record.priceCents)
+    };
+}
+
+std::uint32_t BinaryCatalog::findItem(std::string_view id) const {
+    std::uint32_t low = 0;
+    std::uint32_t high = header->itemCount;
+    while (low < high) {
+        std::uint32_t mid = low + (high - low) / 2;
+        const ItemRecord& record = items[mid];
+        int cmp = std::string_view(strings + record.idOffset, record.idLength).compare(id);
+        if (cmp == 0) {
+            return mid;
+        }
+        if (cmp < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return NO_ITEM;
+}
+
+std::uint32_t BinaryCatalog::getDealType1Count() const {
+    return header->dealType1Count;
+}
+
+const std::uint32_t* BinaryCatalog::getDealType1Items() const {
+    return dealType1;
+}
+
+std::uint32_t BinaryCatalog::getDealType2Count() const {
+    return header->dealType2Count;
+}
+
+BinaryCatalog::DealType2View BinaryCatalog::getDealType2(std::uint32_t index) const {
+    const DealType2Record& record = dealType2[index];
+    return DealType2View{record.itemIndices, record.size};
+}
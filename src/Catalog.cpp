@@ -0,0 +1,390 @@
+// Catalog.cpp
+#include "Catalog.h"
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+
+#include "CustomExceptions.h"
+
+namespace {
+
+// An integer field of a rule, with a default when it is absent
+int ruleInteger(const json& rule, const char* key, int defaultValue, int minimum, int maximum) {
+    if (!rule.contains(key)) {
+        if (defaultValue < minimum) {
+            throw InvalidDealException(std::string("Deal rule is missing '") + key + "'.");
+        }
+        return defaultValue;
+    }
+    if (!rule[key].is_number_integer()) {
+        throw InvalidDealException(std::string("Deal rule field '") + key + "' should be an integer.");
+    }
+    std::int64_t value = rule[key].get<std::int64_t>();
+    if (value < minimum || value > maximum) {
+        throw InvalidDealException(std::string("Deal rule field '") + key + "' should be between " +
+                                   std::to_string(minimum) + " and " + std::to_string(maximum) + ".");
+    }
+    return static_cast<int>(value);
+}
+
+// Name shown on the receipt for a rule without one; the classic shapes keep their classic names
+std::string defaultRuleName(const json& rule, const DealRule& compiled, std::size_t itemCount) {
+    std::string off = compiled.percentOff == 100 ? " free" : " at " + std::to_string(compiled.percentOff) + "% off";
+    switch (compiled.op) {
+    case DealRule::Op::MULTI_BUY:
+        if (compiled.groupUnits == 3 && compiled.discountedUnits == 1 && compiled.percentOff == 100) {
+            return "Deal Type 1";
+        }
+        if (rule["kind"] == "n_for_m") {
+            return std::to_string(compiled.groupUnits) + " for " +
+                   std::to_string(compiled.groupUnits - compiled.discountedUnits);
+        }
+        return "Buy " + std::to_string(compiled.groupUnits - compiled.discountedUnits) + " get " +
+               std::to_string(compiled.discountedUnits) + off;
+    case DealRule::Op::BUNDLE:
+        if (compiled.discountedUnits == 1 && compiled.percentOff == 100) {
+            return "Deal Type 2";
+        }
+        return "Buy " + std::to_string(itemCount) + " different, " + std::to_string(compiled.discountedUnits) +
+               " cheapest" + off;
+    case DealRule::Op::TIERED_UNITS:
+        return "Tiered bundle";
+    default:
+        return "Spend threshold";
+    }
+}
+
+} // namespace
+
+Catalog::Catalog() {}
+
+std::shared_ptr<const Catalog> Catalog::fromFile(const std::string& filename) {
+    // Compiled catalogs are mapped rather than parsed
+    if (BinaryCatalog::isBinaryCatalog(filename)) {
+        return fromBinary(std::make_shared<const BinaryCatalog>(filename));
+    }
+
+    // Attempt to open the file
+    std::ifstream file(filename);
+    if (!file) {
+        throw std::runtime_error("Cannot open data file: " + filename);
+    }
+
+    // Attempt to parse the JSON data
+    json data;
+    file >> data;
+    return fromJson(data);
+}
+
+std::shared_ptr<const Catalog> Catalog::fromJson(const json& data) {
+    auto catalog = std::make_shared<Catalog>();
+    catalog->loadItems(data);
+    catalog->loadDeals(data);
+    return catalog;
+}
+
+std::shared_ptr<const Catalog> Catalog::fromBinary(std::shared_ptr<const BinaryCatalog> image) {
+    auto catalog = std::make_shared<Catalog>();
+    const BinaryCatalog& binary = *image;
+    catalog->binary = std::move(image);
+
+    // The image was validated when it was compiled and mapped, and its records are
+    // already sorted by ID, so item positions and deal tables can be used as they are.
+    // Items refer to their ID and name in the mapping rather than copying them
+    catalog->items.reserve(binary.getItemCount());
+    for (std::uint32_t i = 0; i < binary.getItemCount(); ++i) {
+        BinaryCatalog::ItemView item = binary.getItem(i);
+        catalog->items.push_back(Item::view(item.id, item.name, item.price));
+    }
+    catalog->buildItemIndex();
+
+    // One Deal Type 1 rule per eligible item; the table is already sorted by item index
+    const std::uint32_t* dealType1Items = binary.getDealType1Items();
+    for (std::uint32_t i = 0; i < binary.getDealType1Count(); ++i) {
+        catalog->deals.push_back(
+            std::make_shared<RuleDeal>(std::vector<std::uint32_t>{dealType1Items[i]}, DealRule::dealType1()));
+    }
+
+    for (std::uint32_t i = 0; i < binary.getDealType2Count(); ++i) {
+        BinaryCatalog::DealType2View dealSet = binary.getDealType2(i);
+        catalog->deals.push_back(std::make_shared<RuleDeal>(
+            std::vector<std::uint32_t>(dealSet.itemIndices, dealSet.itemIndices + dealSet.size),
+            DealRule::dealType2()));
+    }
+    catalog->buildDealIndex();
+    return catalog;
+}
+
+std::uint32_t Catalog::getItemCount() const {
+    return static_cast<std::uint32_t>(items.size());
+}
+
+const Item& Catalog::getItem(std::uint32_t index) const {
+    return items[index];
+}
+
+const std::vector<Item>& Catalog::getItems() const {
+    return items;
+}
+
+std::uint32_t Catalog::findItem(std::string_view itemId) const {
+    std::uint64_t key = ItemIndex::pack(itemId);
+    if (key != 0) {
+        return itemIndex.find(key);
+    }
+
+    // IDs too long to pack are not in the hash index; fall back to a binary search
+    auto it = std::lower_bound(items.begin(), items.end(), itemId,
+                               [](const Item& item, std::string_view id) { return item.getId() < id; });
+    if (it != items.end() && it->getId() == itemId) {
+        return static_cast<std::uint32_t>(it - items.begin());
+    }
+    return ItemIndex::NOT_FOUND;
+}
+
+std::uint32_t Catalog::findScannedItem(std::string_view itemId) const {
+    // The ID is upper-cased while it is packed, to match the stored IDs
+    return itemIndex.find(ItemIndex::pack(itemId, true));
+}
+
+const std::vector<std::shared_ptr<const Deal>>& Catalog::getDeals() const {
+    return deals;
+}
+
+const std::vector<std::uint32_t>& Catalog::getDealsForItem(std::uint32_t itemIndex) const {
+    return dealsByItem[itemIndex];
+}
+
+void Catalog::loadItems(const json& data) {
+    if (!data.contains("items") || !data["items"].is_array()) {
+        throw InvalidItemException("Invalid or missing 'items' array in JSON data.");
+    }
+
+    // Items are collected by ID first so that positions follow ID order; the first occurrence of an ID wins
+    std::map<std::string, std::pair<std::string, Money>> itemsById;
+    for (const auto& itemData : data["items"]) {
+        if (!itemData.contains("id") || !itemData.contains("name") || !itemData.contains("price")) {
+            throw InvalidItemException("Item data missing required fields (id, name, price).");
+        }
+
+        std::string id = itemData["id"].get<std::string>();
+        std::string name = itemData["name"].get<std::string>();
+        double price = itemData["price"].get<double>();
+
+        if (id.empty() || name.empty() || price < 0.0) {
+            throw InvalidItemException("Invalid item data: ID, name cannot be empty, price cannot be negative.");
+        }
+
+        // Prices are converted to whole cents once, here, and kept exact from then on
+        itemsById.emplace(id, std::make_pair(name, Money::fromDouble(price)));
+    }
+
+    // IDs and names go into one string table, sized up front so the items' views stay valid
+    std::size_t length = 0;
+    for (const auto& entry : itemsById) {
+        length += entry.first.size() + entry.second.first.size();
+    }
+    strings.clear();
+    strings.reserve(length);
+    items.clear();
+    items.reserve(itemsById.size());
+    for (const auto& entry : itemsById) {
+        std::size_t start = strings.size();
+        strings += entry.first;
+        strings += entry.second.first;
+        std::string_view text(strings.data() + start, strings.size() - start);
+        items.push_back(Item::view(text.substr(0, entry.first.size()), text.substr(entry.first.size()),
+                                   entry.second.second));
+    }
+    buildItemIndex();
+}
+
+void Catalog::buildItemIndex() {
+    std::vector<std::uint64_t> keys;
+    keys.reserve(items.size());
+    for (const Item& item : items) {
+        keys.push_back(ItemIndex::pack(item.getId()));
+    }
+    itemIndex.build(keys);
+}
+
+void Catalog::loadDeals(const json& data) {
+    if (!data.contains("deals") || !data["deals"].is_object()) {
+        throw InvalidDealException("Invalid or missing 'deals' object in JSON data.");
+    }
+
+    const auto& dealsData = data["deals"];
+    deals.clear();
+
+    // Load Deal Type 1
+    if (dealsData.contains("deal_type_1")) {
+        if (!dealsData["deal_type_1"].is_array()) {
+            throw InvalidDealException("'deal_type_1' should be an array.");
+        }
+
+        std::vector<std::uint32_t> dealType1Items;
+        for (const auto& itemId : dealsData["deal_type_1"]) {
+            std::string id = itemId.get<std::string>();
+            std::uint32_t index = findItem(id);
+            if (index == ItemIndex::NOT_FOUND) {
+                throw InvalidDealException("Deal Type 1 contains unknown item ID: " + id);
+            }
+            dealType1Items.push_back(index);
+        }
+
+        // One Deal Type 1 rule per eligible item, in item order, so the solver can count sets per item
+        std::sort(dealType1Items.begin(), dealType1Items.end());
+        dealType1Items.erase(std::unique(dealType1Items.begin(), dealType1Items.end()), dealType1Items.end());
+        for (std::uint32_t index : dealType1Items) {
+            deals.push_back(std::make_shared<RuleDeal>(std::vector<std::uint32_t>{index}, DealRule::dealType1()));
+        }
+    }
+
+    // Load Deal Type 2
+    if (dealsData.contains("deal_type_2")) {
+        if (!dealsData["deal_type_2"].is_array()) {
+            throw InvalidDealException("'deal_type_2' should be an array.");
+        }
+
+        for (const auto& dealSet : dealsData["deal_type_2"]) {
+            if (!dealSet.is_array() || dealSet.size() != 3) {
+                throw InvalidDealException("Each 'deal_type_2' entry should be an array of exactly 3 item IDs.");
+            }
+
+            std::vector<std::uint32_t> dealType2Items;
+            for (const auto& itemId : dealSet) {
+                std::string id = itemId.get<std::string>();
+                std::uint32_t index = findItem(id);
+                if (index == ItemIndex::NOT_FOUND) {
+                    throw InvalidDealException("Deal Type 2 contains unknown item ID: " + id);
+                }
+                dealType2Items.push_back(index);
+            }
+            if (!dealType2Items.empty()) {
+                deals.push_back(std::make_shared<RuleDeal>(dealType2Items, DealRule::dealType2()));
+            }
+        }
+    }
+
+    // Load the declarative rules
+    if (dealsData.contains("rules")) {
+        if (!dealsData["rules"].is_array()) {
+            throw InvalidDealException("'rules' should be an array.");
+        }
+        for (const auto& rule : dealsData["rules"]) {
+            loadRule(rule);
+        }
+    }
+
+    buildDealIndex();
+}
+
+void Catalog::loadRule(const json& rule) {
+    if (!rule.is_object() || !rule.contains("kind") || !rule["kind"].is_string()) {
+        throw InvalidDealException("Each deal rule should be an object with a 'kind'.");
+    }
+    if (!rule.contains("items") || !rule["items"].is_array() || rule["items"].empty()) {
+        throw InvalidDealException("Each deal rule should have a non-empty 'items' array.");
+    }
+
+    std::vector<std::uint32_t> ruleItems;
+    for (const auto& itemId : rule["items"]) {
+        std::string id = itemId.get<std::string>();
+        std::uint32_t index = findItem(id);
+        if (index == ItemIndex::NOT_FOUND) {
+            throw InvalidDealException("Deal rule contains unknown item ID: " + id);
+        }
+        ruleItems.push_back(index);
+    }
+    std::sort(ruleItems.begin(), ruleItems.end());
+    ruleItems.erase(std::unique(ruleItems.begin(), ruleItems.end()), ruleItems.end());
+
+    // Compile the rule into its opcode and operands
+    std::string kind = rule["kind"].get<std::string>();
+    DealRule compiled;
+    if (kind == "multi_buy") {
+        int buy = ruleInteger(rule, "buy", 0, 1, 1000);
+        compiled.op = DealRule::Op::MULTI_BUY;
+        compiled.discountedUnits = ruleInteger(rule, "get", 0, 1, 1000);
+        compiled.groupUnits = buy + compiled.discountedUnits;
+        compiled.percentOff = ruleInteger(rule, "percent_off", 100, 1, 100);
+    } else if (kind == "n_for_m") {
+        int n = ruleInteger(rule, "n", 0, 2, 1000);
+        int m = ruleInteger(rule, "m", 0, 1, n - 1);
+        compiled.op = DealRule::Op::MULTI_BUY;
+        compiled.groupUnits = n;
+        compiled.discountedUnits = n - m;
+    } else if (kind == "bundle") {
+        if (ruleItems.size() < 2) {
+            throw InvalidDealException("A bundle rule needs at least 2 different items.");
+        }
+        compiled.op = DealRule::Op::BUNDLE;
+        compiled.discountedUnits =
+            ruleInteger(rule, "discounted", 1, 1, static_cast<int>(ruleItems.size()) - 1);
+        compiled.percentOff = ruleInteger(rule, "percent_off", 100, 1, 100);
+    } else if (kind == "tiered_bundle" || kind == "spend_threshold") {
+        bool units = kind == "tiered_bundle";
+        compiled.op = units ? DealRule::Op::TIERED_UNITS : DealRule::Op::TIERED_SPEND;
+        if (!rule.contains("tiers") || !rule["tiers"].is_array() || rule["tiers"].empty()) {
+            throw InvalidDealException("A " + kind + " rule should have a non-empty 'tiers' array.");
+        }
+        for (const auto& tier : rule["tiers"]) {
+            if (!tier.is_object()) {
+                throw InvalidDealException("Each tier should be an object.");
+            }
+            std::int64_t threshold;
+            if (units) {
+                threshold = ruleInteger(tier, "units", 0, 1, 1000000);
+            } else {
+                if (!tier.contains("spend") || !tier["spend"].is_number() || tier["spend"].get<double>() <= 0.0) {
+                    throw InvalidDealException("Each spend threshold tier should have a positive 'spend'.");
+                }
+                threshold = Money::fromDouble(tier["spend"].get<double>()).getCents();
+            }
+            compiled.tiers.push_back({threshold, ruleInteger(tier, "percent_off", 0, 1, 100)});
+        }
+        std::sort(compiled.tiers.begin(), compiled.tiers.end(),
+                  [](const DealRule::Tier& a, const DealRule::Tier& b) { return a.threshold < b.threshold; });
+        for (std::size_t i = 1; i < compiled.tiers.size(); ++i) {
+            if (compiled.tiers[i].threshold == compiled.tiers[i - 1].threshold) {
+                throw InvalidDealException("Tiers of a " + kind + " rule should have different thresholds.");
+            }
+        }
+    } else {
+        throw InvalidDealException("Unknown deal rule kind: " + kind);
+    }
+
+    if (rule.contains("name")) {
+        if (!rule["name"].is_string() || rule["name"].get<std::string>().empty()) {
+            throw InvalidDealException("Deal rule 'name' should be a non-empty string.");
+        }
+        compiled.name = rule["name"].get<std::string>();
+    } else {
+        compiled.name = defaultRuleName(rule, compiled, ruleItems.size());
+    }
+
+    // Multi-buys count units of each item on its own, so each item gets its own deal, like Deal Type 1
+    if (compiled.op == DealRule::Op::MULTI_BUY) {
+        for (std::uint32_t index : ruleItems) {
+            deals.push_back(std::make_shared<RuleDeal>(std::vector<std::uint32_t>{index}, compiled));
+        }
+    } else {
+        deals.push_back(std::make_shared<RuleDeal>(ruleItems, std::move(compiled)));
+    }
+}
+
+void Catalog::buildDealIndex() {
+    // Deals are applied by stage (single items, then sets, then thresholds); within a stage, load order is kept
+    std::stable_sort(deals.begin(), deals.end(),
+                     [](const std::shared_ptr<const Deal>& a, const std::shared_ptr<const Deal>& b) {
+                         return a->getStage() < b->getStage();
+                     });
+
+    dealsByItem.assign(items.size(), {});
+    for (std::uint32_t dealIndex = 0; dealIndex < deals.size(); ++dealIndex) {
+        for (std::uint32_t itemIndex : deals[dealIndex]->getEligibleItemIndices()) {
+            dealsByItem[itemIndex].push_back(dealIndex);
+        }
+    }
+}
@@ -0,0 +1,40 @@
+// CatalogStore.cpp
+#include "CatalogStore.h"
+#include <stdexcept>
+
+CatalogStore::CatalogStore()
+    : CatalogStore(std::make_shared<const Catalog>()) {}
+
+CatalogStore::CatalogStore(std::shared_ptr<const Catalog> catalog)
+    : catalog(std::move(catalog)), version(1) {
+    if (!this->catalog) {
+        throw std::invalid_argument("CatalogStore requires a catalog.");
+    }
+}
+
+std::shared_ptr<const Catalog> CatalogStore::current() const {
+    return std::atomic_load(&catalog);
+}
+
+std::uint64_t CatalogStore::getVersion() const {
+    return version.load(std::memory_order_acquire);
+}
+
+void CatalogStore::publish(std::shared_ptr<const Catalog> newCatalog) {
+    if (!newCatalog) {
+        throw std::invalid_argument("CatalogStore requires a catalog.");
+    }
+
+    // The previous catalog is released here, or later by the last basket still holding it
+    std::atomic_store(&catalog, std::move(newCatalog));
+    version.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void CatalogStore::reloadFromFile(const std::string& filename) {
+    // Build the replacement completely before publishing, so a failed load changes nothing
+    publish(Catalog::fromFile(filename));
+}
+
+std::future<void> CatalogStore::reloadFromFileAsync(const std::string& filename) {
+    return std::async(std::launch::async, [this, filename]() { reloadFromFile(filename); });
+}
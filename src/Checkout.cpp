@@ -7,41 +7,143 @@
 #include <iomanip>
 #include <algorithm> 
 #include <cctype> 
-#include <regex>  
 
 #include "CustomExceptions.h"
+#include "Metrics.h"
 
 using json = nlohmann::json;
 
-Checkout::Checkout() {}
+namespace {
+
+#ifdef SUPERMARKET_ENABLE_METRICS
+MetricsPhase dealPhase(const Deal& deal) {
+    switch (deal.getType()) {
+    case DealType::TYPE1:
+        return MetricsPhase::DEAL_TYPE1;
+    case DealType::TYPE2:
+        return MetricsPhase::DEAL_TYPE2;
+    default:
+        return MetricsPhase::DEAL_RULE;
+    }
+}
+#endif
+
+} // namespace
+
+Checkout::Checkout()
+    : catalog(std::make_shared<const Catalog>()), sink(std::make_shared<TextSink>(std::cout)) {}
 
-int Checkout::getCartQuantity(const std::string& itemId) const {
-    auto it = cart.find(itemId);
-    if (it != cart.end()) {
-        return it->second;
+Checkout::Checkout(std::shared_ptr<const Catalog> catalog)
+    : catalog(std::move(catalog)), sink(std::make_shared<TextSink>(std::cout)) {}
+
+Checkout::Checkout(std::shared_ptr<const CatalogStore> store)
+    : catalog(store->current()), catalogStore(std::move(store)), sink(std::make_shared<TextSink>(std::cout)) {}
+
+int Checkout::getCartQuantity(std::string_view itemId) const {
+    std::uint32_t index = catalog->findItem(itemId);
+    auto it = std::lower_bound(cart.begin(), cart.end(), index,
+                               [](const CartEntry& entry, std::uint32_t i) { return entry.itemIndex < i; });
+    if (it != cart.end() && it->itemIndex == index) {
+        return it->quantity;
     }
     return 0;
 }
 
-const std::vector<std::string>& Checkout::getAppliedDeals() const {
+std::vector<std::string> Checkout::getAppliedDeals() const {
+    std::vector<std::string> descriptions;
+    for (const DealApplication& application : appliedDeals) {
+        descriptions.insert(descriptions.end(), application.sets,
+                            application.deal->describe(application, catalog->getItems()));
+    }
+    return descriptions;
+}
+
+const std::vector<DealApplication>& Checkout::getDealApplications() const {
     return appliedDeals;
 }
 
-void Checkout::loadItemsAndDeals(const std::string& filename) {
-    try {
-        // Attempt to open the file
-        std::ifstream file(filename);
-        if (!file) {
-            throw std::runtime_error("Cannot open data file: " + filename);
+Checkout::Totals Checkout::getTotals() const {
+    return totals;
+}
+
+void Checkout::setSink(std::shared_ptr<OutputSink> newSink) {
+    sink = newSink ? std::move(newSink) : std::make_shared<NullSink>();
+}
+
+const std::shared_ptr<OutputSink>& Checkout::getSink() const {
+    return sink;
+}
+
+void Checkout::setJournal(std::shared_ptr<ScanJournal> newJournal, std::uint32_t lane) {
+    journal = std::move(newJournal);
+    journalLane = lane;
+}
+
+std::size_t Checkout::restoreCart(const std::vector<ScanJournal::CartLine>& lines) {
+    std::size_t restored = 0;
+    for (const ScanJournal::CartLine& line : lines) {
+        std::uint32_t index = catalog->findItem(line.itemId);
+        if (index == ItemIndex::NOT_FOUND || line.quantity <= 0) {
+            continue;
+        }
+        auto it = std::lower_bound(cart.begin(), cart.end(), index,
+                                   [](const CartEntry& entry, std::uint32_t i) { return entry.itemIndex < i; });
+        if (it == cart.end() || it->itemIndex != index) {
+            it = cart.insert(it, CartEntry{index, 0});
         }
+        it->quantity = std::min(line.quantity, 100);
+        repriceItem(index, it->quantity);
+        if (journal) {
+            journal->recordQuantity(journalLane, line.itemId, it->quantity);
+        }
+        ++restored;
+    }
+    return restored;
+}
+
+void Checkout::setDealStrategy(DealStrategy strategy, std::chrono::microseconds timeBudget) {
+    dealStrategy = strategy;
+    dealSolver = DealSolver(timeBudget);
+
+    // Drop any assignment made under the previous strategy
+    repriceBasket(false);
+}
+
+void Checkout::setCatalog(std::shared_ptr<const Catalog> newCatalog) {
+    catalog = std::move(newCatalog);
+    catalogStore.reset();
+
+    // Any cart from a previous catalog refers to stale indices
+    clearCart();
+}
+
+const std::shared_ptr<const Catalog>& Checkout::getCatalog() const {
+    return catalog;
+}
 
-        // Attempt to parse the JSON data
-        json data;
-        file >> data;
+void Checkout::newBasket() {
+    // Baskets are priced against one catalog from start to finish; a reload takes effect here
+    if (catalogStore) {
+        catalog = catalogStore->current();
+    }
+    clearCart();
+}
+
+void Checkout::clearCart() {
+    if (journal && !cart.empty()) {
+        journal->recordBasketClosed(journalLane);
+    }
+    cart.clear();
+    basket.clear();
+    arena->release();
+    appliedDeals.clear();
+    appliedDealIndices.clear();
+    totals = Totals();
+}
 
-        // Validate and load items and deals
-        loadItems(data);
-        loadDeals(data);
+void Checkout::loadItemsAndDeals(const std::string& filename) {
+    try {
+        setCatalog(Catalog::fromFile(filename));
     } catch (const json::parse_error& e) {
         std::cerr << "JSON Parsing Error: " << e.what() << std::endl;
         std::cerr << "Please check the JSON file for syntax errors.\n";
@@ -60,9 +162,7 @@ void Checkout::loadItemsAndDeals(const std::string& filename) {
 
 void Checkout::loadItemsAndDeals(const json& data) {
     try {
-        // Validate and load items and deals
-        loadItems(data);
-        loadDeals(data);
+        setCatalog(Catalog::fromJson(data));
     } catch (const json::parse_error& e) {
         std::cerr << "JSON Parsing Error: " << e.what() << std::endl;
         std::cerr << "Please check the JSON data for syntax errors.\n";
@@ -79,316 +179,403 @@ void Checkout::loadItemsAndDeals(const json& data) {
     }
 }
 
-void Checkout::loadItems(const json& data) {
-    if (!data.contains("items") || !data["items"].is_array()) {
-        throw InvalidItemException("Invalid or missing 'items' array in JSON data.");
-    }
+void Checkout::loadItemsAndDeals(std::shared_ptr<const BinaryCatalog> binary) {
+    setCatalog(Catalog::fromBinary(std::move(binary)));
+}
 
-    for (const auto& itemData : data["items"]) {
-        if (!itemData.contains("id") || !itemData.contains("name") || !itemData.contains("price")) {
-            throw InvalidItemException("Item data missing required fields (id, name, price).");
-        }
+void Checkout::scanItem(std::string_view input) {
+    SUPERMARKET_METRICS_TIME(MetricsPhase::SCAN_ITEM);
+    SUPERMARKET_METRICS_COUNT(MetricsCounter::SCANS);
+    ScanCommand command;
+    {
+        SUPERMARKET_METRICS_TIME(MetricsPhase::PARSE);
+        command = parseScanLine(input);
+    }
 
-        std::string id = itemData["id"].get<std::string>();
-        std::string name = itemData["name"].get<std::string>();
-        double price = itemData["price"].get<double>();
+    // Check for help command
+    if (command.type == ScanCommandType::HELP) {
+        displayHelp();
+        return;
+    }
 
-        if (id.empty() || name.empty() || price < 0.0) {
-            throw InvalidItemException("Invalid item data: ID, name cannot be empty, price cannot be negative.");
-        }
+    switch (command.error) {
+    case ScanParseError::NONE:
+        break;
+    case ScanParseError::QUANTITY_OUT_OF_RANGE:
+        SUPERMARKET_METRICS_COUNT(MetricsCounter::PARSE_ERRORS);
+        sink->scanMessage(ScanMessage{ScanEvent::QUANTITY_OUT_OF_RANGE});
+        return;
+    case ScanParseError::INVALID_FORMAT:
+        SUPERMARKET_METRICS_COUNT(MetricsCounter::PARSE_ERRORS);
+        sink->scanMessage(ScanMessage{ScanEvent::INVALID_FORMAT});
+        return;
+    }
 
-        availableItems.emplace(id, Item(id, name, price));
+    // Process the item
+    try {
+        processScannedItem(command.itemId, command.quantity);
+    } catch (const std::exception& e) {
+        ScanMessage message{ScanEvent::ERROR};
+        message.detail = e.what();
+        sink->scanMessage(message);
     }
 }
 
-void Checkout::loadDeals(const json& data) {
-    if (!data.contains("deals") || !data["deals"].is_object()) {
-        throw InvalidDealException("Invalid or missing 'deals' object in JSON data.");
+void Checkout::processScannedItem(std::string_view itemIdInput, int quantity) {
+    SUPERMARKET_METRICS_TIME(MetricsPhase::PROCESS_SCANNED_ITEM);
+    std::uint32_t index;
+    {
+        SUPERMARKET_METRICS_TIME(MetricsPhase::LOOKUP);
+        index = catalog->findScannedItem(itemIdInput);
+    }
+    if (index == ItemIndex::NOT_FOUND) {
+        SUPERMARKET_METRICS_COUNT(MetricsCounter::ITEMS_NOT_FOUND);
+        ScanMessage message{ScanEvent::ITEM_NOT_FOUND};
+        message.itemId = itemIdInput;
+        sink->scanMessage(message);
+        return;
     }
 
-    const auto& dealsData = data["deals"];
-
-    // Load Deal Type 1
-    if (dealsData.contains("deal_type_1")) {
-        if (!dealsData["deal_type_1"].is_array()) {
-            throw InvalidDealException("'deal_type_1' should be an array.");
-        }
+    const Item& item = catalog->getItem(index);
+    ScanMessage message{ScanEvent::QUANTITY_UPDATED};
+    message.itemIndex = index;
+    message.itemId = item.getId();
+    message.itemName = item.getName();
+
+    // The cart is kept sorted by item index, so deals see lines in the order they expect
+    auto it = std::lower_bound(cart.begin(), cart.end(), index,
+                               [](const CartEntry& entry, std::uint32_t i) { return entry.itemIndex < i; });
+    if (it == cart.end() || it->itemIndex != index) {
+        it = cart.insert(it, CartEntry{index, 0});
+    }
 
-        std::set<std::string> dealType1Items;
-        for (const auto& itemId : dealsData["deal_type_1"]) {
-            std::string id = itemId.get<std::string>();
-            if (availableItems.find(id) == availableItems.end()) {
-                throw InvalidDealException("Deal Type 1 contains unknown item ID: " + id);
-            }
-            dealType1Items.insert(id);
-        }
-        if (!dealType1Items.empty()) {
-            deals.push_back(std::make_shared<DealType1>(dealType1Items));
+    // Adjust the quantity in the cart, ensuring it is within bounds [0, 100]
+    long long newQuantity = static_cast<long long>(it->quantity) + quantity;
+    if (newQuantity > 100) {
+        newQuantity = 100;
+        SUPERMARKET_METRICS_COUNT(MetricsCounter::QUANTITY_CLAMPS);
+        message.event = ScanEvent::QUANTITY_CLAMPED;
+        message.quantity = 100;
+        sink->scanMessage(message);
+        message.event = ScanEvent::QUANTITY_UPDATED;
+    } else if (newQuantity < 0) {
+        it->quantity = 0;
+        repriceItem(index, 0);
+        if (journal) {
+            journal->recordQuantity(journalLane, item.getId(), 0);
         }
+        message.event = ScanEvent::ITEM_REMOVED;
+        sink->scanMessage(message);
+        return;
+    }
+    it->quantity = static_cast<int>(newQuantity);
+    repriceItem(index, it->quantity);
+    if (journal) {
+        journal->recordQuantity(journalLane, item.getId(), it->quantity);
     }
 
-    // Load Deal Type 2
-    if (dealsData.contains("deal_type_2")) {
-        if (!dealsData["deal_type_2"].is_array()) {
-            throw InvalidDealException("'deal_type_2' should be an array.");
-        }
+    message.quantity = it->quantity;
+    sink->scanMessage(message);
+}
 
-        for (const auto& dealSet : dealsData["deal_type_2"]) {
-            if (!dealSet.is_array() || dealSet.size() != 3) {
-                throw InvalidDealException("Each 'deal_type_2' entry should be an array of exactly 3 item IDs.");
-            }
+void Checkout::voidItem(std::string_view itemId) {
+    std::uint32_t index = catalog->findScannedItem(itemId);
+    if (index == ItemIndex::NOT_FOUND) {
+        ScanMessage message{ScanEvent::ITEM_NOT_FOUND};
+        message.itemId = itemId;
+        sink->scanMessage(message);
+        return;
+    }
 
-            std::set<std::string> dealType2Items;
-            for (const auto& itemId : dealSet) {
-                std::string id = itemId.get<std::string>();
-                if (availableItems.find(id) == availableItems.end()) {
-                    throw InvalidDealException("Deal Type 2 contains unknown item ID: " + id);
-                }
-                dealType2Items.insert(id);
-            }
-            if (!dealType2Items.empty()) {
-                deals.push_back(std::make_shared<DealType2>(dealType2Items));
-            }
+    auto it = std::lower_bound(cart.begin(), cart.end(), index,
+                               [](const CartEntry& entry, std::uint32_t i) { return entry.itemIndex < i; });
+    if (it != cart.end() && it->itemIndex == index) {
+        it->quantity = 0;
+        repriceItem(index, 0);
+        if (journal) {
+            journal->recordQuantity(journalLane, catalog->getItem(index).getId(), 0);
         }
     }
-}
 
-void Checkout::scanItem(const std::string& input) {
-    // Trim whitespace
-    std::string trimmedInput = input;
-    trimmedInput.erase(0, trimmedInput.find_first_not_of(" \t\n\r\f\v"));
-    trimmedInput.erase(trimmedInput.find_last_not_of(" \t\n\r\f\v") + 1);
+    const Item& item = catalog->getItem(index);
+    ScanMessage message{ScanEvent::ITEM_REMOVED};
+    message.itemIndex = index;
+    message.itemId = item.getId();
+    message.itemName = item.getName();
+    sink->scanMessage(message);
+}
 
-    // Check for help command
-    if (trimmedInput == "help") {
-        displayHelp();
+void Checkout::applyDeals() {
+    SUPERMARKET_METRICS_TIME(MetricsPhase::APPLY_DEALS);
+    // Greedy pricing is kept up to date on every scan; only the optimal assignment is left to do
+    if (dealStrategy != DealStrategy::OPTIMAL) {
         return;
     }
+    try {
+        repriceBasket(true);
+    } catch (const std::exception& e) {
+        std::cerr << "Error applying deals: " << e.what() << "\n";
+    }
+}
 
-    // Updated regular expression to match alphanumeric IDs with max 5 characters
-    std::regex pattern(R"(^([A-Za-z0-9]{1,5})\s*(-?\d+)?$)", std::regex_constants::icase);
-    std::smatch matches;
-
-    if (std::regex_match(trimmedInput, matches, pattern)) {
-        std::string itemId = matches[1];
-        int quantity = 1; // Default quantity
-
-        // Check if quantity is provided
-        if (matches[2].matched) {
-            try {
-                quantity = std::stoi(matches[2]);
-            } catch (const std::invalid_argument& e) {
-                std::cout << "Invalid quantity format. Please enter a valid integer.\n";
-                return;
-            } catch (const std::out_of_range& e) {
-                std::cout << "Quantity is out of acceptable range.\n";
-                return;
+void Checkout::repriceItem(std::uint32_t itemIndex, int quantity) {
+    std::size_t line = basket.find(itemIndex);
+    bool present = line != PricedBasket::NPOS;
+    int oldQuantity = present ? basket.getQuantity(line) : 0;
+    if (quantity == oldQuantity) {
+        return;
+    }
+    const std::vector<std::shared_ptr<const Deal>>& deals = catalog->getDeals();
+
+    // Find every deal whose result can change: the deals on this item and, transitively, the
+    // deals on any other line those deals share. Deals outside this group touch none of its
+    // lines, so re-applying the group in deal order gives the same result as pricing the whole
+    // basket from scratch.
+    componentItems.assign(1, itemIndex);
+    const std::vector<std::uint32_t>& itemDeals = catalog->getDealsForItem(itemIndex);
+    componentDeals.assign(itemDeals.begin(), itemDeals.end());
+    for (std::size_t d = 0; d < componentDeals.size(); ++d) {
+        const Deal& deal = *deals[componentDeals[d]];
+
+        // A set with another item missing applies neither before nor after this scan
+        if (deal.needsEveryItem() &&
+            !basket.getPresence().containsAll(deal.getEligibleWords(), itemIndex)) {
+            continue;
+        }
+        for (std::uint32_t other : deal.getEligibleItemIndices()) {
+            auto visited = std::lower_bound(componentItems.begin(), componentItems.end(), other);
+            if ((visited != componentItems.end() && *visited == other) || !basket.contains(other)) {
+                continue;
             }
+            componentItems.insert(visited, other);
+            const std::vector<std::uint32_t>& otherDeals = catalog->getDealsForItem(other);
+            componentDeals.insert(componentDeals.end(), otherDeals.begin(), otherDeals.end());
         }
-
-        // Process the item
-        try {
-            processScannedItem(itemId, quantity);
-        } catch (const std::exception& e) {
-            std::cout << "Error processing item: " << e.what() << "\n";
+    }
+    std::sort(componentDeals.begin(), componentDeals.end());
+    componentDeals.erase(std::unique(componentDeals.begin(), componentDeals.end()), componentDeals.end());
+
+    // Take the group's lines and deals out of the totals
+    for (std::uint32_t index : componentItems) {
+        std::size_t componentLine = basket.find(index);
+        if (componentLine != PricedBasket::NPOS) {
+            totals.total -= basket.getFinalPrice(componentLine);
         }
-    } else {
-        std::cout << "Invalid input format. Please enter the item ID and quantity (e.g., 'A1 3').\n";
-        std::cout << "Type 'help' for a list of available commands and items.\n";
     }
-}
-
-void Checkout::processScannedItem(const std::string& itemIdInput, int quantity) {
-    try {
-        std::string itemId = itemIdInput;
-        // Convert itemId to uppercase to match the stored IDs
-        std::transform(itemId.begin(), itemId.end(), itemId.begin(), ::toupper);
-
-        auto it = availableItems.find(itemId);
-        if (it != availableItems.end()) {
-            // Adjust the quantity in the cart
-            cart[itemId] += quantity;
-
-            // Ensure quantity is within bounds [0, 100]
-            if (cart[itemId] > 100) {
-                std::cout << "Total quantity for item ID '" << itemId << "' cannot exceed 100. Setting quantity to 100.\n";
-                cart[itemId] = 100;
-            } else if (cart[itemId] < 0) {
-                cart[itemId] = 0;
-                std::cout << "No items of ID '" << itemId << "' left in your cart.\n";
-                return;
-            }
-
-            std::cout << "Updated " << it->second.getName() << " quantity to " << cart[itemId] << ".\n";
-        } else {
-            throw std::runtime_error("Item ID '" + itemId + "' not found.");
+    std::size_t kept = 0;
+    for (std::size_t a = 0; a < appliedDeals.size(); ++a) {
+        if (std::binary_search(componentDeals.begin(), componentDeals.end(), appliedDealIndices[a])) {
+            totals.deals -= appliedDeals[a].sets;
+            continue;
+        }
+        appliedDeals[kept] = appliedDeals[a];
+        appliedDealIndices[kept] = appliedDealIndices[a];
+        ++kept;
+    }
+    appliedDeals.resize(kept);
+    appliedDealIndices.resize(kept);
+
+    // Update the scanned line and clear any deals from the group's other lines
+    Money price = catalog->getItem(itemIndex).getPrice();
+    totals.units += quantity - oldQuantity;
+    totals.preDiscount += price * (quantity - oldQuantity);
+    if (quantity == 0) {
+        totals.lines -= 1;
+    } else if (!present) {
+        totals.lines += 1;
+    }
+    basket.setLine(itemIndex, quantity, price);
+    for (std::uint32_t index : componentItems) {
+        std::size_t componentLine = basket.find(index);
+        if (index != itemIndex && componentLine != PricedBasket::NPOS) {
+            basket.clearDeals(componentLine);
         }
-    } catch (const std::exception& e) {
-        std::cout << "Error: " << e.what() << "\n";
-        std::cout << "Type 'help' for a list of available items.\n";
     }
-}
 
-void Checkout::preparePurchasedItems() {
-    purchasedItems.clear();
-    for (const auto& pair : cart) {
-        const std::string& itemId = pair.first;
-        int quantity = pair.second;
-
-        auto it = availableItems.find(itemId);
-        if (it != availableItems.end()) {
-            Item* item = &it->second;
-            for (int i = 0; i < quantity; ++i) {
-                purchasedItems.emplace_back(item);
-            }
+    // Re-apply the group's deals in deal order, which is stage order
+    newDeals.clear();
+    newDealIndices.clear();
+    for (std::uint32_t dealIndex : componentDeals) {
+        SUPERMARKET_METRICS_TIME(dealPhase(*deals[dealIndex]));
+        deals[dealIndex]->applyDeal(basket, newDeals);
+        newDealIndices.resize(newDeals.size(), dealIndex);
+    }
+    for (std::uint32_t index : componentItems) {
+        std::size_t componentLine = basket.find(index);
+        if (componentLine != PricedBasket::NPOS) {
+            totals.total += basket.getFinalPrice(componentLine);
+        }
+    }
+    for (const DealApplication& application : newDeals) {
+        totals.deals += application.sets;
+    }
+    totals.savings = totals.preDiscount - totals.total;
+
+    // Merge the group's applications back in deal order
+    if (!newDeals.empty()) {
+        std::size_t oldCount = appliedDeals.size();
+        appliedDeals.insert(appliedDeals.end(), newDeals.begin(), newDeals.end());
+        appliedDealIndices.insert(appliedDealIndices.end(), newDealIndices.begin(), newDealIndices.end());
+        if (oldCount > 0 && newDealIndices.front() < appliedDealIndices[oldCount - 1]) {
+            mergeDealRuns(oldCount);
         }
     }
 }
 
-void Checkout::applyDeals() {
-    try {
-        preparePurchasedItems();
+void Checkout::mergeDealRuns(std::size_t middle) {
+    // Both runs are in deal order and hold different deals, so a stable merge by deal index suffices
+    newDeals.clear();
+    newDealIndices.clear();
+    std::size_t a = 0;
+    std::size_t b = middle;
+    while (a < middle || b < appliedDeals.size()) {
+        std::size_t next = (b == appliedDeals.size() || (a < middle && appliedDealIndices[a] < appliedDealIndices[b]))
+                               ? a++
+                               : b++;
+        newDeals.push_back(appliedDeals[next]);
+        newDealIndices.push_back(appliedDealIndices[next]);
+    }
+    appliedDeals.swap(newDeals);
+    appliedDealIndices.swap(newDealIndices);
+}
 
-        // Apply Deal Type 1 first
-        for (const auto& deal : deals) {
-            auto* dealType1 = dynamic_cast<DealType1*>(deal.get());
-            if (dealType1) {
-                dealType1->applyDeal(purchasedItems, appliedDeals);
-            }
+void Checkout::repriceBasket(bool optimal) {
+    // Start every line from scratch
+    basket.clearDeals();
+    appliedDeals.clear();
+    appliedDealIndices.clear();
+
+    // Only deals that involve at least one item in the cart can apply
+    candidateDeals.clear();
+    for (std::uint32_t itemIndex : basket.getItemIndices()) {
+        const std::vector<std::uint32_t>& itemDeals = catalog->getDealsForItem(itemIndex);
+        candidateDeals.insert(candidateDeals.end(), itemDeals.begin(), itemDeals.end());
+    }
+    std::sort(candidateDeals.begin(), candidateDeals.end());
+    candidateDeals.erase(std::unique(candidateDeals.begin(), candidateDeals.end()), candidateDeals.end());
+
+    // Drop the sets with an item missing; each check is an AND of the cart's presence bits
+    const std::vector<std::shared_ptr<const Deal>>& deals = catalog->getDeals();
+    candidateDeals.erase(std::remove_if(candidateDeals.begin(), candidateDeals.end(),
+                                        [&](std::uint32_t dealIndex) {
+                                            return !deals[dealIndex]->canApply(basket.getPresence());
+                                        }),
+                         candidateDeals.end());
+
+    // Deals are ordered by stage, so ascending deal order is application order. The solver only
+    // models the two classic deal types; a basket any other rule applies to is priced greedily.
+    if (optimal && std::none_of(candidateDeals.begin(), candidateDeals.end(), [&](std::uint32_t dealIndex) {
+            return deals[dealIndex]->getType() == DealType::RULE;
+        })) {
+        solverDeals.clear();
+        for (std::uint32_t dealIndex : candidateDeals) {
+            solverDeals.push_back(deals[dealIndex].get());
         }
 
-        // Then apply Deal Type 2
-        for (const auto& deal : deals) {
-            auto* dealType2 = dynamic_cast<DealType2*>(deal.get());
-            if (dealType2) {
-                dealType2->applyDeal(purchasedItems, appliedDeals);
-            }
+        // The solver's search state lives in the basket arena; nothing from an earlier solve of
+        // this basket is still alive, so its memory is reused rather than piled up
+        arena->release();
+        DealSolver::Result plan = dealSolver.solve(basket, solverDeals, arena.get());
+        for (std::size_t i = 0; i < candidateDeals.size(); ++i) {
+            SUPERMARKET_METRICS_TIME(dealPhase(*deals[candidateDeals[i]]));
+            deals[candidateDeals[i]]->applyDeal(basket, appliedDeals, plan.sets[i]);
+            appliedDealIndices.resize(appliedDeals.size(), candidateDeals[i]);
+        }
+    } else {
+        for (std::uint32_t dealIndex : candidateDeals) {
+            SUPERMARKET_METRICS_TIME(dealPhase(*deals[dealIndex]));
+            deals[dealIndex]->applyDeal(basket, appliedDeals);
+            appliedDealIndices.resize(appliedDeals.size(), dealIndex);
         }
-    } catch (const std::exception& e) {
-        std::cerr << "Error applying deals: " << e.what() << "\n";
     }
-}
 
-std::string Checkout::getItemIdByName(const std::string& itemName) const {
-    for (const auto& pair : availableItems) {
-        if (pair.second.getName() == itemName) {
-            return pair.first;
-        }
+    totals.total = basket.getFinalTotal();
+    totals.deals = 0;
+    for (const DealApplication& application : appliedDeals) {
+        totals.deals += application.sets;
     }
-    return "";
+    totals.savings = totals.preDiscount - totals.total;
 }
 
 void Checkout::displayHelp() const {
-    std::cout << "\n--- Help ---\n";
-    std::cout << "Available commands:\n";
-    std::cout << " - Enter the item ID followed by the quantity (e.g., 'A1 3').\n";
-    std::cout << " - To add a single item, simply enter the item ID (e.g., 'A1').\n";
-    std::cout << " - To remove items, enter a negative quantity (e.g., 'A1 -2').\n";
-    std::cout << " - To clear all items of a type, enter the item ID followed by '0' (e.g., 'A1 0').\n";
-    std::cout << " - Type 'done' when you have finished scanning items.\n";
-    std::cout << " - Type 'help' to display this help message.\n";
-
-    std::cout << "\nAvailable items:\n";
-    std::cout << std::left << std::setw(10) << "Item ID"
+    if (!sink->wantsText()) {
+        return;
+    }
+    std::ostringstream out;
+
+    out << "\n--- Help ---\n";
+    out << "Available commands:\n";
+    out << " - Enter the item ID followed by the quantity (e.g., 'A1 3').\n";
+    out << " - To add a single item, simply enter the item ID (e.g., 'A1').\n";
+    out << " - To remove items, enter a negative quantity (e.g., 'A1 -2').\n";
+    out << " - To clear all items of a type, enter the item ID followed by '0' (e.g., 'A1 0').\n";
+    out << " - Type 'done' when you have finished scanning items.\n";
+    out << " - Type 'help' to display this help message.\n";
+
+    out << "\nAvailable items:\n";
+    out << std::left << std::setw(10) << "Item ID"
               << std::left << std::setw(25) << "Item Name"
               << std::left << std::setw(10) << "Price\n";
-    std::cout << "-------------------------------------------------\n";
-    for (const auto& pair : availableItems) {
-        const Item& item = pair.second;
-        std::cout << std::left << std::setw(10) << item.getId()
+    out << "-------------------------------------------------\n";
+    for (const Item& item : catalog->getItems()) {
+        out << std::left << std::setw(10) << item.getId()
                   << std::left << std::setw(25) << item.getName()
-                  << "$" << std::fixed << std::setprecision(2) << item.getPrice() << "\n";
+                  << "$" << item.getPrice() << "\n";
     }
-    std::cout << "-------------------------------------------------\n";
+    out << "-------------------------------------------------\n";
+    sink->text(out.str());
 }
 
 void Checkout::generateReceipt() const {
-    std::cout << "\n--- Customer Receipt ---\n";
-    std::cout << std::fixed << std::setprecision(2);
-
-    double totalPreDiscount = 0.0;
-    double totalSavings = 0.0;
-    double total = 0.0;
-
-    // Summarize items and calculate totals
-    std::map<std::string, std::pair<int, double>> itemSummary;
-    std::map<std::string, double> itemDiscounts; // To track discounts per item
-    std::map<std::string, DealType> itemDealTypes; // To track deal types per item
-
-    for (const PurchasedItem& purchasedItem : purchasedItems) {
-        Item* item = purchasedItem.getItem();
-        std::string itemName = item->getName();
-        double finalPrice = purchasedItem.getFinalPrice();
-        double originalPrice = item->getPrice();
-
-        itemSummary[itemName].first += 1;
-        itemSummary[itemName].second += finalPrice;
-
-        totalPreDiscount += originalPrice;
-        total += finalPrice;
-
-        // Calculate savings per item
-        double discount = originalPrice - finalPrice;
-        if (discount > 0) {
-            itemDiscounts[itemName] += discount;
-            totalSavings += discount;
-            itemDealTypes[itemName] = purchasedItem.getDealType();
-        }
+    if (!sink->wantsText()) {
+        return;
     }
+    SUPERMARKET_METRICS_TIME(MetricsPhase::GENERATE_RECEIPT);
+    std::string text;
+    ReceiptWriter::writeText(getReceipt(), text);
+    sink->text(text);
+}
 
-    // Determine the width for alignment
-    const int ITEM_NAME_WIDTH = 30;
-    const int PRICE_WIDTH = 10;
-
-    // Display items with discounts
-    for (const auto& entry : itemSummary) {
-        const std::string& itemName = entry.first;
-        int quantity = entry.second.first;
-        double lineTotal = entry.second.second;
-        std::string itemId = getItemIdByName(itemName);
-        double originalPrice = availableItems.at(itemId).getPrice();
-        double lineOriginalTotal = quantity * originalPrice;
-
-        // Item line: Left-aligned item name and quantity, right-aligned original total price
-        std::cout << std::left << std::setw(ITEM_NAME_WIDTH) << (itemName + " x" + std::to_string(quantity))
-                  << " $" << std::right << std::setw(PRICE_WIDTH) << lineOriginalTotal << "\n";
-
-        // If there is a discount for this item, display it
-        if (itemDiscounts.count(itemName)) {
-            double discount = itemDiscounts[itemName];
-            DealType dealType = itemDealTypes[itemName];
-            std::ostringstream discountOss;
-            discountOss << "Discount ("; 
-            if (dealType == DealType::TYPE1) {
-                discountOss << "Type 1";
-            } else if (dealType == DealType::TYPE2) {
-                discountOss << "Type 2";
-            } else {
-                discountOss << "N/A";
-            }
-            discountOss << ")";
-
-            std::cout << std::left << std::setw(ITEM_NAME_WIDTH) << ("  " + discountOss.str())
-                      << "-$" << std::right << std::setw(PRICE_WIDTH) << discount << "\n";
-        }
-    }
+Receipt Checkout::getReceipt() const {
+    Receipt receipt;
+    buildReceipt(receipt);
+    return receipt;
+}
 
-    // Display applied deals (optional)
-    if (!appliedDeals.empty()) {
-        std::cout << "\n--- Discounts Applied ---\n";
-        for (const std::string& deal : appliedDeals) {
-            std::cout << deal << "\n";
+void Checkout::buildReceipt(Receipt& receipt) const {
+    SUPERMARKET_METRICS_TIME(MetricsPhase::BUILD_RECEIPT);
+    SUPERMARKET_METRICS_COUNT(MetricsCounter::RECEIPTS);
+    receipt.catalog = catalog;
+    receipt.lines.clear();
+    receipt.deals.assign(appliedDeals.begin(), appliedDeals.end());
+
+    // Each purchased line is already one item, so it maps straight to a receipt line
+    receipt.lines.reserve(basket.size());
+    for (std::size_t b = 0; b < basket.size(); ++b) {
+        ReceiptLine line;
+        line.itemIndex = basket.getItemIndex(b);
+        line.quantity = basket.getQuantity(b);
+        line.unitPrice = basket.getUnitPrice(b);
+        line.preDiscount = line.unitPrice * line.quantity;
+        line.discount = basket.getDiscount(b);
+        line.total = line.preDiscount - line.discount;
+        if (line.discount > Money()) {
+            line.dealType = basket.getDealType(b);
+            line.deal = basket.getDeal(b);
         }
+        receipt.lines.push_back(line);
     }
 
-    // Display totals
-    std::cout << "\n";
-    std::cout << std::left << std::setw(ITEM_NAME_WIDTH) << "Total before discounts"
-              << " $" << std::right << std::setw(PRICE_WIDTH) << totalPreDiscount << "\n";
-    std::cout << std::left << std::setw(ITEM_NAME_WIDTH) << "Total savings"
-              << "-$" << std::right << std::setw(PRICE_WIDTH) << totalSavings << "\n";
-    std::cout << std::left << std::setw(ITEM_NAME_WIDTH) << "Total after discounts"
-              << " $" << std::right << std::setw(PRICE_WIDTH) << total << "\n";
-
-    std::cout << "Thank you for shopping with us!\n";
-}
\ No newline at end of file
+    // The basket's column sums give the receipt totals
+    receipt.units = basket.getUnits();
+    receipt.preDiscount = basket.getPreDiscountTotal();
+    receipt.savings = basket.getDiscountTotal();
+    receipt.total = basket.getFinalTotal();
+
+    // List by item name; items sharing a name keep item ID order
+    const std::vector<Item>& items = catalog->getItems();
+    std::sort(receipt.lines.begin(), receipt.lines.end(), [&items](const ReceiptLine& a, const ReceiptLine& b) {
+        int order = items[a.itemIndex].getName().compare(items[b.itemIndex].getName());
+        return order != 0 ? order < 0 : a.itemIndex < b.itemIndex;
+    });
+}
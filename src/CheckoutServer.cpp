@@ -0,0 +1,640 @@
+// CheckoutServer.cpp
+#include "CheckoutServer.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include "Checkout.h"
+#include "Metrics.h"
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(CheckoutServer::TotalsRecord) == 40, "CheckoutServer::TotalsRecord must be 40 bytes");
+
+namespace {
+
+/**
+ * @brief Sink that appends scan messages to a response as BinarySink records.
+ */
+class ResponseSink : public OutputSink {
+public:
+    std::string* response = nullptr; ///< Response being built, or null to drop messages.
+
+    void scanMessage(const ScanMessage& message) override {
+        if (response == nullptr) {
+            return;
+        }
+        BinarySink::Record record = {};
+        record.event = static_cast<std::uint8_t>(message.event);
+        record.itemIndex = message.itemIndex;
+        record.quantity = message.quantity;
+        char bytes[sizeof(record)];
+        std::memcpy(bytes, &record, sizeof(record));
+        response->append(bytes, sizeof(record));
+    }
+
+    void text(std::string_view) override {}
+
+    bool wantsText() const override {
+        return false;
+    }
+};
+
+} // namespace
+
+/**
+ * @struct CheckoutServer::Connection
+ * @brief One lane: its socket, session and unsent bytes.
+ */
+struct CheckoutServer::Connection {
+    explicit Connection(int fd, std::shared_ptr<const CatalogStore> store)
+        : fd(fd), session(std::move(store)), sink(std::make_shared<ResponseSink>()) {
+        session.setSink(sink);
+    }
+
+    int fd;                              ///< Connected socket.
+    Checkout session;                    ///< The lane's checkout session.
+    std::shared_ptr<ResponseSink> sink;  ///< Collects scan messages into the current response.
+    Receipt receipt;                     ///< Reused for every receipt of the lane.
+    std::uint64_t receipts = 0;          ///< Number of receipts issued, used to number them.
+    std::string input;                   ///< Bytes read but not yet handled.
+    std::string output;                  ///< Response bytes not yet written.
+    std::size_t written = 0;             ///< Bytes of output already written.
+    std::size_t uncommitted = 0;         ///< Offset in output of the first response waiting for a journal commit.
+    std::uint32_t watchedEvents = 0;     ///< epoll events the event loop waits for on the socket.
+    bool attached = false;               ///< Whether the connection has named its lane.
+    std::uint32_t lane = 0;              ///< The lane, once attached.
+};
+
+#ifdef __linux__
+
+namespace {
+
+[[noreturn]] void throwSystemError(const std::string& what) {
+    throw std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+void appendTotals(const Checkout::Totals& totals, std::string& output) {
+    CheckoutServer::TotalsRecord record = {};
+    record.lines = totals.lines;
+    record.units = totals.units;
+    record.preDiscount = totals.preDiscount.getCents();
+    record.savings = totals.savings.getCents();
+    record.total = totals.total.getCents();
+    record.deals = totals.deals;
+    char bytes[sizeof(record)];
+    std::memcpy(bytes, &record, sizeof(record));
+    output.append(bytes, sizeof(record));
+}
+
+// Whether the input starts with a request that can be answered, or rejected, without reading more
+bool hasRequest(const std::string& input) {
+    std::uint32_t length;
+    if (input.size() < sizeof(length)) {
+        return false;
+    }
+    std::memcpy(&length, input.data(), sizeof(length));
+    return length == 0 || length > CheckoutServer::MAX_FRAME || input.size() - sizeof(length) >= length;
+}
+
+} // namespace
+
+CheckoutServer::CheckoutServer(std::shared_ptr<CatalogStore> store, const std::string& socketPath)
+    : store(std::move(store)), socketPath(socketPath) {
+    if (!this->store) {
+        throw std::invalid_argument("CheckoutServer requires a catalog store.");
+    }
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Invalid socket path: " + socketPath);
+    }
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) {
+        throwSystemError("Cannot create socket");
+    }
+    ::unlink(socketPath.c_str());
+    if (::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        ::listen(listenFd, SOMAXCONN) < 0) {
+        int error = errno;
+        ::close(listenFd);
+        errno = error;
+        throwSystemError("Cannot listen on " + socketPath);
+    }
+    startLoop();
+}
+
+CheckoutServer::CheckoutServer(std::shared_ptr<CatalogStore> store, std::uint16_t port)
+    : store(std::move(store)) {
+    if (!this->store) {
+        throw std::invalid_argument("CheckoutServer requires a catalog store.");
+    }
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    listenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) {
+        throwSystemError("Cannot create socket");
+    }
+    int reuse = 1;
+    ::setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    socklen_t length = sizeof(address);
+    if (::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        ::listen(listenFd, SOMAXCONN) < 0 ||
+        ::getsockname(listenFd, reinterpret_cast<sockaddr*>(&address), &length) < 0) {
+        int error = errno;
+        ::close(listenFd);
+        errno = error;
+        throwSystemError("Cannot listen on port " + std::to_string(port));
+    }
+    this->port = ntohs(address.sin_port);
+    startLoop();
+}
+
+CheckoutServer::~CheckoutServer() {
+    for (auto& entry : connections) {
+        ::close(entry.first);
+    }
+    ::close(listenFd);
+    ::close(epollFd);
+    ::close(stopFd);
+    ::close(reloadFd);
+    if (!socketPath.empty()) {
+        ::unlink(socketPath.c_str());
+    }
+}
+
+void CheckoutServer::startLoop() {
+    epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    stopFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    reloadFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || stopFd < 0 || reloadFd < 0) {
+        int error = errno;
+        ::close(listenFd);
+        ::close(epollFd);
+        ::close(stopFd);
+        ::close(reloadFd);
+        errno = error;
+        throwSystemError("Cannot create event loop");
+    }
+
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = listenFd;
+    ::epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+    event.data.fd = stopFd;
+    ::epoll_ctl(epollFd, EPOLL_CTL_ADD, stopFd, &event);
+    event.data.fd = reloadFd;
+    ::epoll_ctl(epollFd, EPOLL_CTL_ADD, reloadFd, &event);
+}
+
+std::uint16_t CheckoutServer::getPort() const {
+    return port;
+}
+
+void CheckoutServer::setJournal(std::shared_ptr<ScanJournal> newJournal) {
+    journal = std::move(newJournal);
+}
+
+void CheckoutServer::setCatalogPath(const std::string& path) {
+    catalogPath = path;
+}
+
+void CheckoutServer::stop() {
+    std::uint64_t one = 1;
+    ssize_t result = ::write(stopFd, &one, sizeof(one));
+    (void)result;
+}
+
+void CheckoutServer::reloadCatalog() {
+    std::uint64_t one = 1;
+    ssize_t result = ::write(reloadFd, &one, sizeof(one));
+    (void)result;
+}
+
+void CheckoutServer::startReload() {
+    if (catalogPath.empty()) {
+        return;
+    }
+    if (reloading.valid()) {
+        reloadQueued = true;
+        return;
+    }
+    reloading = store->reloadFromFileAsync(catalogPath);
+}
+
+void CheckoutServer::finishReload() {
+    try {
+        reloading.get();
+
+        // Lanes between baskets move to the new catalog now rather than after their next receipt
+        for (auto& entry : connections) {
+            if (entry.second->session.getTotals().lines == 0) {
+                entry.second->session.newBasket();
+            }
+        }
+        std::cerr << "Reloaded catalog " << store->getVersion() << " from " << catalogPath << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Catalog reload from " << catalogPath << " failed: " << e.what() << "\n";
+    }
+
+    // Requests that came in meanwhile may have been for a newer file than the one just loaded
+    if (reloadQueued) {
+        reloadQueued = false;
+        startReload();
+    }
+}
+
+void CheckoutServer::run() {
+    epoll_event events[64];
+    while (true) {
+        // A running reload is polled for completion between events, so the loop never blocks on it
+        int timeout = reloading.valid() ? 50 : -1;
+        int count = ::epoll_wait(epollFd, events, 64, timeout);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throwSystemError("Event loop failed");
+        }
+        if (reloading.valid() && reloading.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            finishReload();
+        }
+
+        for (int i = 0; i < count; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == stopFd) {
+                std::uint64_t value;
+                ssize_t result = ::read(stopFd, &value, sizeof(value));
+                (void)result;
+                return;
+            }
+            if (fd == reloadFd) {
+                std::uint64_t value;
+                ssize_t result = ::read(reloadFd, &value, sizeof(value));
+                (void)result;
+                startReload();
+                continue;
+            }
+            if (fd == listenFd) {
+                acceptConnections();
+                continue;
+            }
+
+            auto it = connections.find(fd);
+            if (it == connections.end()) {
+                continue;
+            }
+            Connection& connection = *it->second;
+            bool open = (events[i].events & (EPOLLERR | EPOLLHUP)) == 0 || (events[i].events & EPOLLIN) != 0;
+
+            // Responses backed up from earlier passes are already committed; sending them first
+            // makes room to answer requests that were held back
+            if (open && (events[i].events & EPOLLOUT) != 0) {
+                open = writeResponses(connection);
+            }
+            std::size_t responsesStart = connection.output.size();
+            if (open && (events[i].events & EPOLLIN) != 0) {
+                open = readRequests(connection);
+            }
+            if (open) {
+                open = answerRequests(connection);
+            }
+            // Only attached lanes journal, so only their responses wait for the commit
+            if (open && connection.attached && journal && journal->hasPending()) {
+                connection.uncommitted = responsesStart;
+                awaitingCommit.push_back(fd);
+                continue;
+            }
+            if (open) {
+                open = writeResponses(connection);
+            }
+            if (!open) {
+                closeConnection(fd);
+            }
+        }
+
+        // Group commit: one flush makes every change read in this pass durable before it is answered.
+        // A failed commit leaves the changes pending for the next pass and is reported to the lanes
+        bool committed = true;
+        if (journal && journal->hasPending()) {
+            try {
+                journal->commit();
+            } catch (const std::runtime_error&) {
+                committed = false;
+            }
+        }
+        for (int fd : awaitingCommit) {
+            auto it = connections.find(fd);
+            if (it == connections.end()) {
+                continue;
+            }
+            if (!committed) {
+                failUncommitted(*it->second);
+            }
+            if (!writeResponses(*it->second)) {
+                closeConnection(fd);
+            }
+        }
+        awaitingCommit.clear();
+    }
+}
+
+void CheckoutServer::acceptConnections() {
+    while (true) {
+        int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            // EAGAIN once the backlog is drained; other errors only affect the connection being accepted
+            return;
+        }
+        if (port != 0) {
+            // Responses are small and latency-bound
+            int noDelay = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            ::close(fd);
+            continue;
+        }
+        connections[fd] = std::make_unique<Connection>(fd, store);
+        connections[fd]->watchedEvents = EPOLLIN;
+    }
+}
+
+bool CheckoutServer::readRequests(Connection& connection) {
+    // Requests beyond the next full frame stay in the socket until earlier ones are answered
+    char buffer[16384];
+    while (connection.input.size() < sizeof(std::uint32_t) + MAX_FRAME) {
+        ssize_t received = ::recv(connection.fd, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            connection.input.append(buffer, static_cast<std::size_t>(received));
+            if (static_cast<std::size_t>(received) < sizeof(buffer)) {
+                break;
+            }
+            continue;
+        }
+        if (received == 0) {
+            return false;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        return false;
+    }
+    return true;
+}
+
+bool CheckoutServer::answerRequests(Connection& connection) {
+    // Answer complete frames in order; the rest wait until the lane has read its responses
+    std::size_t offset = 0;
+    while (connection.output.size() - connection.written < MAX_PENDING_OUTPUT &&
+           connection.input.size() - offset >= sizeof(std::uint32_t)) {
+        std::uint32_t length;
+        std::memcpy(&length, connection.input.data() + offset, sizeof(length));
+        if (length == 0 || length > MAX_FRAME) {
+            return false;
+        }
+        if (connection.input.size() - offset - sizeof(length) < length) {
+            break;
+        }
+        handleRequest(connection, connection.input.data() + offset + sizeof(length), length);
+        offset += sizeof(length) + length;
+    }
+    connection.input.erase(0, offset);
+    return connection.output.size() - connection.written <= MAX_OUTPUT;
+}
+
+void CheckoutServer::handleRequest(Connection& connection, const char* payload, std::size_t size) {
+    // Reserve the frame header and status byte, then fill in the length once the body is known
+    std::string& output = connection.output;
+    std::size_t frameStart = output.size();
+    output.append(sizeof(std::uint32_t), '\0');
+    output += static_cast<char>(Status::OK);
+
+    Checkout& session = connection.session;
+    std::string_view argument(payload + 1, size - 1);
+    switch (static_cast<Command>(payload[0])) {
+    case Command::SCAN:
+    case Command::VOID_ITEM: {
+        // Totals go first, so they are written after the scan and inserted ahead of its messages
+        std::size_t totalsStart = output.size();
+        connection.sink->response = &output;
+        if (static_cast<Command>(payload[0]) == Command::SCAN) {
+            session.scanItem(argument);
+        } else {
+            session.voidItem(argument);
+        }
+        connection.sink->response = nullptr;
+
+        std::string totals;
+        appendTotals(session.getTotals(), totals);
+        output.insert(totalsStart, totals);
+        break;
+    }
+    case Command::TOTAL:
+        appendTotals(session.getTotals(), output);
+        break;
+    case Command::RECEIPT: {
+        auto format = argument.empty() ? ReceiptFormat::BINARY : static_cast<ReceiptFormat>(argument[0]);
+        if (argument.size() > 1 || format > ReceiptFormat::BINARY) {
+            output[frameStart + sizeof(std::uint32_t)] = static_cast<char>(Status::BAD_REQUEST);
+            break;
+        }
+        session.applyDeals();
+        session.buildReceipt(connection.receipt);
+        connection.receipt.number = ++connection.receipts;
+        switch (format) {
+        case ReceiptFormat::TEXT:
+            ReceiptWriter::writeText(connection.receipt, output);
+            break;
+        case ReceiptFormat::JSON_LINES:
+            ReceiptWriter::writeJsonLine(connection.receipt, output);
+            break;
+        case ReceiptFormat::CSV:
+            ReceiptWriter::writeCsv(connection.receipt, output);
+            break;
+        case ReceiptFormat::BINARY:
+            ReceiptWriter::writeBinary(connection.receipt, output);
+            break;
+        }
+        session.newBasket();
+        break;
+    }
+    case Command::ATTACH: {
+        std::uint32_t lane;
+        if (argument.size() != sizeof(lane)) {
+            output[frameStart + sizeof(std::uint32_t)] = static_cast<char>(Status::BAD_REQUEST);
+            break;
+        }
+        std::memcpy(&lane, argument.data(), sizeof(lane));
+        if (!attachLane(connection, lane)) {
+            output[frameStart + sizeof(std::uint32_t)] = static_cast<char>(Status::BAD_REQUEST);
+            break;
+        }
+        appendTotals(session.getTotals(), output);
+        break;
+    }
+    case Command::METRICS:
+        Metrics::writeJson(Metrics::snapshot(), output);
+        break;
+    default:
+        output[frameStart + sizeof(std::uint32_t)] = static_cast<char>(Status::BAD_REQUEST);
+        break;
+    }
+
+    std::uint32_t length = static_cast<std::uint32_t>(output.size() - frameStart - sizeof(std::uint32_t));
+    std::memcpy(&output[frameStart], &length, sizeof(length));
+}
+
+bool CheckoutServer::attachLane(Connection& connection, std::uint32_t lane) {
+    if (connection.attached || lanes.count(lane) != 0 || connection.session.getTotals().lines != 0) {
+        return false;
+    }
+
+    // A cart left behind by an earlier connection is newer than anything recovered at startup
+    std::vector<ScanJournal::CartLine> cart;
+    auto parked = parkedCarts.find(lane);
+    if (parked != parkedCarts.end()) {
+        cart = std::move(parked->second);
+        parkedCarts.erase(parked);
+    } else if (journal) {
+        cart = journal->takeRecoveredCart(lane);
+    }
+
+    // The cart is already in the journal, so it is restored before journaling starts
+    connection.session.restoreCart(cart);
+    connection.session.setJournal(journal, lane);
+    connection.attached = true;
+    connection.lane = lane;
+    lanes[lane] = connection.fd;
+    return true;
+}
+
+void CheckoutServer::failUncommitted(Connection& connection) {
+    std::string& output = connection.output;
+    for (std::size_t offset = connection.uncommitted; offset + sizeof(std::uint32_t) < output.size();) {
+        std::uint32_t length;
+        std::memcpy(&length, output.data() + offset, sizeof(length));
+        if (output[offset + sizeof(length)] == static_cast<char>(Status::OK)) {
+            output[offset + sizeof(length)] = static_cast<char>(Status::JOURNAL_ERROR);
+        }
+        offset += sizeof(length) + length;
+    }
+}
+
+bool CheckoutServer::writeResponses(Connection& connection) {
+    while (connection.written < connection.output.size()) {
+        ssize_t sent = ::send(connection.fd, connection.output.data() + connection.written,
+                              connection.output.size() - connection.written, MSG_NOSIGNAL);
+        if (sent > 0) {
+            connection.written += static_cast<std::size_t>(sent);
+            continue;
+        }
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        return false;
+    }
+    if (connection.written == connection.output.size()) {
+        connection.output.clear();
+        connection.written = 0;
+    }
+
+    // Stop reading while output is backed up; wait for writability while output is left, or to
+    // come back to requests that were read but held back, as no new input may arrive for them
+    std::size_t backlog = connection.output.size() - connection.written;
+    std::uint32_t wanted = 0;
+    if (backlog < MAX_PENDING_OUTPUT) {
+        wanted |= EPOLLIN;
+    }
+    if (backlog > 0 || hasRequest(connection.input)) {
+        wanted |= EPOLLOUT;
+    }
+    if (wanted != connection.watchedEvents) {
+        epoll_event event = {};
+        event.events = wanted;
+        event.data.fd = connection.fd;
+        ::epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+        connection.watchedEvents = wanted;
+    }
+    return true;
+}
+
+void CheckoutServer::closeConnection(int fd) {
+    auto it = connections.find(fd);
+    if (it != connections.end() && it->second->attached) {
+        // Keep the basket in progress for when the lane comes back
+        Connection& connection = *it->second;
+        lanes.erase(connection.lane);
+        if (connection.session.getTotals().lines != 0) {
+            connection.session.buildReceipt(connection.receipt);
+            std::vector<ScanJournal::CartLine>& cart = parkedCarts[connection.lane];
+            for (const ReceiptLine& line : connection.receipt.lines) {
+                const Item& item = connection.receipt.catalog->getItem(line.itemIndex);
+                cart.push_back(ScanJournal::CartLine{std::string(item.getId()), line.quantity});
+            }
+        }
+    }
+
+    ::epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    connections.erase(fd);
+}
+
+#else
+
+CheckoutServer::CheckoutServer(std::shared_ptr<CatalogStore>, const std::string&) {
+    throw std::runtime_error("CheckoutServer is only available on Linux.");
+}
+
+CheckoutServer::CheckoutServer(std::shared_ptr<CatalogStore>, std::uint16_t) {
+    throw std::runtime_error("CheckoutServer is only available on Linux.");
+}
+
+CheckoutServer::~CheckoutServer() = default;
+
+std::uint16_t CheckoutServer::getPort() const {
+    return port;
+}
+
+void CheckoutServer::setJournal(std::shared_ptr<ScanJournal> newJournal) {
+    journal = std::move(newJournal);
+}
+
+void CheckoutServer::setCatalogPath(const std::string& path) {
+    catalogPath = path;
+}
+
+void CheckoutServer::run() {}
+
+void CheckoutServer::stop() {}
+
+void CheckoutServer::reloadCatalog() {}
+
+#endif
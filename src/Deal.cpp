@@ -1,122 +1,379 @@
 // Deal.cpp
 #include "Deal.h"
 #include <algorithm>
-#include <map>
-#include <iostream>
-#include <sstream>
-#include <iomanip>
-
-DealType1::DealType1(const std::set<std::string>& eligibleItemIds)
-    : eligibleItemIds(eligibleItemIds) {}
-
-void DealType1::applyDeal(std::vector<PurchasedItem>& items, std::vector<std::string>& appliedDeals) {
-    // Group eligible items by item ID
-    std::map<std::string, std::vector<PurchasedItem*>> itemGroups;
-
-    for (auto& purchasedItem : items) {
-        Item* item = purchasedItem.getItem();
-        if (eligibleItemIds.find(item->getId()) != eligibleItemIds.end() && !purchasedItem.isUsedInDeal()) {
-            itemGroups[item->getId()].push_back(&purchasedItem);
+#include <cstdio>
+#include <limits>
+
+namespace {
+
+std::vector<std::uint32_t> sortedUnique(std::vector<std::uint32_t> indices) {
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+    return indices;
+}
+
+// A whole-number percentage of an amount, to the nearest cent; free units skip the division
+Money percentOf(Money amount, int percent) {
+    return percent == 100 ? amount : Money::fromCents((amount.getCents() * percent + 50) / 100);
+}
+
+// Rules shaped and named like the two classic deals report their type, so they price and print the
+// same way; a renamed rule is a promotion of its own and reports DealType::RULE
+DealType typeOf(const DealRule& rule) {
+    if (rule.op == DealRule::Op::MULTI_BUY && rule.groupUnits == 3 && rule.discountedUnits == 1 &&
+        rule.percentOff == 100 && rule.name == DealRule::dealType1().name) {
+        return DealType::TYPE1;
+    }
+    if (rule.op == DealRule::Op::BUNDLE && rule.discountedUnits == 1 && rule.percentOff == 100 &&
+        rule.name == DealRule::dealType2().name) {
+        return DealType::TYPE2;
+    }
+    return DealType::RULE;
+}
+
+} // namespace
+
+Deal::Deal(const std::vector<std::uint32_t>& eligibleItemIndices, bool needsEveryItem)
+    : eligibleItemIndices(sortedUnique(eligibleItemIndices)),
+      eligibleWords(ItemBitset::compile(this->eligibleItemIndices)), everyItem(needsEveryItem) {}
+
+void Deal::applyDeal(PricedBasket& basket, std::vector<DealApplication>& appliedDeals) const {
+    applyDeal(basket, appliedDeals, std::numeric_limits<int>::max());
+}
+
+std::string Deal::describe(const DealApplication& application, const std::vector<Item>& items) const {
+    std::string description;
+    describe(application, items, description);
+    return description;
+}
+
+const std::vector<std::uint32_t>& Deal::getEligibleItemIndices() const {
+    return eligibleItemIndices;
+}
+
+const std::vector<ItemBitset::Word>& Deal::getEligibleWords() const {
+    return eligibleWords;
+}
+
+bool Deal::needsEveryItem() const {
+    return everyItem;
+}
+
+bool Deal::canApply(const ItemBitset& present) const {
+    if (everyItem) {
+        return !eligibleWords.empty() && present.containsAll(eligibleWords);
+    }
+    return present.containsAny(eligibleWords);
+}
+
+DealType1::DealType1(const std::vector<std::uint32_t>& eligibleItemIndices)
+    : Deal(eligibleItemIndices, false) {}
+
+DealType DealType1::getType() const {
+    return DealType::TYPE1;
+}
+
+std::string_view DealType1::getName() const {
+    return "Deal Type 1";
+}
+
+int DealType1::getStage() const {
+    return 0;
+}
+
+void DealType1::applyDeal(PricedBasket& basket, std::vector<DealApplication>& appliedDeals, int maxSets) const {
+    // Look up each eligible item's line; lines are sorted by item index, which follows item ID order
+    for (std::uint32_t itemIndex : eligibleItemIndices) {
+        std::size_t line = basket.find(itemIndex);
+        if (line == PricedBasket::NPOS) {
+            continue;
+        }
+
+        // Number of times the deal can be applied
+        int eligibleSets = std::min(basket.getAvailableQuantity(line) / 3, maxSets);
+        if (eligibleSets <= 0) {
+            continue;
         }
+
+        // Each set uses three units and makes one of them free
+        basket.useInDeal(line, eligibleSets * 3);
+        basket.addFreeUnits(line, eligibleSets, *this);
+
+        // Record the applied deal with the discount of one set
+        appliedDeals.push_back({this, itemIndex, eligibleSets, basket.getUnitPrice(line)});
+    }
+}
+
+void DealType1::describe(const DealApplication& application, const std::vector<Item>& items,
+                         std::string& output) const {
+    output += "Deal Type 1 applied to 3 x ";
+    output += items[application.itemIndex].getName();
+    output += " (-$";
+    output += application.discount.toString();
+    output += ")";
+}
+
+DealType2::DealType2(const std::vector<std::uint32_t>& eligibleItemIndices)
+    : Deal(eligibleItemIndices, true) {}
+
+DealType DealType2::getType() const {
+    return DealType::TYPE2;
+}
+
+std::string_view DealType2::getName() const {
+    return "Deal Type 2";
+}
+
+int DealType2::getStage() const {
+    return 1;
+}
+
+void DealType2::applyDeal(PricedBasket& basket, std::vector<DealApplication>& appliedDeals, int maxSets) const {
+    // If an eligible item is missing the deal cannot be applied; the bitset answers that without a search
+    if (!canApply(basket.getPresence())) {
+        return;
     }
 
-    // Apply Deal Type 1 to each group
-    for (auto& pair : itemGroups) {
-        const std::string& itemId = pair.first;
-        std::vector<PurchasedItem*>& group = pair.second;
+    // Find the line for each eligible item, in item ID order, and the cheapest of them;
+    // lines are looked up again below rather than collected, so applying a deal never allocates
+    int eligibleSets = maxSets;
+    std::size_t cheapestLine = PricedBasket::NPOS;
+    for (std::uint32_t itemIndex : eligibleItemIndices) {
+        std::size_t line = basket.find(itemIndex);
 
-        int eligibleSets = group.size() / 3; // Number of times the deal can be applied
+        // The deal can be applied once for each complete set of available units
+        eligibleSets = std::min(eligibleSets, basket.getAvailableQuantity(line));
+        if (cheapestLine == PricedBasket::NPOS || basket.getUnitPrice(line) < basket.getUnitPrice(cheapestLine)) {
+            cheapestLine = line;
+        }
+    }
+    if (eligibleSets <= 0) {
+        return;
+    }
 
-        for (int i = 0; i < eligibleSets; ++i) {
-            // Get three items
-            PurchasedItem* item1 = group[i * 3];
-            PurchasedItem* item2 = group[i * 3 + 1];
-            PurchasedItem* item3 = group[i * 3 + 2];
+    // Apply the deal
+    for (std::uint32_t itemIndex : eligibleItemIndices) {
+        basket.useInDeal(basket.find(itemIndex), eligibleSets);
+    }
 
-            // Mark items as used
-            item1->setUsedInDeal(true);
-            item2->setUsedInDeal(true);
-            item3->setUsedInDeal(true);
+    // Make one unit of the cheapest item free per set
+    basket.addFreeUnits(cheapestLine, eligibleSets, *this);
 
-            // Set the final price of one item to zero (the third item)
-            item3->setFinalPrice(0.0);
-            item3->setDealType(DealType::TYPE1); // Assign Deal Type 1
+    // Record the applied deal with the discount of one set
+    appliedDeals.push_back({this, basket.getItemIndex(cheapestLine), eligibleSets, basket.getUnitPrice(cheapestLine)});
+}
 
-            // Record the applied deal with discount amount
-            double discountAmount = item3->getItem()->getPrice();
-            std::ostringstream dealDescription;
-            dealDescription << "Deal Type 1 applied to 3 x " << item1->getItem()->getName() 
-                           << " (-$" << std::fixed << std::setprecision(2) << discountAmount << ")";
-            appliedDeals.push_back(dealDescription.str());
+void DealType2::describe(const DealApplication& application, const std::vector<Item>& items,
+                         std::string& output) const {
+    // Eligible items are listed in item ID order
+    output += "Deal Type 2 applied to ";
+    for (std::size_t i = 0; i < eligibleItemIndices.size(); ++i) {
+        if (i > 0) {
+            output += ", ";
         }
+        output += items[eligibleItemIndices[i]].getName();
     }
+    output += " (-$";
+    output += application.discount.toString();
+    output += ")";
+}
+
+DealRule DealRule::dealType1() {
+    DealRule rule;
+    rule.op = Op::MULTI_BUY;
+    rule.groupUnits = 3;
+    rule.discountedUnits = 1;
+    rule.name = "Deal Type 1";
+    return rule;
+}
+
+DealRule DealRule::dealType2() {
+    DealRule rule;
+    rule.op = Op::BUNDLE;
+    rule.discountedUnits = 1;
+    rule.name = "Deal Type 2";
+    return rule;
+}
+
+RuleDeal::RuleDeal(const std::vector<std::uint32_t>& eligibleItemIndices, DealRule rule)
+    : Deal(eligibleItemIndices, rule.op == DealRule::Op::BUNDLE), rule(std::move(rule)), type(typeOf(this->rule)) {}
+
+DealType RuleDeal::getType() const {
+    return type;
+}
+
+std::string_view RuleDeal::getName() const {
+    return rule.name;
 }
 
-DealType2::DealType2(const std::set<std::string>& eligibleItemIds)
-    : eligibleItemIds(eligibleItemIds) {}
+int RuleDeal::getStage() const {
+    switch (rule.op) {
+    case DealRule::Op::MULTI_BUY:
+        return 0;
+    case DealRule::Op::BUNDLE:
+        return 1;
+    default:
+        return 2;
+    }
+}
 
-void DealType2::applyDeal(std::vector<PurchasedItem>& items, std::vector<std::string>& appliedDeals) {
-    // Collect eligible and unused items
-    std::map<std::string, std::vector<PurchasedItem*>> availableItemsMap;
+const DealRule& RuleDeal::getRule() const {
+    return rule;
+}
 
-    for (auto& purchasedItem : items) {
-        Item* item = purchasedItem.getItem();
-        if (eligibleItemIds.find(item->getId()) != eligibleItemIds.end() && !purchasedItem.isUsedInDeal()) {
-            availableItemsMap[item->getId()].push_back(&purchasedItem);
+void RuleDeal::applyDeal(PricedBasket& basket, std::vector<DealApplication>& appliedDeals, int maxSets) const {
+    switch (rule.op) {
+    case DealRule::Op::MULTI_BUY:
+        applyMultiBuy(basket, appliedDeals, maxSets);
+        break;
+    case DealRule::Op::BUNDLE:
+        applyBundle(basket, appliedDeals, maxSets);
+        break;
+    case DealRule::Op::TIERED_UNITS:
+    case DealRule::Op::TIERED_SPEND:
+        if (maxSets > 0) {
+            applyTiered(basket, appliedDeals);
         }
+        break;
     }
+}
 
-    // Continue applying Deal Type 2 as long as possible
-    while (true) {
-        std::vector<PurchasedItem*> dealItems;
-
-        // Attempt to collect one of each eligible item in the set
-        for (const std::string& itemId : eligibleItemIds) {
-            if (availableItemsMap[itemId].empty()) {
-                // Cannot apply the deal anymore
-                goto DEAL_TYPE_2_DONE;
-            } else {
-                // Take the last available item
-                PurchasedItem* pItem = availableItemsMap[itemId].back();
-                availableItemsMap[itemId].pop_back();
-                dealItems.push_back(pItem);
-            }
+void RuleDeal::applyMultiBuy(PricedBasket& basket, std::vector<DealApplication>& appliedDeals, int maxSets) const {
+    for (std::uint32_t itemIndex : eligibleItemIndices) {
+        std::size_t line = basket.find(itemIndex);
+        if (line == PricedBasket::NPOS) {
+            continue;
         }
 
-        // Find the cheapest item among the three
-        PurchasedItem* cheapestItem = dealItems[0];
-        for (auto& pItem : dealItems) {
-            if (pItem->getItem()->getPrice() < cheapestItem->getItem()->getPrice()) {
-                cheapestItem = pItem;
-            }
+        int eligibleSets = std::min(basket.getAvailableQuantity(line) / rule.groupUnits, maxSets);
+        if (eligibleSets <= 0) {
+            continue;
         }
 
-        // Apply the deal
-        for (auto& pItem : dealItems) {
-            pItem->setUsedInDeal(true);
+        // Each set uses groupUnits units and discounts discountedUnits of them
+        Money setDiscount = percentOf(basket.getUnitPrice(line) * rule.discountedUnits, rule.percentOff);
+        basket.useInDeal(line, eligibleSets * rule.groupUnits);
+        basket.addDiscount(line, setDiscount * eligibleSets, *this);
+        appliedDeals.push_back({this, itemIndex, eligibleSets, setDiscount});
+    }
+}
+
+void RuleDeal::applyBundle(PricedBasket& basket, std::vector<DealApplication>& appliedDeals, int maxSets) const {
+    if (!canApply(basket.getPresence())) {
+        return;
+    }
+
+    // One pass finds the number of complete sets and the cheapest line; ties go to the lower item index
+    int eligibleSets = maxSets;
+    std::size_t cheapestLine = PricedBasket::NPOS;
+    for (std::uint32_t itemIndex : eligibleItemIndices) {
+        std::size_t line = basket.find(itemIndex);
+        eligibleSets = std::min(eligibleSets, basket.getAvailableQuantity(line));
+        if (cheapestLine == PricedBasket::NPOS || basket.getUnitPrice(line) < basket.getUnitPrice(cheapestLine)) {
+            cheapestLine = line;
         }
+    }
+    if (eligibleSets <= 0) {
+        return;
+    }
+    for (std::uint32_t itemIndex : eligibleItemIndices) {
+        basket.useInDeal(basket.find(itemIndex), eligibleSets);
+    }
 
-        // Set the final price of the cheapest item to zero
-        cheapestItem->setFinalPrice(0.0);
-        cheapestItem->setDealType(DealType::TYPE2); // Assign Deal Type 2
+    // Discount the cheapest line, then each next cheapest by (price, line) until enough units are discounted
+    Money setDiscount;
+    std::size_t discounted = cheapestLine;
+    for (int unit = 0; discounted != PricedBasket::NPOS; ++unit) {
+        Money unitDiscount = percentOf(basket.getUnitPrice(discounted), rule.percentOff);
+        basket.addDiscount(discounted, unitDiscount * eligibleSets, *this);
+        setDiscount += unitDiscount;
+        if (unit + 1 == rule.discountedUnits) {
+            break;
+        }
 
-        // Construct the item names string
-        std::string itemNames;
-        for (size_t i = 0; i < dealItems.size(); ++i) {
-            itemNames += dealItems[i]->getItem()->getName();
-            if (i < dealItems.size() - 1) {
-                itemNames += ", ";
+        std::size_t previous = discounted;
+        discounted = PricedBasket::NPOS;
+        for (std::uint32_t itemIndex : eligibleItemIndices) {
+            std::size_t line = basket.find(itemIndex);
+            bool after = basket.getUnitPrice(line) > basket.getUnitPrice(previous) ||
+                         (basket.getUnitPrice(line) == basket.getUnitPrice(previous) && line > previous);
+            bool before = discounted == PricedBasket::NPOS ||
+                          basket.getUnitPrice(line) < basket.getUnitPrice(discounted) ||
+                          (basket.getUnitPrice(line) == basket.getUnitPrice(discounted) && line < discounted);
+            if (after && before) {
+                discounted = line;
             }
         }
+    }
+
+    appliedDeals.push_back({this, basket.getItemIndex(cheapestLine), eligibleSets, setDiscount});
+}
 
-        // Record the applied deal with discount amount
-        double discountAmount = cheapestItem->getItem()->getPrice();
-        std::ostringstream dealDescription;
-        dealDescription << "Deal Type 2 applied to " << itemNames << " (-$" 
-                       << std::fixed << std::setprecision(2) << discountAmount << ")";
-        appliedDeals.push_back(dealDescription.str());
+void RuleDeal::applyTiered(PricedBasket& basket, std::vector<DealApplication>& appliedDeals) const {
+    // Measure the units, or the spend, still available on the eligible lines
+    std::int64_t measure = 0;
+    for (std::uint32_t itemIndex : eligibleItemIndices) {
+        std::size_t line = basket.find(itemIndex);
+        if (line == PricedBasket::NPOS) {
+            continue;
+        }
+        int available = basket.getAvailableQuantity(line);
+        measure += rule.op == DealRule::Op::TIERED_UNITS ? available
+                                                         : (basket.getUnitPrice(line) * available).getCents();
     }
 
-DEAL_TYPE_2_DONE:
-    return;
-}
\ No newline at end of file
+    const DealRule::Tier* reached = nullptr;
+    for (const DealRule::Tier& tier : rule.tiers) {
+        if (measure >= tier.threshold) {
+            reached = &tier;
+        }
+    }
+    if (reached == nullptr || measure <= 0) {
+        return;
+    }
+
+    // Every available unit takes the tier's discount, once
+    Money total;
+    std::uint32_t firstItem = 0;
+    bool applied = false;
+    for (std::uint32_t itemIndex : eligibleItemIndices) {
+        std::size_t line = basket.find(itemIndex);
+        if (line == PricedBasket::NPOS || basket.getAvailableQuantity(line) <= 0) {
+            continue;
+        }
+        int available = basket.getAvailableQuantity(line);
+        Money discount = percentOf(basket.getUnitPrice(line) * available, reached->percentOff);
+        basket.useInDeal(line, available);
+        basket.addDiscount(line, discount, *this);
+        total += discount;
+        if (!applied) {
+            firstItem = itemIndex;
+            applied = true;
+        }
+    }
+    appliedDeals.push_back({this, firstItem, 1, total});
+}
+
+void RuleDeal::describe(const DealApplication& application, const std::vector<Item>& items,
+                        std::string& output) const {
+    output += rule.name;
+    output += " applied to ";
+    if (rule.op == DealRule::Op::MULTI_BUY) {
+        char units[16];
+        std::snprintf(units, sizeof(units), "%d", rule.groupUnits);
+        output += units;
+        output += " x ";
+        output += items[application.itemIndex].getName();
+    } else {
+        // Eligible items are listed in item ID order
+        for (std::size_t i = 0; i < eligibleItemIndices.size(); ++i) {
+            if (i > 0) {
+                output += ", ";
+            }
+            output += items[eligibleItemIndices[i]].getName();
+        }
+    }
+    output += " (-$";
+    output += application.discount.toString();
+    output += ")";
+}
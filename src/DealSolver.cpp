@@ -0,0 +1,240 @@
+// DealSolver.cpp
+#include "DealSolver.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * @brief One deal as seen by the search: the lines it uses and what a set saves.
+ */
+struct Option {
+    std::size_t deal = 0;       ///< Position of the deal in the solve() input.
+    std::size_t firstLine = 0;  ///< Position of the option's first line in the shared line list.
+    std::size_t lineCount = 0;  ///< Number of lines used by one set.
+    int unitsPerLine = 1;       ///< Units of each line used by one set.
+    std::int64_t savings = 0;   ///< Cents saved by one set.
+};
+
+/**
+ * @brief Depth-first branch-and-bound over the Deal Type 2 set counts.
+ */
+class Search {
+public:
+    Search(const std::pmr::vector<Option>& type1, const std::pmr::vector<Option>& type2,
+           const std::pmr::vector<std::size_t>& lines, const std::pmr::vector<int>& remaining,
+           std::chrono::steady_clock::time_point deadline, std::pmr::memory_resource* arena)
+        : type1(type1), type2(type2), lines(lines), remaining(remaining, arena), deadline(deadline),
+          counts(type2.size(), 0, arena), bestType2(type2.size(), 0, arena), bestType1(type1.size(), 0, arena) {}
+
+    void run(std::int64_t incumbent) {
+        best = incumbent;
+        visit(0, 0);
+    }
+
+private:
+    const std::pmr::vector<Option>& type1;          ///< Deal Type 1 options, solved in closed form.
+    const std::pmr::vector<Option>& type2;          ///< Deal Type 2 options, branched on.
+    const std::pmr::vector<std::size_t>& lines;     ///< Lines of all options, in option order.
+    std::pmr::vector<int> remaining;                ///< Units of each line not yet used.
+    std::chrono::steady_clock::time_point deadline; ///< When to give up.
+    std::pmr::vector<int> counts;                   ///< Deal Type 2 counts on the current path.
+
+public:
+    std::int64_t best = 0;      ///< Savings of the best assignment found.
+    bool improved = false;      ///< Whether the search beat the incumbent.
+    bool timedOut = false;      ///< Whether the search hit the deadline.
+    std::uint64_t nodes = 0;    ///< Number of nodes visited.
+    std::pmr::vector<int> bestType2; ///< Deal Type 2 counts of the best assignment.
+    std::pmr::vector<int> bestType1; ///< Deal Type 1 counts of the best assignment.
+
+private:
+    int maxSets(const Option& option) const {
+        int sets = std::numeric_limits<int>::max();
+        for (std::size_t i = option.firstLine; i < option.firstLine + option.lineCount; ++i) {
+            sets = std::min(sets, remaining[lines[i]] / option.unitsPerLine);
+        }
+        return sets;
+    }
+
+    // Deal Type 1 savings once the Deal Type 2 counts are fixed; solve() merges the options on each line
+    std::int64_t type1Savings() const {
+        std::int64_t total = 0;
+        for (const Option& option : type1) {
+            total += option.savings * maxSets(option);
+        }
+        return total;
+    }
+
+    void visit(std::size_t depth, std::int64_t current) {
+        if (timedOut) {
+            return;
+        }
+        if ((++nodes & 0xFF) == 0 && std::chrono::steady_clock::now() >= deadline) {
+            timedOut = true;
+            return;
+        }
+
+        if (depth == type2.size()) {
+            std::int64_t total = current + type1Savings();
+            if (total > best) {
+                best = total;
+                improved = true;
+                bestType2 = counts;
+                for (std::size_t i = 0; i < type1.size(); ++i) {
+                    bestType1[i] = maxSets(type1[i]);
+                }
+            }
+            return;
+        }
+
+        // Upper bound: every remaining deal takes as many sets as it could on its own
+        std::int64_t bound = current + type1Savings();
+        for (std::size_t i = depth; i < type2.size(); ++i) {
+            bound += type2[i].savings * maxSets(type2[i]);
+        }
+        if (bound <= best) {
+            return;
+        }
+
+        const Option& option = type2[depth];
+        for (int sets = maxSets(option); sets >= 0; --sets) {
+            for (std::size_t i = option.firstLine; i < option.firstLine + option.lineCount; ++i) {
+                remaining[lines[i]] -= sets;
+            }
+            counts[depth] = sets;
+            visit(depth + 1, current + option.savings * sets);
+            for (std::size_t i = option.firstLine; i < option.firstLine + option.lineCount; ++i) {
+                remaining[lines[i]] += sets;
+            }
+            if (timedOut) {
+                return;
+            }
+        }
+        counts[depth] = 0;
+    }
+};
+
+} // namespace
+
+DealSolver::DealSolver(std::chrono::microseconds timeBudget)
+    : timeBudget(timeBudget) {}
+
+std::chrono::microseconds DealSolver::getTimeBudget() const {
+    return timeBudget;
+}
+
+DealSolver::Result::Result(std::pmr::memory_resource* resource)
+    : sets(resource) {}
+
+DealSolver::Result DealSolver::solve(const PricedBasket& basket, const std::vector<const Deal*>& deals,
+                                     std::pmr::memory_resource* arena) const {
+    auto deadline = std::chrono::steady_clock::now() + timeBudget;
+
+    Result result(arena);
+    result.sets.assign(deals.size(), 0);
+
+    // Describe each deal whose items are all in the cart as a search option
+    std::pmr::vector<Option> type1(arena);
+    std::pmr::vector<Option> type2(arena);
+    std::pmr::vector<std::size_t> lines(arena);
+    for (std::size_t d = 0; d < deals.size(); ++d) {
+        const Deal* deal = deals[d];
+        const std::vector<std::uint32_t>& eligible = deal->getEligibleItemIndices();
+        if (deal->getType() == DealType::RULE) {
+            throw std::invalid_argument("DealSolver only supports Deal Type 1 and Deal Type 2 deals.");
+        }
+        if (deal->getType() == DealType::TYPE1 && eligible.size() != 1) {
+            throw std::invalid_argument("DealSolver requires one Deal Type 1 deal per eligible item.");
+        }
+
+        if (!deal->canApply(basket.getPresence())) {
+            continue;
+        }
+
+        Option option;
+        option.deal = d;
+        option.firstLine = lines.size();
+        option.unitsPerLine = deal->getType() == DealType::TYPE1 ? 3 : 1;
+        Money cheapest;
+        bool complete = !eligible.empty();
+        for (std::uint32_t itemIndex : eligible) {
+            std::size_t line = basket.find(itemIndex);
+            if (line == PricedBasket::NPOS) {
+                complete = false;
+                break;
+            }
+            Money price = basket.getUnitPrice(line);
+            if (lines.size() == option.firstLine || price < cheapest) {
+                cheapest = price;
+            }
+            lines.push_back(line);
+        }
+        if (!complete) {
+            lines.resize(option.firstLine);
+            continue;
+        }
+        option.lineCount = lines.size() - option.firstLine;
+        option.savings = cheapest.getCents();
+
+        // Deal Type 1 deals on the same line compete for the same units, so only the one saving
+        // the most per set is kept; the others are left at zero sets
+        if (deal->getType() == DealType::TYPE1) {
+            auto same = std::find_if(type1.begin(), type1.end(), [&](const Option& other) {
+                return lines[other.firstLine] == lines[option.firstLine];
+            });
+            if (same != type1.end()) {
+                if (option.savings > same->savings) {
+                    same->deal = option.deal;
+                    same->savings = option.savings;
+                }
+                lines.resize(option.firstLine);
+                continue;
+            }
+        }
+        (deal->getType() == DealType::TYPE1 ? type1 : type2).push_back(option);
+    }
+
+    std::pmr::vector<int> remaining(arena);
+    remaining.reserve(basket.size());
+    for (std::size_t line = 0; line < basket.size(); ++line) {
+        remaining.push_back(basket.getAvailableQuantity(line));
+    }
+
+    // Greedy assignment: all Deal Type 1 deals first, then Deal Type 2 in order
+    std::pmr::vector<int> greedyRemaining(remaining, arena);
+    std::int64_t greedySavings = 0;
+    for (const std::pmr::vector<Option>* options : {&type1, &type2}) {
+        for (const Option& option : *options) {
+            int sets = std::numeric_limits<int>::max();
+            for (std::size_t i = option.firstLine; i < option.firstLine + option.lineCount; ++i) {
+                sets = std::min(sets, greedyRemaining[lines[i]] / option.unitsPerLine);
+            }
+            for (std::size_t i = option.firstLine; i < option.firstLine + option.lineCount; ++i) {
+                greedyRemaining[lines[i]] -= sets * option.unitsPerLine;
+            }
+            result.sets[option.deal] = sets;
+            greedySavings += option.savings * sets;
+        }
+    }
+    result.greedySavings = Money::fromCents(greedySavings);
+    result.savings = result.greedySavings;
+
+    Search search(type1, type2, lines, remaining, deadline, arena);
+    search.run(greedySavings);
+    result.nodes = search.nodes;
+    result.optimal = !search.timedOut;
+
+    if (search.improved) {
+        for (std::size_t i = 0; i < type1.size(); ++i) {
+            result.sets[type1[i].deal] = search.bestType1[i];
+        }
+        for (std::size_t i = 0; i < type2.size(); ++i) {
+            result.sets[type2[i].deal] = search.bestType2[i];
+        }
+        result.savings = Money::fromCents(search.best);
+    }
+
+    return result;
+}
@@ -1,11 +1,25 @@
 // Item.cpp
 #include "Item.h"
 
+Item::Item(const std::string& id, const std::string& name, Money price)
+    : storage(std::make_shared<const std::string>(id + name)), price(price) {
+    // Copies of the item share the storage, so the views stay valid
+    this->id = std::string_view(*storage).substr(0, id.size());
+    this->name = std::string_view(*storage).substr(id.size());
+}
+
 Item::Item(const std::string& id, const std::string& name, double price)
-    : id(id), name(name), price(price) {}
+    : Item(id, name, Money::fromDouble(price)) {}
+
+Item::Item(std::string_view id, std::string_view name, Money price, std::shared_ptr<const std::string> storage)
+    : storage(std::move(storage)), id(id), name(name), price(price) {}
+
+Item Item::view(std::string_view id, std::string_view name, Money price) {
+    return Item(id, name, price, nullptr);
+}
 
-std::string Item::getId() const { return id; }
+std::string_view Item::getId() const { return id; }
 
-std::string Item::getName() const { return name; }
+std::string_view Item::getName() const { return name; }
 
-double Item::getPrice() const { return price; }
+Money Item::getPrice() const { return price; }
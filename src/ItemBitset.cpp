@@ -0,0 +1,78 @@
+// ItemBitset.cpp
+#include "ItemBitset.h"
+#include <algorithm>
+
+namespace {
+
+inline std::uint32_t wordOf(std::uint32_t itemIndex) {
+    return itemIndex >> 6;
+}
+
+inline std::uint64_t bitOf(std::uint32_t itemIndex) {
+    return std::uint64_t(1) << (itemIndex & 63);
+}
+
+} // namespace
+
+std::vector<ItemBitset::Word> ItemBitset::compile(const std::vector<std::uint32_t>& itemIndices) {
+    std::vector<std::uint32_t> sorted(itemIndices);
+    std::sort(sorted.begin(), sorted.end());
+
+    // Items sharing a word are merged into one mask
+    std::vector<Word> group;
+    for (std::uint32_t itemIndex : sorted) {
+        if (group.empty() || group.back().index != wordOf(itemIndex)) {
+            group.push_back({wordOf(itemIndex), 0});
+        }
+        group.back().mask |= bitOf(itemIndex);
+    }
+    return group;
+}
+
+void ItemBitset::set(std::uint32_t itemIndex) {
+    if (wordOf(itemIndex) >= words.size()) {
+        words.resize(wordOf(itemIndex) + 1, 0);
+    }
+    words[wordOf(itemIndex)] |= bitOf(itemIndex);
+}
+
+void ItemBitset::reset(std::uint32_t itemIndex) {
+    if (wordOf(itemIndex) < words.size()) {
+        words[wordOf(itemIndex)] &= ~bitOf(itemIndex);
+    }
+}
+
+bool ItemBitset::test(std::uint32_t itemIndex) const {
+    return wordOf(itemIndex) < words.size() && (words[wordOf(itemIndex)] & bitOf(itemIndex)) != 0;
+}
+
+bool ItemBitset::containsAll(const std::vector<Word>& group) const {
+    for (const Word& word : group) {
+        if (word.index >= words.size() || (words[word.index] & word.mask) != word.mask) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ItemBitset::containsAll(const std::vector<Word>& group, std::uint32_t assumed) const {
+    for (const Word& word : group) {
+        std::uint64_t bits = word.index < words.size() ? words[word.index] : 0;
+        if (word.index == wordOf(assumed)) {
+            bits |= bitOf(assumed);
+        }
+        if ((bits & word.mask) != word.mask) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ItemBitset::containsAny(const std::vector<Word>& group) const {
+    for (const Word& word : group) {
+        if (word.index < words.size() && (words[word.index] & word.mask) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,70 @@
+// ItemIndex.cpp
+#include "ItemIndex.h"
+
+namespace {
+
+// Fibonacci hashing spreads the packed characters over the whole table
+inline std::uint64_t slotFor(std::uint64_t key, std::uint64_t mask) {
+    return ((key * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+}
+
+} // namespace
+
+std::uint64_t ItemIndex::pack(std::string_view id, bool toUpper) {
+    if (id.empty() || id.size() > MAX_KEY_LENGTH) {
+        return 0;
+    }
+
+    std::uint64_t key = 0;
+    for (std::size_t i = 0; i < MAX_KEY_LENGTH; ++i) {
+        unsigned char c = i < id.size() ? static_cast<unsigned char>(id[i]) : 0;
+        if (toUpper && c >= 'a' && c <= 'z') {
+            c = static_cast<unsigned char>(c - 'a' + 'A');
+        }
+        key = (key << 8) | c;
+    }
+    return key;
+}
+
+void ItemIndex::build(const std::vector<std::uint64_t>& keys) {
+    // Keep the load factor at or below one half so that probe sequences stay short
+    std::uint64_t size = 16;
+    while (size < keys.size() * 2) {
+        size <<= 1;
+    }
+
+    slotKeys.assign(size, 0);
+    slotIndices.assign(size, NOT_FOUND);
+    mask = size - 1;
+
+    for (std::uint32_t i = 0; i < keys.size(); ++i) {
+        std::uint64_t key = keys[i];
+        if (key == 0) {
+            continue;
+        }
+
+        std::uint64_t slot = slotFor(key, mask);
+        while (slotKeys[slot] != 0 && slotKeys[slot] != key) {
+            slot = (slot + 1) & mask;
+        }
+        if (slotKeys[slot] == 0) { // The first item with a given key wins
+            slotKeys[slot] = key;
+            slotIndices[slot] = i;
+        }
+    }
+}
+
+std::uint32_t ItemIndex::find(std::uint64_t key) const {
+    if (key == 0 || slotKeys.empty()) {
+        return NOT_FOUND;
+    }
+
+    std::uint64_t slot = slotFor(key, mask);
+    while (slotKeys[slot] != 0) {
+        if (slotKeys[slot] == key) {
+            return slotIndices[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+    return NOT_FOUND;
+}
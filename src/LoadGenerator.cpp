@@ -0,0 +1,196 @@
+// LoadGenerator.cpp
+#include "LoadGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Platform-independent random values on top of std::mt19937_64.
+ */
+class Random {
+public:
+    explicit Random(std::uint64_t seed) : engine(seed) {}
+
+    // Uniform in [0, 1)
+    double uniform() {
+        return static_cast<double>(engine() >> 11) * 0x1.0p-53;
+    }
+
+    // Uniform in [0, bound)
+    std::uint64_t below(std::uint64_t bound) {
+        return static_cast<std::uint64_t>(uniform() * static_cast<double>(bound));
+    }
+
+    // Standard normal, by the Box-Muller transform
+    double normal() {
+        double u = 1.0 - uniform();
+        double v = uniform();
+        return std::sqrt(-2.0 * std::log(u)) * std::cos(2.0 * 3.14159265358979323846 * v);
+    }
+
+    // Fisher-Yates shuffle
+    template <typename T>
+    void shuffle(std::vector<T>& values) {
+        for (std::size_t i = values.size(); i > 1; --i) {
+            std::swap(values[i - 1], values[below(i)]);
+        }
+    }
+
+private:
+    std::mt19937_64 engine;
+};
+
+} // namespace
+
+std::string LoadGenerator::itemId(std::uint32_t n) {
+    static const char digits[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    std::string id(1, static_cast<char>('A' + n % 26));
+    std::uint32_t rest = n / 26;
+    do {
+        id += digits[rest % 36];
+        rest /= 36;
+    } while (rest > 0);
+    return id;
+}
+
+json LoadGenerator::generateCatalog(const CatalogOptions& options) {
+    if (options.items == 0 || options.items > MAX_ITEMS) {
+        throw std::invalid_argument("Item count must be between 1 and " + std::to_string(MAX_ITEMS) + ".");
+    }
+    if (!(options.priceMin > 0.0) || !(options.priceMax >= options.priceMin)) {
+        throw std::invalid_argument("Prices must satisfy 0 < minimum <= maximum.");
+    }
+    if (!(options.dealType1Coverage >= 0.0 && options.dealType1Coverage <= 1.0) ||
+        !(options.dealType2Pool > 0.0 && options.dealType2Pool <= 1.0) || !(options.dealType2Density >= 0.0)) {
+        throw std::invalid_argument("Deal coverage and pool must be fractions, and density must not be negative.");
+    }
+
+    Random random(options.seed);
+    json data;
+    data["items"] = json::array();
+
+    // Log-normal prices are centred on the geometric mean, with the range spanning about three deviations
+    double logMin = std::log(options.priceMin);
+    double logMax = std::log(options.priceMax);
+    for (std::uint32_t i = 0; i < options.items; ++i) {
+        double price;
+        if (options.priceDistribution == PriceDistribution::LOG_NORMAL) {
+            double logPrice = (logMin + logMax) / 2.0 + random.normal() * (logMax - logMin) / 6.0;
+            price = std::exp(std::min(logMax, std::max(logMin, logPrice)));
+        } else {
+            price = options.priceMin + random.uniform() * (options.priceMax - options.priceMin);
+        }
+        price = std::round(price * 100.0) / 100.0;
+        data["items"].push_back({{"id", itemId(i)}, {"name", "Item " + std::to_string(i)}, {"price", price}});
+    }
+
+    std::vector<std::uint32_t> order(options.items);
+    for (std::uint32_t i = 0; i < options.items; ++i) {
+        order[i] = i;
+    }
+
+    // Deal Type 1: a random subset of the items
+    random.shuffle(order);
+    std::size_t dealType1Count = static_cast<std::size_t>(std::llround(options.dealType1Coverage * options.items));
+    std::vector<std::uint32_t> dealType1Items(order.begin(), order.begin() + dealType1Count);
+    std::sort(dealType1Items.begin(), dealType1Items.end());
+    data["deals"]["deal_type_1"] = json::array();
+    for (std::uint32_t index : dealType1Items) {
+        data["deals"]["deal_type_1"].push_back(itemId(index));
+    }
+
+    // Deal Type 2: sets of three distinct items drawn from a random pool
+    data["deals"]["deal_type_2"] = json::array();
+    random.shuffle(order);
+    std::size_t poolSize = std::max<std::size_t>(1, static_cast<std::size_t>(std::llround(options.dealType2Pool * options.items)));
+    std::size_t dealType2Count = static_cast<std::size_t>(std::llround(options.dealType2Density * options.items));
+    if (poolSize >= 3) {
+        for (std::size_t d = 0; d < dealType2Count; ++d) {
+            std::uint32_t a = order[random.below(poolSize)];
+            std::uint32_t b;
+            std::uint32_t c;
+            do {
+                b = order[random.below(poolSize)];
+            } while (b == a);
+            do {
+                c = order[random.below(poolSize)];
+            } while (c == a || c == b);
+            data["deals"]["deal_type_2"].push_back({itemId(a), itemId(b), itemId(c)});
+        }
+    }
+
+    return data;
+}
+
+void LoadGenerator::generateBaskets(const Catalog& catalog, const BasketOptions& options, std::ostream& output) {
+    std::uint32_t itemCount = catalog.getItemCount();
+    if (itemCount == 0) {
+        throw std::invalid_argument("Cannot generate baskets for an empty catalog.");
+    }
+    if (!(options.zipfExponent >= 0.0) || !(options.meanLines >= 1.0) || options.maxQuantity < 1 ||
+        !(options.removalRate >= 0.0 && options.removalRate <= 1.0)) {
+        throw std::invalid_argument("Basket options are out of range.");
+    }
+
+    Random random(options.seed);
+
+    // Popularity rank -> item index, and the cumulative Zipf weights of the ranks
+    std::vector<std::uint32_t> itemByRank(itemCount);
+    for (std::uint32_t i = 0; i < itemCount; ++i) {
+        itemByRank[i] = i;
+    }
+    random.shuffle(itemByRank);
+    std::vector<double> cumulative(itemCount);
+    double total = 0.0;
+    for (std::uint32_t rank = 0; rank < itemCount; ++rank) {
+        total += 1.0 / std::pow(static_cast<double>(rank + 1), options.zipfExponent);
+        cumulative[rank] = total;
+    }
+
+    std::string buffer;
+    std::vector<std::pair<std::uint32_t, int>> scanned;
+    for (std::uint64_t basket = 0; basket < options.baskets; ++basket) {
+        scanned.clear();
+
+        // Geometric number of lines, at least one, with the requested mean
+        double stop = 1.0 / options.meanLines;
+        do {
+            double target = random.uniform() * total;
+            std::size_t rank = static_cast<std::size_t>(
+                std::upper_bound(cumulative.begin(), cumulative.end(), target) - cumulative.begin());
+            std::uint32_t item = itemByRank[std::min<std::size_t>(rank, itemCount - 1)];
+
+            // Most lines are single units
+            int quantity = random.uniform() < 0.6 ? 1 : 2 + static_cast<int>(random.below(options.maxQuantity - 1));
+            if (options.maxQuantity == 1) {
+                quantity = 1;
+            }
+            buffer += catalog.getItem(item).getId();
+            if (quantity != 1) {
+                buffer += ' ';
+                buffer += std::to_string(quantity);
+            }
+            buffer += '\n';
+            scanned.emplace_back(item, quantity);
+
+            if (random.uniform() < options.removalRate) {
+                const std::pair<std::uint32_t, int>& line = scanned[random.below(scanned.size())];
+                buffer += catalog.getItem(line.first).getId();
+                buffer += " -";
+                buffer += std::to_string(1 + random.below(line.second));
+                buffer += '\n';
+            }
+        } while (random.uniform() >= stop);
+        buffer += '\n';
+
+        if (buffer.size() >= (1u << 16)) {
+            output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    }
+    output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
@@ -0,0 +1,276 @@
+// Metrics.cpp
+#include "Metrics.h"
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t PHASE_COUNT = static_cast<std::size_t>(MetricsPhase::COUNT);
+constexpr std::size_t COUNTER_COUNT = static_cast<std::size_t>(MetricsCounter::COUNT);
+
+// log2 of LatencyHistogram::SUB_BUCKETS
+constexpr std::uint32_t SUB_BUCKET_BITS = 5;
+
+/**
+ * @struct Shard
+ * @brief One thread's histograms and counters.
+ */
+struct Shard {
+    std::array<LatencyHistogram, PHASE_COUNT> histograms;
+    std::array<std::atomic<std::uint64_t>, COUNTER_COUNT> counters{};
+};
+
+/**
+ * @struct Registry
+ * @brief Every shard ever created; shards outlive their threads so nothing recorded is lost.
+ */
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Shard>> shards;
+};
+
+Registry& registry() {
+    static Registry* instance = new Registry(); // never destroyed: threads may record during shutdown
+    return *instance;
+}
+
+Shard& localShard() {
+    thread_local Shard* shard = [] {
+        Registry& all = registry();
+        std::lock_guard<std::mutex> lock(all.mutex);
+        all.shards.push_back(std::make_unique<Shard>());
+        return all.shards.back().get();
+    }();
+    return *shard;
+}
+
+int highestBit(std::uint64_t value) {
+    int bit = 0;
+    while (value >>= 1) {
+        ++bit;
+    }
+    return bit;
+}
+
+// Smallest value whose cumulative count reaches the given fraction of all values, capped at the maximum
+std::uint64_t percentile(const std::array<std::uint64_t, LatencyHistogram::BUCKETS>& counts, std::uint64_t total,
+                         std::uint64_t maximum, double fraction) {
+    std::uint64_t target = static_cast<std::uint64_t>(std::ceil(fraction * static_cast<double>(total)));
+    target = target == 0 ? 1 : target;
+    std::uint64_t seen = 0;
+    for (std::uint32_t bucket = 0; bucket < LatencyHistogram::BUCKETS; ++bucket) {
+        seen += counts[bucket];
+        if (seen >= target) {
+            std::uint64_t value = LatencyHistogram::highestValueOf(bucket);
+            return value < maximum ? value : maximum;
+        }
+    }
+    return maximum;
+}
+
+} // namespace
+
+std::uint32_t LatencyHistogram::bucketOf(std::uint64_t nanos) {
+    if (nanos < SUB_BUCKETS) {
+        return static_cast<std::uint32_t>(nanos);
+    }
+    constexpr std::uint64_t LARGEST = (std::uint64_t(1) << 36) - 1;
+    if (nanos > LARGEST) {
+        nanos = LARGEST;
+    }
+
+    // The top SUB_BUCKET_BITS + 1 bits select the bucket within the value's power of two
+    int bit = highestBit(nanos);
+    int shift = bit - static_cast<int>(SUB_BUCKET_BITS);
+    return static_cast<std::uint32_t>((shift + 1) * static_cast<int>(SUB_BUCKETS)) +
+           static_cast<std::uint32_t>((nanos >> shift) - SUB_BUCKETS);
+}
+
+std::uint64_t LatencyHistogram::lowestValueOf(std::uint32_t bucket) {
+    if (bucket < SUB_BUCKETS) {
+        return bucket;
+    }
+    std::uint32_t shift = bucket / SUB_BUCKETS - 1;
+    return (std::uint64_t(SUB_BUCKETS) + bucket % SUB_BUCKETS) << shift;
+}
+
+std::uint64_t LatencyHistogram::highestValueOf(std::uint32_t bucket) {
+    if (bucket < SUB_BUCKETS) {
+        return bucket;
+    }
+    std::uint32_t shift = bucket / SUB_BUCKETS - 1;
+    return lowestValueOf(bucket) + (std::uint64_t(1) << shift) - 1;
+}
+
+std::uint64_t LatencyHistogram::getCount(std::uint32_t bucket) const {
+    return buckets[bucket].load(std::memory_order_relaxed);
+}
+
+std::uint64_t LatencyHistogram::getTotal() const {
+    return total.load(std::memory_order_relaxed);
+}
+
+std::uint64_t LatencyHistogram::getMaximum() const {
+    return maximum.load(std::memory_order_relaxed);
+}
+
+void LatencyHistogram::reset() {
+    for (std::atomic<std::uint64_t>& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    total.store(0, std::memory_order_relaxed);
+    maximum.store(0, std::memory_order_relaxed);
+}
+
+void Metrics::record(MetricsPhase phase, std::uint64_t nanos) {
+    localShard().histograms[static_cast<std::size_t>(phase)].record(nanos);
+}
+
+void Metrics::increment(MetricsCounter counter, std::uint64_t amount) {
+    std::atomic<std::uint64_t>& value = localShard().counters[static_cast<std::size_t>(counter)];
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+Metrics::Snapshot Metrics::snapshot() {
+    Snapshot snapshot;
+    Registry& all = registry();
+    std::lock_guard<std::mutex> lock(all.mutex);
+
+    for (std::size_t phase = 0; phase < PHASE_COUNT; ++phase) {
+        std::array<std::uint64_t, LatencyHistogram::BUCKETS> counts{};
+        PhaseSnapshot& merged = snapshot.phases[phase];
+        for (const std::unique_ptr<Shard>& shard : all.shards) {
+            const LatencyHistogram& histogram = shard->histograms[phase];
+            for (std::uint32_t bucket = 0; bucket < LatencyHistogram::BUCKETS; ++bucket) {
+                std::uint64_t count = histogram.getCount(bucket);
+                counts[bucket] += count;
+                merged.count += count;
+            }
+            merged.total += histogram.getTotal();
+            if (histogram.getMaximum() > merged.max) {
+                merged.max = histogram.getMaximum();
+            }
+        }
+        if (merged.count > 0) {
+            merged.p50 = percentile(counts, merged.count, merged.max, 0.50);
+            merged.p90 = percentile(counts, merged.count, merged.max, 0.90);
+            merged.p99 = percentile(counts, merged.count, merged.max, 0.99);
+            merged.p999 = percentile(counts, merged.count, merged.max, 0.999);
+        }
+    }
+    for (const std::unique_ptr<Shard>& shard : all.shards) {
+        for (std::size_t counter = 0; counter < COUNTER_COUNT; ++counter) {
+            snapshot.counters[counter] += shard->counters[counter].load(std::memory_order_relaxed);
+        }
+    }
+    return snapshot;
+}
+
+void Metrics::reset() {
+    Registry& all = registry();
+    std::lock_guard<std::mutex> lock(all.mutex);
+    for (const std::unique_ptr<Shard>& shard : all.shards) {
+        for (LatencyHistogram& histogram : shard->histograms) {
+            histogram.reset();
+        }
+        for (std::atomic<std::uint64_t>& counter : shard->counters) {
+            counter.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+const char* Metrics::nameOf(MetricsPhase phase) {
+    switch (phase) {
+    case MetricsPhase::SCAN_ITEM:
+        return "scan_item";
+    case MetricsPhase::PARSE:
+        return "parse";
+    case MetricsPhase::LOOKUP:
+        return "lookup";
+    case MetricsPhase::PROCESS_SCANNED_ITEM:
+        return "process_scanned_item";
+    case MetricsPhase::DEAL_TYPE1:
+        return "deal_type1";
+    case MetricsPhase::DEAL_TYPE2:
+        return "deal_type2";
+    case MetricsPhase::DEAL_RULE:
+        return "deal_rule";
+    case MetricsPhase::APPLY_DEALS:
+        return "apply_deals";
+    case MetricsPhase::BUILD_RECEIPT:
+        return "build_receipt";
+    case MetricsPhase::GENERATE_RECEIPT:
+        return "generate_receipt";
+    case MetricsPhase::COUNT:
+        break;
+    }
+    return "unknown";
+}
+
+const char* Metrics::nameOf(MetricsCounter counter) {
+    switch (counter) {
+    case MetricsCounter::SCANS:
+        return "scans";
+    case MetricsCounter::PARSE_ERRORS:
+        return "parse_errors";
+    case MetricsCounter::ITEMS_NOT_FOUND:
+        return "items_not_found";
+    case MetricsCounter::QUANTITY_CLAMPS:
+        return "quantity_clamps";
+    case MetricsCounter::RECEIPTS:
+        return "receipts";
+    case MetricsCounter::COUNT:
+        break;
+    }
+    return "unknown";
+}
+
+void Metrics::writeText(const Snapshot& snapshot, std::string& output) {
+    if (!snapshot.enabled) {
+        output += "Metrics are disabled in this build (configure with -DSUPERMARKET_ENABLE_METRICS=ON).\n";
+        return;
+    }
+    char line[160];
+    std::snprintf(line, sizeof(line), "%-22s %10s %10s %10s %10s %10s %10s %10s\n", "phase (us)", "count", "mean",
+                  "p50", "p90", "p99", "p99.9", "max");
+    output += line;
+    for (std::size_t phase = 0; phase < PHASE_COUNT; ++phase) {
+        const PhaseSnapshot& stats = snapshot.phases[phase];
+        double mean = stats.count == 0 ? 0.0 : static_cast<double>(stats.total) / static_cast<double>(stats.count);
+        std::snprintf(line, sizeof(line), "%-22s %10llu %10.3f %10.3f %10.3f %10.3f %10.3f %10.3f\n",
+                      nameOf(static_cast<MetricsPhase>(phase)), static_cast<unsigned long long>(stats.count),
+                      mean / 1000.0, stats.p50 / 1000.0, stats.p90 / 1000.0, stats.p99 / 1000.0,
+                      stats.p999 / 1000.0, stats.max / 1000.0);
+        output += line;
+    }
+    for (std::size_t counter = 0; counter < COUNTER_COUNT; ++counter) {
+        std::snprintf(line, sizeof(line), "%-22s %10llu\n", nameOf(static_cast<MetricsCounter>(counter)),
+                      static_cast<unsigned long long>(snapshot.counters[counter]));
+        output += line;
+    }
+}
+
+void Metrics::writeJson(const Snapshot& snapshot, std::string& output) {
+    output += "{\"enabled\":";
+    output += snapshot.enabled ? "true" : "false";
+    output += ",\"phases\":{";
+    for (std::size_t phase = 0; phase < PHASE_COUNT; ++phase) {
+        const PhaseSnapshot& stats = snapshot.phases[phase];
+        output += phase == 0 ? "\"" : ",\"";
+        output += nameOf(static_cast<MetricsPhase>(phase));
+        output += "\":{\"count\":" + std::to_string(stats.count) + ",\"total_ns\":" + std::to_string(stats.total) +
+                  ",\"p50_ns\":" + std::to_string(stats.p50) + ",\"p90_ns\":" + std::to_string(stats.p90) +
+                  ",\"p99_ns\":" + std::to_string(stats.p99) + ",\"p999_ns\":" + std::to_string(stats.p999) +
+                  ",\"max_ns\":" + std::to_string(stats.max) + "}";
+    }
+    output += "},\"counters\":{";
+    for (std::size_t counter = 0; counter < COUNTER_COUNT; ++counter) {
+        output += counter == 0 ? "\"" : ",\"";
+        output += nameOf(static_cast<MetricsCounter>(counter));
+        output += "\":" + std::to_string(snapshot.counters[counter]);
+    }
+    output += "}}\n";
+}
@@ -0,0 +1,45 @@
+// Money.cpp
+#include "Money.h"
+#include <cmath>
+#include <stdexcept>
+
+Money Money::fromDouble(double amount) {
+    double scaled = amount * 100.0;
+    if (!std::isfinite(scaled) || std::fabs(scaled) >= 9.0e18) {
+        throw std::out_of_range("Monetary amount cannot be represented in cents.");
+    }
+    // std::llround rounds halves away from zero
+    return Money(static_cast<std::int64_t>(std::llround(scaled)));
+}
+
+double Money::toDouble() const {
+    return static_cast<double>(cents) / 100.0;
+}
+
+std::string Money::toString() const {
+    // Work on the magnitude as unsigned so that the most negative value is handled too
+    std::uint64_t magnitude = cents < 0 ? 0 - static_cast<std::uint64_t>(cents) : static_cast<std::uint64_t>(cents);
+
+    char buffer[32];
+    char* end = buffer + sizeof(buffer);
+    char* p = end;
+
+    std::uint64_t fraction = magnitude % 100;
+    std::uint64_t units = magnitude / 100;
+    *--p = static_cast<char>('0' + fraction % 10);
+    *--p = static_cast<char>('0' + fraction / 10);
+    *--p = '.';
+    do {
+        *--p = static_cast<char>('0' + units % 10);
+        units /= 10;
+    } while (units != 0);
+    if (cents < 0) {
+        *--p = '-';
+    }
+
+    return std::string(p, end);
+}
+
+std::ostream& operator<<(std::ostream& os, Money amount) {
+    return os << amount.toString();
+}
@@ -0,0 +1,129 @@
+// OutputSink.cpp
+#include "OutputSink.h"
+#include <cctype>
+#include <cstring>
+
+bool OutputSink::wantsText() const {
+    return true;
+}
+
+void OutputSink::flush() {}
+
+void NullSink::scanMessage(const ScanMessage&) {}
+
+void NullSink::text(std::string_view) {}
+
+bool NullSink::wantsText() const {
+    return false;
+}
+
+TextSink::TextSink(std::ostream& stream, std::size_t bufferSize)
+    : stream(stream), bufferSize(bufferSize) {}
+
+TextSink::~TextSink() {
+    if (!buffer.empty()) {
+        stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    }
+}
+
+void TextSink::scanMessage(const ScanMessage& message) {
+    formatScanMessage(message, buffer);
+    writeIfFull();
+}
+
+void TextSink::text(std::string_view text) {
+    buffer.append(text.data(), text.size());
+    writeIfFull();
+}
+
+void TextSink::flush() {
+    stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    buffer.clear();
+    stream.flush();
+}
+
+void TextSink::writeIfFull() {
+    if (buffer.size() >= bufferSize) {
+        stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+}
+
+void TextSink::formatScanMessage(const ScanMessage& message, std::string& output) {
+    switch (message.event) {
+    case ScanEvent::QUANTITY_UPDATED:
+        output += "Updated ";
+        output += message.itemName;
+        output += " quantity to ";
+        output += std::to_string(message.quantity);
+        output += ".\n";
+        break;
+    case ScanEvent::QUANTITY_CLAMPED:
+        output += "Total quantity for item ID '";
+        output += message.itemId;
+        output += "' cannot exceed 100. Setting quantity to 100.\n";
+        break;
+    case ScanEvent::ITEM_REMOVED:
+        output += "No items of ID '";
+        output += message.itemId;
+        output += "' left in your cart.\n";
+        break;
+    case ScanEvent::ITEM_NOT_FOUND:
+        output += "Error: Item ID '";
+        for (char c : message.itemId) {
+            output += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        }
+        output += "' not found.\nType 'help' for a list of available items.\n";
+        break;
+    case ScanEvent::INVALID_FORMAT:
+        output += "Invalid input format. Please enter the item ID and quantity (e.g., 'A1 3').\n";
+        output += "Type 'help' for a list of available commands and items.\n";
+        break;
+    case ScanEvent::QUANTITY_OUT_OF_RANGE:
+        output += "Quantity is out of acceptable range.\n";
+        break;
+    case ScanEvent::ERROR:
+        output += "Error processing item: ";
+        output += message.detail;
+        output += "\n";
+        break;
+    }
+}
+
+static_assert(sizeof(BinarySink::Record) == 12, "BinarySink::Record must be 12 bytes");
+
+BinarySink::BinarySink(std::ostream& stream, std::size_t bufferSize)
+    : stream(stream), bufferSize(bufferSize) {}
+
+BinarySink::~BinarySink() {
+    if (!buffer.empty()) {
+        stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    }
+}
+
+void BinarySink::scanMessage(const ScanMessage& message) {
+    Record record = {};
+    record.event = static_cast<std::uint8_t>(message.event);
+    record.itemIndex = message.itemIndex;
+    record.quantity = message.quantity;
+
+    char bytes[sizeof(Record)];
+    std::memcpy(bytes, &record, sizeof(Record));
+    buffer.append(bytes, sizeof(Record));
+    if (buffer.size() >= bufferSize) {
+        stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+}
+
+void BinarySink::text(std::string_view) {}
+
+bool BinarySink::wantsText() const {
+    return false;
+}
+
+void BinarySink::flush() {
+    stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    buffer.clear();
+    stream.flush();
+}
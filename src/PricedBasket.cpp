@@ -0,0 +1,177 @@
+// PricedBasket.cpp
+#include "PricedBasket.h"
+#include "Deal.h"
+#include <algorithm>
+
+std::size_t PricedBasket::size() const {
+    return itemIndices.size();
+}
+
+bool PricedBasket::empty() const {
+    return itemIndices.empty();
+}
+
+std::size_t PricedBasket::lowerBound(std::uint32_t itemIndex) const {
+    return static_cast<std::size_t>(std::lower_bound(itemIndices.begin(), itemIndices.end(), itemIndex) -
+                                    itemIndices.begin());
+}
+
+std::size_t PricedBasket::find(std::uint32_t itemIndex) const {
+    if (!presence.test(itemIndex)) {
+        return NPOS;
+    }
+    std::size_t line = lowerBound(itemIndex);
+    return line < itemIndices.size() && itemIndices[line] == itemIndex ? line : NPOS;
+}
+
+bool PricedBasket::contains(std::uint32_t itemIndex) const {
+    return presence.test(itemIndex);
+}
+
+const ItemBitset& PricedBasket::getPresence() const {
+    return presence;
+}
+
+void PricedBasket::setLine(std::uint32_t itemIndex, int quantity, Money unitPrice) {
+    std::size_t line = lowerBound(itemIndex);
+    bool present = line < itemIndices.size() && itemIndices[line] == itemIndex;
+    if (quantity == 0) {
+        if (present) {
+            itemIndices.erase(itemIndices.begin() + line);
+            quantities.erase(quantities.begin() + line);
+            unitPrices.erase(unitPrices.begin() + line);
+            usedInDeal.erase(usedInDeal.begin() + line);
+            discounts.erase(discounts.begin() + line);
+            lastDeals.erase(lastDeals.begin() + line);
+            presence.reset(itemIndex);
+        }
+        return;
+    }
+    if (!present) {
+        itemIndices.insert(itemIndices.begin() + line, itemIndex);
+        quantities.insert(quantities.begin() + line, 0);
+        unitPrices.insert(unitPrices.begin() + line, 0);
+        usedInDeal.insert(usedInDeal.begin() + line, 0);
+        discounts.insert(discounts.begin() + line, 0);
+        lastDeals.insert(lastDeals.begin() + line, nullptr);
+        presence.set(itemIndex);
+    }
+    quantities[line] = quantity;
+    unitPrices[line] = unitPrice.getCents();
+    clearDeals(line);
+}
+
+void PricedBasket::clear() {
+    for (std::uint32_t itemIndex : itemIndices) {
+        presence.reset(itemIndex);
+    }
+    itemIndices.clear();
+    quantities.clear();
+    unitPrices.clear();
+    usedInDeal.clear();
+    discounts.clear();
+    lastDeals.clear();
+}
+
+void PricedBasket::clearDeals(std::size_t line) {
+    usedInDeal[line] = 0;
+    discounts[line] = 0;
+    lastDeals[line] = nullptr;
+}
+
+void PricedBasket::clearDeals() {
+    std::fill(usedInDeal.begin(), usedInDeal.end(), 0);
+    std::fill(discounts.begin(), discounts.end(), 0);
+    std::fill(lastDeals.begin(), lastDeals.end(), nullptr);
+}
+
+std::uint32_t PricedBasket::getItemIndex(std::size_t line) const {
+    return itemIndices[line];
+}
+
+int PricedBasket::getQuantity(std::size_t line) const {
+    return quantities[line];
+}
+
+Money PricedBasket::getUnitPrice(std::size_t line) const {
+    return Money::fromCents(unitPrices[line]);
+}
+
+bool PricedBasket::isUsedInDeal(std::size_t line) const {
+    return usedInDeal[line] > 0;
+}
+
+int PricedBasket::getAvailableQuantity(std::size_t line) const {
+    return quantities[line] - usedInDeal[line];
+}
+
+void PricedBasket::useInDeal(std::size_t line, int units) {
+    usedInDeal[line] += units;
+}
+
+void PricedBasket::addFreeUnits(std::size_t line, int units, const Deal& deal) {
+    discounts[line] += unitPrices[line] * units;
+    lastDeals[line] = &deal;
+}
+
+void PricedBasket::addDiscount(std::size_t line, Money amount, const Deal& deal) {
+    discounts[line] += amount.getCents();
+    lastDeals[line] = &deal;
+}
+
+Money PricedBasket::getDiscount(std::size_t line) const {
+    return Money::fromCents(discounts[line]);
+}
+
+Money PricedBasket::getFinalPrice(std::size_t line) const {
+    return Money::fromCents(unitPrices[line] * quantities[line] - discounts[line]);
+}
+
+const Deal* PricedBasket::getDeal(std::size_t line) const {
+    return lastDeals[line];
+}
+
+DealType PricedBasket::getDealType(std::size_t line) const {
+    return lastDeals[line] != nullptr ? lastDeals[line]->getType() : DealType::NONE;
+}
+
+const std::vector<std::uint32_t>& PricedBasket::getItemIndices() const {
+    return itemIndices;
+}
+
+// The totals below read whole columns with no dependencies between lines, so they vectorize
+
+int PricedBasket::getUnits() const {
+    const std::int32_t* quantity = quantities.data();
+    std::size_t count = quantities.size();
+    int units = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        units += quantity[i];
+    }
+    return units;
+}
+
+Money PricedBasket::getPreDiscountTotal() const {
+    const std::int64_t* price = unitPrices.data();
+    const std::int32_t* quantity = quantities.data();
+    std::size_t count = quantities.size();
+    std::int64_t total = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        total += price[i] * quantity[i];
+    }
+    return Money::fromCents(total);
+}
+
+Money PricedBasket::getDiscountTotal() const {
+    const std::int64_t* discount = discounts.data();
+    std::size_t count = discounts.size();
+    std::int64_t total = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        total += discount[i];
+    }
+    return Money::fromCents(total);
+}
+
+Money PricedBasket::getFinalTotal() const {
+    return getPreDiscountTotal() - getDiscountTotal();
+}
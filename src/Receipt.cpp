@@ -0,0 +1,304 @@
+// Receipt.cpp
+#include "Receipt.h"
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+
+namespace {
+
+// Column widths of the text receipt
+const std::size_t ITEM_NAME_WIDTH = 30;
+const std::size_t PRICE_WIDTH = 10;
+
+void padLeft(std::string& output, std::string_view text, std::size_t width) {
+    if (text.size() < width) {
+        output.append(width - text.size(), ' ');
+    }
+    output += text;
+}
+
+// Pads the label written since labelStart to its column, then appends the amount
+void finishAmountRow(std::string& output, std::size_t labelStart, const char* sign, Money amount) {
+    std::size_t labelLength = output.size() - labelStart;
+    if (labelLength < ITEM_NAME_WIDTH) {
+        output.append(ITEM_NAME_WIDTH - labelLength, ' ');
+    }
+    output += sign;
+    padLeft(output, amount.toString(), PRICE_WIDTH);
+    output += '\n';
+}
+
+// One "label  $   amount" row of the text receipt
+void amountRow(std::string& output, std::string_view label, const char* sign, Money amount) {
+    std::size_t labelStart = output.size();
+    output += label;
+    finishAmountRow(output, labelStart, sign, amount);
+}
+
+const char* dealTypeLabel(DealType type) {
+    switch (type) {
+    case DealType::TYPE1:
+        return "Type 1";
+    case DealType::TYPE2:
+        return "Type 2";
+    case DealType::RULE:
+        return "Rule";
+    default:
+        return "N/A";
+    }
+}
+
+const char* dealTypeKey(DealType type) {
+    switch (type) {
+    case DealType::TYPE1:
+        return "type1";
+    case DealType::TYPE2:
+        return "type2";
+    case DealType::RULE:
+        return "rule";
+    default:
+        return "none";
+    }
+}
+
+void appendJsonString(std::string& output, std::string_view text) {
+    output += '"';
+    for (char c : text) {
+        switch (c) {
+        case '"':
+            output += "\\\"";
+            break;
+        case '\\':
+            output += "\\\\";
+            break;
+        case '\n':
+            output += "\\n";
+            break;
+        case '\r':
+            output += "\\r";
+            break;
+        case '\t':
+            output += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char escape[8];
+                std::snprintf(escape, sizeof(escape), "\\u%04x", static_cast<unsigned>(c));
+                output += escape;
+            } else {
+                output += c;
+            }
+        }
+    }
+    output += '"';
+}
+
+// Fields containing a separator, quote or line break are quoted, with quotes doubled (RFC 4180)
+void appendCsvField(std::string& output, std::string_view text) {
+    if (text.find_first_of(",\"\r\n") == std::string_view::npos) {
+        output += text;
+        return;
+    }
+    output += '"';
+    for (char c : text) {
+        if (c == '"') {
+            output += '"';
+        }
+        output += c;
+    }
+    output += '"';
+}
+
+// Every deal lists the item of each of its applications, so only that item's deals are searched
+std::uint32_t dealIndexOf(const Catalog& catalog, const DealApplication& application) {
+    for (std::uint32_t index : catalog.getDealsForItem(application.itemIndex)) {
+        if (catalog.getDeals()[index].get() == application.deal) {
+            return index;
+        }
+    }
+    return ReceiptWriter::BinaryDeal::NO_DEAL_INDEX;
+}
+
+template <typename Record>
+void appendRecord(std::string& output, const Record& record) {
+    char bytes[sizeof(Record)];
+    std::memcpy(bytes, &record, sizeof(Record));
+    output.append(bytes, sizeof(Record));
+}
+
+} // namespace
+
+static_assert(sizeof(ReceiptWriter::BinaryHeader) == 48, "ReceiptWriter::BinaryHeader must be 48 bytes");
+static_assert(sizeof(ReceiptWriter::BinaryLine) == 40, "ReceiptWriter::BinaryLine must be 40 bytes");
+static_assert(sizeof(ReceiptWriter::BinaryDeal) == 24, "ReceiptWriter::BinaryDeal must be 24 bytes");
+
+void ReceiptWriter::writeText(const Receipt& receipt, std::string& output) {
+    const std::vector<Item>& items = receipt.catalog->getItems();
+    output += "\n--- Customer Receipt ---\n";
+
+    // Item lines, each followed by its discount if it has one
+    // Labels are written in place, so names are never copied into temporaries
+    for (const ReceiptLine& line : receipt.lines) {
+        std::size_t labelStart = output.size();
+        output += items[line.itemIndex].getName();
+        output += " x";
+        char quantity[16];
+        std::snprintf(quantity, sizeof(quantity), "%d", line.quantity);
+        output += quantity;
+        finishAmountRow(output, labelStart, " $", line.preDiscount);
+        if (line.discount > Money()) {
+            labelStart = output.size();
+            output += "  Discount (";
+            output += dealTypeLabel(line.dealType);
+            output += ")";
+            finishAmountRow(output, labelStart, "-$", line.discount);
+        }
+    }
+
+    // Applied deals, one row per set
+    if (!receipt.deals.empty()) {
+        output += "\n--- Discounts Applied ---\n";
+        for (const DealApplication& application : receipt.deals) {
+            // Describe the first set in place and repeat it for the others
+            std::size_t descriptionStart = output.size();
+            application.deal->describe(application, items, output);
+            std::size_t descriptionLength = output.size() - descriptionStart;
+            output += '\n';
+            for (int set = 1; set < application.sets; ++set) {
+                output.append(output, descriptionStart, descriptionLength);
+                output += '\n';
+            }
+        }
+    }
+
+    output += '\n';
+    amountRow(output, "Total before discounts", " $", receipt.preDiscount);
+    amountRow(output, "Total savings", "-$", receipt.savings);
+    amountRow(output, "Total after discounts", " $", receipt.total);
+    output += "Thank you for shopping with us!\n";
+}
+
+void ReceiptWriter::writeJsonLine(const Receipt& receipt, std::string& output) {
+    const std::vector<Item>& items = receipt.catalog->getItems();
+
+    output += "{\"receipt\":";
+    output += std::to_string(receipt.number);
+    output += ",\"lines\":[";
+    for (std::size_t i = 0; i < receipt.lines.size(); ++i) {
+        const ReceiptLine& line = receipt.lines[i];
+        const Item& item = items[line.itemIndex];
+        output += i == 0 ? "{\"id\":" : ",{\"id\":";
+        appendJsonString(output, item.getId());
+        output += ",\"name\":";
+        appendJsonString(output, item.getName());
+        output += ",\"quantity\":";
+        output += std::to_string(line.quantity);
+        output += ",\"unit_price\":";
+        output += line.unitPrice.toString();
+        output += ",\"subtotal\":";
+        output += line.preDiscount.toString();
+        output += ",\"discount\":";
+        output += line.discount.toString();
+        output += ",\"total\":";
+        output += line.total.toString();
+        output += ",\"deal\":\"";
+        output += dealTypeKey(line.dealType);
+        output += "\"}";
+    }
+    output += "],\"deals\":[";
+    for (std::size_t i = 0; i < receipt.deals.size(); ++i) {
+        const DealApplication& application = receipt.deals[i];
+        output += i == 0 ? "{\"type\":\"" : ",{\"type\":\"";
+        output += dealTypeKey(application.deal->getType());
+        output += "\",\"name\":";
+        appendJsonString(output, application.deal->getName());
+        output += ",\"item\":";
+        appendJsonString(output, items[application.itemIndex].getId());
+        output += ",\"sets\":";
+        output += std::to_string(application.sets);
+        output += ",\"discount\":";
+        output += application.discount.toString();
+        output += '}';
+    }
+    output += "],\"units\":";
+    output += std::to_string(receipt.units);
+    output += ",\"subtotal\":";
+    output += receipt.preDiscount.toString();
+    output += ",\"savings\":";
+    output += receipt.savings.toString();
+    output += ",\"total\":";
+    output += receipt.total.toString();
+    output += "}\n";
+}
+
+void ReceiptWriter::writeCsvHeader(std::string& output) {
+    output += "receipt,item_id,name,quantity,unit_price,subtotal,discount,total,deal,deal_name\n";
+}
+
+void ReceiptWriter::writeCsv(const Receipt& receipt, std::string& output) {
+    const std::vector<Item>& items = receipt.catalog->getItems();
+    std::string number = std::to_string(receipt.number);
+
+    for (const ReceiptLine& line : receipt.lines) {
+        const Item& item = items[line.itemIndex];
+        output += number;
+        output += ',';
+        appendCsvField(output, item.getId());
+        output += ',';
+        appendCsvField(output, item.getName());
+        output += ',';
+        output += std::to_string(line.quantity);
+        output += ',';
+        output += line.unitPrice.toString();
+        output += ',';
+        output += line.preDiscount.toString();
+        output += ',';
+        output += line.discount.toString();
+        output += ',';
+        output += line.total.toString();
+        output += ',';
+        output += dealTypeKey(line.dealType);
+        output += ',';
+        if (line.deal != nullptr) {
+            appendCsvField(output, line.deal->getName());
+        }
+        output += '\n';
+    }
+}
+
+void ReceiptWriter::writeBinary(const Receipt& receipt, std::string& output) {
+    BinaryHeader header = {};
+    std::memcpy(header.magic, "RCP1", sizeof(header.magic));
+    header.lineCount = static_cast<std::uint32_t>(receipt.lines.size());
+    header.dealCount = static_cast<std::uint32_t>(receipt.deals.size());
+    header.units = receipt.units;
+    header.number = receipt.number;
+    header.preDiscount = receipt.preDiscount.getCents();
+    header.savings = receipt.savings.getCents();
+    header.total = receipt.total.getCents();
+
+    output.reserve(output.size() + sizeof(BinaryHeader) + receipt.lines.size() * sizeof(BinaryLine) +
+                   receipt.deals.size() * sizeof(BinaryDeal));
+    appendRecord(output, header);
+
+    for (const ReceiptLine& line : receipt.lines) {
+        BinaryLine record = {};
+        record.itemIndex = line.itemIndex;
+        record.quantity = line.quantity;
+        record.unitPrice = line.unitPrice.getCents();
+        record.discount = line.discount.getCents();
+        record.total = line.total.getCents();
+        record.dealType = static_cast<std::uint8_t>(line.dealType);
+        appendRecord(output, record);
+    }
+
+    for (const DealApplication& application : receipt.deals) {
+        BinaryDeal record = {};
+        record.dealType = static_cast<std::uint8_t>(application.deal->getType());
+        record.itemIndex = application.itemIndex;
+        record.sets = application.sets;
+        record.dealIndex = dealIndexOf(*receipt.catalog, application);
+        record.discount = application.discount.getCents();
+        appendRecord(output, record);
+    }
+}
@@ -0,0 +1,205 @@
+// ReplayDriver.cpp
+#include "ReplayDriver.h"
+#include <algorithm>
+
+namespace {
+
+// Blank lines and "done" end a basket; surrounding whitespace is ignored
+bool isBasketEnd(std::string_view line) {
+    const char* whitespace = " \t\n\r\f\v";
+    std::size_t start = line.find_first_not_of(whitespace);
+    if (start == std::string_view::npos) {
+        return true;
+    }
+    std::size_t end = line.find_last_not_of(whitespace);
+    return line.substr(start, end - start + 1) == "done";
+}
+
+} // namespace
+
+ReplayDriver::ReplayDriver(std::shared_ptr<const Catalog> catalog, DealStrategy strategy, unsigned threads) {
+    if (threads != 1) {
+        pool = std::make_unique<WorkStealingPool>(threads);
+        threads = pool->size();
+    }
+
+    sessions.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) {
+        sessions.emplace_back(catalog);
+        sessions.back().setSink(nullptr);
+        sessions.back().setDealStrategy(strategy);
+    }
+    receipts.resize(threads);
+}
+
+void ReplayDriver::setFormat(Format newFormat) {
+    format = newFormat;
+}
+
+unsigned ReplayDriver::getThreadCount() const {
+    return static_cast<unsigned>(sessions.size());
+}
+
+ReplayDriver::Summary ReplayDriver::run(std::istream& input, std::ostream& output) {
+    if (format == Format::CSV) {
+        std::string header;
+        ReceiptWriter::writeCsvHeader(header);
+        output.write(header.data(), static_cast<std::streamsize>(header.size()));
+    }
+    Summary summary = pool ? runParallel(input, output) : runSerial(input, output);
+    output.flush();
+    return summary;
+}
+
+ReplayDriver::Summary ReplayDriver::runSerial(std::istream& input, std::ostream& output) {
+    Summary summary;
+
+    // Scan lines of the current basket; line strings are reused between baskets
+    std::vector<std::string> lines;
+    std::size_t lineCount = 0;
+    std::string line;
+    std::string result;
+
+    auto finishBasket = [&]() {
+        ++summary.baskets;
+        result.clear();
+        priceBasket(0, summary.baskets, lines.data(), lines.data() + lineCount, result);
+        output.write(result.data(), static_cast<std::streamsize>(result.size()));
+        lineCount = 0;
+    };
+
+    while (std::getline(input, line)) {
+        if (isBasketEnd(line)) {
+            if (lineCount > 0) {
+                finishBasket();
+            }
+            continue;
+        }
+        if (lineCount == lines.size()) {
+            lines.emplace_back();
+        }
+        lines[lineCount++].swap(line);
+        ++summary.scans;
+    }
+    if (lineCount > 0) {
+        finishBasket();
+    }
+    return summary;
+}
+
+ReplayDriver::Summary ReplayDriver::runParallel(std::istream& input, std::ostream& output) {
+    Summary summary;
+
+    // Scan lines of the chunk, and where each basket's lines end
+    std::vector<std::string> lines;
+    std::vector<std::size_t> basketEnds;
+    std::vector<std::string> batchResults;
+    std::size_t lineCount = 0;
+    std::string line;
+    bool more = true;
+
+    while (more) {
+        // Read up to CHUNK_BASKETS baskets; line strings are reused between chunks
+        lineCount = 0;
+        basketEnds.clear();
+        while (basketEnds.size() < CHUNK_BASKETS) {
+            more = static_cast<bool>(std::getline(input, line));
+            bool end = !more || isBasketEnd(line);
+            if (end) {
+                if (lineCount > (basketEnds.empty() ? 0 : basketEnds.back())) {
+                    basketEnds.push_back(lineCount);
+                }
+                if (!more) {
+                    break;
+                }
+                continue;
+            }
+            if (lineCount == lines.size()) {
+                lines.emplace_back();
+            }
+            lines[lineCount++].swap(line);
+        }
+        if (basketEnds.empty()) {
+            continue;
+        }
+
+        // Price the chunk in batches; each batch writes to its own buffer
+        std::size_t batchCount = (basketEnds.size() + BATCH_BASKETS - 1) / BATCH_BASKETS;
+        if (batchResults.size() < batchCount) {
+            batchResults.resize(batchCount);
+        }
+        std::uint64_t firstBasket = summary.baskets + 1;
+        pool->parallelFor(batchCount, [&](unsigned worker, std::size_t batch) {
+            std::string& result = batchResults[batch];
+            result.clear();
+            std::size_t first = batch * BATCH_BASKETS;
+            std::size_t last = std::min(first + BATCH_BASKETS, basketEnds.size());
+            for (std::size_t b = first; b < last; ++b) {
+                std::size_t begin = b == 0 ? 0 : basketEnds[b - 1];
+                priceBasket(worker, firstBasket + b, lines.data() + begin, lines.data() + basketEnds[b],
+                            result);
+            }
+        });
+
+        // Merge in input order
+        for (std::size_t batch = 0; batch < batchCount; ++batch) {
+            output.write(batchResults[batch].data(), static_cast<std::streamsize>(batchResults[batch].size()));
+        }
+        summary.baskets += basketEnds.size();
+        summary.scans += basketEnds.back();
+    }
+    return summary;
+}
+
+void ReplayDriver::priceBasket(unsigned worker, std::uint64_t basket, const std::string* begin,
+                               const std::string* end, std::string& result) {
+    Checkout& checkout = sessions[worker];
+    checkout.newBasket();
+    for (const std::string* line = begin; line != end; ++line) {
+        checkout.scanItem(*line);
+    }
+    checkout.applyDeals();
+
+    if (format == Format::SUMMARY) {
+        formatResult(basket, checkout, result);
+        result += '\n';
+        return;
+    }
+
+    Receipt& receipt = receipts[worker];
+    checkout.buildReceipt(receipt);
+    receipt.number = basket;
+    switch (format) {
+    case Format::TEXT:
+        ReceiptWriter::writeText(receipt, result);
+        break;
+    case Format::JSON_LINES:
+        ReceiptWriter::writeJsonLine(receipt, result);
+        break;
+    case Format::CSV:
+        ReceiptWriter::writeCsv(receipt, result);
+        break;
+    default:
+        ReceiptWriter::writeBinary(receipt, result);
+        break;
+    }
+}
+
+void ReplayDriver::formatResult(std::uint64_t basket, const Checkout& checkout, std::string& result) {
+    Checkout::Totals totals = checkout.getTotals();
+    result += "{\"basket\":";
+    result += std::to_string(basket);
+    result += ",\"lines\":";
+    result += std::to_string(totals.lines);
+    result += ",\"units\":";
+    result += std::to_string(totals.units);
+    result += ",\"subtotal\":";
+    result += totals.preDiscount.toString();
+    result += ",\"savings\":";
+    result += totals.savings.toString();
+    result += ",\"total\":";
+    result += totals.total.toString();
+    result += ",\"deals\":";
+    result += std::to_string(totals.deals);
+    result += '}';
+}
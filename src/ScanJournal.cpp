@@ -0,0 +1,304 @@
+// ScanJournal.cpp
+#include "ScanJournal.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(ScanJournal::RecordHeader) == 16, "ScanJournal::RecordHeader must be 16 bytes");
+
+namespace {
+
+constexpr std::size_t FILE_HEADER_SIZE = sizeof(ScanJournal::MAGIC) + sizeof(std::uint32_t);
+
+std::uint32_t fnv1a(const char* bytes, std::size_t length) {
+    std::uint32_t hash = 0x811c9dc5u;
+    for (std::size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<unsigned char>(bytes[i]);
+        hash *= 0x01000193u;
+    }
+    return hash;
+}
+
+[[noreturn]] void throwJournalError(const std::string& what, const std::string& path) {
+    throw std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+}
+
+#ifdef _WIN32
+
+int openFile(const std::string& path, bool truncate) {
+    return ::_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_BINARY | (truncate ? _O_TRUNC : _O_APPEND),
+                   _S_IREAD | _S_IWRITE);
+}
+
+int syncFile(int fd) {
+    return ::_commit(fd);
+}
+
+int closeFile(int fd) {
+    return ::_close(fd);
+}
+
+int truncateFile(int fd, std::uint64_t size) {
+    return ::_chsize_s(fd, static_cast<__int64>(size)) == 0 ? 0 : -1;
+}
+
+bool writeAll(int fd, const char* data, std::size_t size) {
+    while (size > 0) {
+        int written = ::_write(fd, data, static_cast<unsigned>(std::min<std::size_t>(size, 1u << 30)));
+        if (written < 0) {
+            return false;
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+bool replaceFile(const std::string& from, const std::string& to) {
+    std::remove(to.c_str());
+    return std::rename(from.c_str(), to.c_str()) == 0;
+}
+
+#else
+
+int openFile(const std::string& path, bool truncate) {
+    return ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | (truncate ? O_TRUNC : O_APPEND), 0644);
+}
+
+int syncFile(int fd) {
+#ifdef __linux__
+    // Only the data and the file size have to reach the disk
+    return ::fdatasync(fd);
+#else
+    return ::fsync(fd);
+#endif
+}
+
+int closeFile(int fd) {
+    return ::close(fd);
+}
+
+int truncateFile(int fd, std::uint64_t size) {
+    return ::ftruncate(fd, static_cast<off_t>(size));
+}
+
+bool writeAll(int fd, const char* data, std::size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+bool replaceFile(const std::string& from, const std::string& to) {
+    if (::rename(from.c_str(), to.c_str()) != 0) {
+        return false;
+    }
+
+    // Make the rename itself durable
+    std::size_t slash = to.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : to.substr(0, slash);
+    int directoryFd = ::open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (directoryFd >= 0) {
+        ::fsync(directoryFd);
+        ::close(directoryFd);
+    }
+    return true;
+}
+
+#endif
+
+} // namespace
+
+ScanJournal::ScanJournal(const std::string& path) : path(path) {
+    recover();
+    compact();
+
+    fd = openFile(path, false);
+    if (fd < 0) {
+        throwJournalError("Cannot open journal", path);
+    }
+}
+
+ScanJournal::~ScanJournal() {
+    try {
+        commit();
+    } catch (const std::exception&) {
+        // Nothing more can be done for records that cannot be written
+    }
+    if (fd >= 0) {
+        closeFile(fd);
+    }
+}
+
+const std::map<std::uint32_t, std::vector<ScanJournal::CartLine>>& ScanJournal::getRecoveredCarts() const {
+    return recoveredCarts;
+}
+
+std::vector<ScanJournal::CartLine> ScanJournal::takeRecoveredCart(std::uint32_t lane) {
+    auto it = recoveredCarts.find(lane);
+    if (it == recoveredCarts.end()) {
+        return {};
+    }
+    std::vector<CartLine> cart = std::move(it->second);
+    recoveredCarts.erase(it);
+    return cart;
+}
+
+void ScanJournal::recordQuantity(std::uint32_t lane, std::string_view itemId, int quantity) {
+    appendRecord(pending, RecordType::QUANTITY, lane, itemId, quantity);
+}
+
+void ScanJournal::recordBasketClosed(std::uint32_t lane) {
+    appendRecord(pending, RecordType::BASKET_CLOSED, lane, std::string_view(), 0);
+}
+
+bool ScanJournal::hasPending() const {
+    return !pending.empty();
+}
+
+void ScanJournal::commit() {
+    if (pending.empty()) {
+        return;
+    }
+
+    // A failed commit that could not cut off what it wrote gets another try before anything is appended
+    if (torn) {
+        if (truncateFile(fd, committedSize) != 0) {
+            throwJournalError("Cannot truncate journal", path);
+        }
+        torn = false;
+    }
+    if (!writeAll(fd, pending.data(), pending.size()) || syncFile(fd) != 0) {
+        // Part of the records may be in the file; cut them off so a retry does not append after a torn record
+        int error = errno;
+        torn = truncateFile(fd, committedSize) != 0;
+        errno = error;
+        throwJournalError("Cannot write journal", path);
+    }
+    committedSize += pending.size();
+    pending.clear();
+}
+
+void ScanJournal::appendRecord(std::string& buffer, RecordType type, std::uint32_t lane, std::string_view itemId,
+                               int quantity) {
+    if (itemId.size() > 0xFFFF) {
+        throw std::invalid_argument("Item ID is too long to journal.");
+    }
+    RecordHeader header = {};
+    header.lane = lane;
+    header.quantity = quantity;
+    header.type = static_cast<std::uint8_t>(type);
+    header.idLength = static_cast<std::uint16_t>(itemId.size());
+
+    // The checksum covers everything after itself, so it is filled in once the record is in place
+    std::size_t start = buffer.size();
+    buffer.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    buffer.append(itemId.data(), itemId.size());
+    header.checksum = fnv1a(buffer.data() + start + sizeof(header.checksum),
+                            buffer.size() - start - sizeof(header.checksum));
+    std::memcpy(&buffer[start], &header.checksum, sizeof(header.checksum));
+}
+
+void ScanJournal::recover() {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return;
+    }
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (contents.empty()) {
+        return;
+    }
+
+    std::uint32_t version = 0;
+    if (contents.size() >= FILE_HEADER_SIZE) {
+        std::memcpy(&version, contents.data() + sizeof(MAGIC), sizeof(version));
+    }
+    if (contents.size() < FILE_HEADER_SIZE || std::memcmp(contents.data(), MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("Not a scan journal: " + path);
+    }
+    if (version != FORMAT_VERSION) {
+        throw std::runtime_error("Unsupported scan journal version " + std::to_string(version) + ": " + path);
+    }
+
+    // Replay records up to the first one that is incomplete or fails its checksum
+    std::size_t offset = FILE_HEADER_SIZE;
+    while (contents.size() - offset >= sizeof(RecordHeader)) {
+        RecordHeader header;
+        std::memcpy(&header, contents.data() + offset, sizeof(header));
+        std::size_t size = sizeof(header) + header.idLength;
+        if (contents.size() - offset < size ||
+            fnv1a(contents.data() + offset + sizeof(header.checksum), size - sizeof(header.checksum)) !=
+                header.checksum) {
+            break;
+        }
+        std::string_view itemId(contents.data() + offset + sizeof(header), header.idLength);
+        offset += size;
+
+        if (header.type == static_cast<std::uint8_t>(RecordType::BASKET_CLOSED)) {
+            recoveredCarts.erase(header.lane);
+            continue;
+        }
+        if (header.type != static_cast<std::uint8_t>(RecordType::QUANTITY)) {
+            continue;
+        }
+        std::vector<CartLine>& cart = recoveredCarts[header.lane];
+        auto line = std::find_if(cart.begin(), cart.end(), [&](const CartLine& l) { return l.itemId == itemId; });
+        if (header.quantity <= 0) {
+            if (line != cart.end()) {
+                cart.erase(line);
+            }
+        } else if (line != cart.end()) {
+            line->quantity = header.quantity;
+        } else {
+            cart.push_back(CartLine{std::string(itemId), header.quantity});
+        }
+        if (cart.empty()) {
+            recoveredCarts.erase(header.lane);
+        }
+    }
+}
+
+void ScanJournal::compact() {
+    std::string contents(MAGIC, sizeof(MAGIC));
+    std::uint32_t version = FORMAT_VERSION;
+    contents.append(reinterpret_cast<const char*>(&version), sizeof(version));
+    for (const auto& entry : recoveredCarts) {
+        for (const CartLine& line : entry.second) {
+            appendRecord(contents, RecordType::QUANTITY, entry.first, line.itemId, line.quantity);
+        }
+    }
+
+    // Write the new journal beside the old one and swap it in, so a crash leaves one or the other
+    std::string temporaryPath = path + ".tmp";
+    int temporaryFd = openFile(temporaryPath, true);
+    if (temporaryFd < 0) {
+        throwJournalError("Cannot create journal", temporaryPath);
+    }
+    bool written = writeAll(temporaryFd, contents.data(), contents.size()) && syncFile(temporaryFd) == 0;
+    closeFile(temporaryFd);
+    if (!written || !replaceFile(temporaryPath, path)) {
+        throwJournalError("Cannot write journal", path);
+    }
+    committedSize = contents.size();
+}
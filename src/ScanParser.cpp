@@ -0,0 +1,96 @@
+// ScanParser.cpp
+#include "ScanParser.h"
+#include <climits>
+#include <cstdint>
+
+namespace {
+
+// Matches the character classes used by the original "\s", "[A-Za-z0-9]" and "\d" pattern
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+inline bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+inline bool isAlnum(char c) {
+    return isDigit(c) || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+}
+
+constexpr std::size_t MAX_ID_LENGTH = 5;
+
+} // namespace
+
+ScanCommand parseScanLine(std::string_view input) noexcept {
+    ScanCommand command;
+
+    // Trim whitespace
+    std::size_t begin = 0;
+    std::size_t end = input.size();
+    while (begin < end && isSpace(input[begin])) {
+        ++begin;
+    }
+    while (end > begin && isSpace(input[end - 1])) {
+        --end;
+    }
+
+    if (input.substr(begin, end - begin) == "help") {
+        command.type = ScanCommandType::HELP;
+        return command;
+    }
+
+    // Item ID: 1 to 5 alphanumeric characters. Taking the longest run is always correct:
+    // if a shorter ID matched, the characters after it would have to be digits anyway.
+    std::size_t pos = begin;
+    while (pos < end && pos - begin < MAX_ID_LENGTH && isAlnum(input[pos])) {
+        ++pos;
+    }
+    if (pos == begin) {
+        command.error = ScanParseError::INVALID_FORMAT;
+        return command;
+    }
+    command.itemId = input.substr(begin, pos - begin);
+
+    // Optional whitespace, then an optional quantity
+    while (pos < end && isSpace(input[pos])) {
+        ++pos;
+    }
+    if (pos == end) {
+        return command;
+    }
+
+    bool negative = false;
+    if (input[pos] == '-') {
+        negative = true;
+        ++pos;
+    }
+    if (pos == end) {
+        command.error = ScanParseError::INVALID_FORMAT;
+        return command;
+    }
+
+    // Accumulate the magnitude, remembering overflow but still checking the remaining characters
+    const std::uint64_t limit = negative ? std::uint64_t(INT_MAX) + 1 : std::uint64_t(INT_MAX);
+    std::uint64_t magnitude = 0;
+    bool outOfRange = false;
+    for (; pos < end; ++pos) {
+        char c = input[pos];
+        if (!isDigit(c)) {
+            command.error = ScanParseError::INVALID_FORMAT;
+            return command;
+        }
+        if (!outOfRange) {
+            magnitude = magnitude * 10 + static_cast<std::uint64_t>(c - '0');
+            outOfRange = magnitude > limit;
+        }
+    }
+
+    if (outOfRange) {
+        command.error = ScanParseError::QUANTITY_OUT_OF_RANGE;
+        return command;
+    }
+
+    command.quantity = negative ? static_cast<int>(-static_cast<std::int64_t>(magnitude)) : static_cast<int>(magnitude);
+    return command;
+}
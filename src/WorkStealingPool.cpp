@@ -0,0 +1,118 @@
+// WorkStealingPool.cpp
+#include "WorkStealingPool.h"
+#include <algorithm>
+
+WorkStealingPool::WorkStealingPool(unsigned threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned i = 0; i < threads; ++i) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (unsigned i = 0; i < threads; ++i) {
+        workers.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+unsigned WorkStealingPool::size() const {
+    return static_cast<unsigned>(workers.size());
+}
+
+void WorkStealingPool::parallelFor(std::size_t count,
+                                   const std::function<void(unsigned worker, std::size_t index)>& task) {
+    if (count == 0) {
+        return;
+    }
+
+    // Contiguous blocks keep neighbouring tasks on one worker until stealing starts
+    std::size_t workerCount = queues.size();
+    for (std::size_t w = 0; w < workerCount; ++w) {
+        std::size_t begin = count * w / workerCount;
+        std::size_t end = count * (w + 1) / workerCount;
+        std::lock_guard<std::mutex> lock(queues[w]->mutex);
+        for (std::size_t i = begin; i < end; ++i) {
+            queues[w]->tasks.push_back(i);
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    job = &task;
+    error = nullptr;
+    running = static_cast<unsigned>(workerCount);
+    ++generation;
+    jobReady.notify_all();
+    jobDone.wait(lock, [this]() { return running == 0; });
+    job = nullptr;
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void WorkStealingPool::workerLoop(unsigned worker) {
+    std::uint64_t seen = 0;
+    while (true) {
+        const std::function<void(unsigned, std::size_t)>* task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobReady.wait(lock, [this, seen]() { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+            task = job;
+        }
+
+        std::size_t index;
+        while (nextTask(worker, index)) {
+            try {
+                (*task)(worker, index);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--running == 0) {
+            jobDone.notify_one();
+        }
+    }
+}
+
+bool WorkStealingPool::nextTask(unsigned worker, std::size_t& index) {
+    {
+        Queue& own = *queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            index = own.tasks.front();
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+
+    // Steal from the back of the other queues, starting with the next worker
+    for (std::size_t offset = 1; offset < queues.size(); ++offset) {
+        Queue& victim = *queues[(worker + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            index = victim.tasks.back();
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
@@ -1,16 +1,198 @@
 // main.cpp
 #include "Checkout.h"
+#include "CheckoutServer.h"
+#include "Metrics.h"
+#include "ReplayDriver.h"
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <string>
 
-int main() {
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program
+              << " [--data PATH] [--replay FILE|-] [--threads N] [--format NAME] [--serve SOCKET | --listen PORT]"
+              << " [--journal FILE] [--metrics]\n";
+    std::cerr << "  --data PATH      Catalog to load (JSON or binary), default ../data/data.json\n";
+    std::cerr << "  --replay FILE|-  Replay scanned baskets from FILE (or stdin) and print one JSON line per basket\n";
+    std::cerr << "  --threads N      Replay on N threads (0 = all hardware threads), default 1\n";
+    std::cerr << "  --format NAME    Replay output: summary (default), text, jsonl, csv or binary\n";
+    std::cerr << "  --serve SOCKET   Serve checkout lanes on a Unix domain socket\n";
+    std::cerr << "  --listen PORT    Serve checkout lanes on a localhost TCP port\n";
+    std::cerr << "  --journal FILE   Journal carts to FILE and recover the ones left in progress by a crash\n";
+    std::cerr << "  --metrics        Print latency histograms and counters to stderr on exit\n";
+}
+
+// Server to stop on SIGINT or SIGTERM, and to reload the catalog on SIGHUP
+CheckoutServer* runningServer = nullptr;
+
+void stopServer(int) {
+    if (runningServer != nullptr) {
+        runningServer->stop();
+    }
+}
+
+void reloadServerCatalog(int) {
+    if (runningServer != nullptr) {
+        runningServer->reloadCatalog();
+    }
+}
+
+bool parsePort(const char* text, std::uint16_t& port) {
+    char* end = nullptr;
+    unsigned long value = std::strtoul(text, &end, 10);
+    if (end == text || *end != '\0' || text[0] == '-' || value == 0 || value > 65535) {
+        return false;
+    }
+    port = static_cast<std::uint16_t>(value);
+    return true;
+}
+
+bool parseFormat(const std::string& text, ReplayDriver::Format& format) {
+    if (text == "summary") {
+        format = ReplayDriver::Format::SUMMARY;
+    } else if (text == "text") {
+        format = ReplayDriver::Format::TEXT;
+    } else if (text == "jsonl") {
+        format = ReplayDriver::Format::JSON_LINES;
+    } else if (text == "csv") {
+        format = ReplayDriver::Format::CSV;
+    } else if (text == "binary") {
+        format = ReplayDriver::Format::BINARY;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool parseThreadCount(const char* text, unsigned& threads) {
+    char* end = nullptr;
+    unsigned long value = std::strtoul(text, &end, 10);
+    if (end == text || *end != '\0' || text[0] == '-' || value > 1024) {
+        return false;
+    }
+    threads = static_cast<unsigned>(value);
+    return true;
+}
+
+// Writes the metrics report to stderr
+void printMetrics() {
+    std::string report;
+    Metrics::writeText(Metrics::snapshot(), report);
+    std::cerr << report;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string dataPath = "../data/data.json";
+    std::string replayPath;
+    std::string socketPath;
+    std::string journalPath;
+    std::uint16_t port = 0;
+    unsigned threads = 1;
+    bool metrics = false;
+    ReplayDriver::Format format = ReplayDriver::Format::SUMMARY;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if ((arg == "--data" || arg == "--replay") && i + 1 < argc) {
+            (arg == "--data" ? dataPath : replayPath) = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc && parseThreadCount(argv[i + 1], threads)) {
+            ++i;
+        } else if (arg == "--format" && i + 1 < argc && parseFormat(argv[i + 1], format)) {
+            ++i;
+        } else if (arg == "--metrics") {
+            metrics = true;
+        } else if (arg == "--journal" && i + 1 < argc) {
+            journalPath = argv[++i];
+        } else if (arg == "--serve" && i + 1 < argc && port == 0) {
+            socketPath = argv[++i];
+        } else if (arg == "--listen" && i + 1 < argc && socketPath.empty() && parsePort(argv[i + 1], port)) {
+            ++i;
+        } else {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Replayed baskets are not live carts, so there is nothing to journal
+    if (!journalPath.empty() && !replayPath.empty()) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
     try {
         Checkout checkout;
-        checkout.loadItemsAndDeals(std::string("../data/data.json"));
+        checkout.loadItemsAndDeals(dataPath);
+
+        std::shared_ptr<ScanJournal> journal;
+        if (!journalPath.empty()) {
+            journal = std::make_shared<ScanJournal>(journalPath);
+        }
+
+        // Daemon mode: one session per connected lane until SIGINT or SIGTERM; SIGHUP reloads the catalog
+        if (!socketPath.empty() || port != 0) {
+            auto store = std::make_shared<CatalogStore>(checkout.getCatalog());
+            std::unique_ptr<CheckoutServer> server = socketPath.empty()
+                                                         ? std::make_unique<CheckoutServer>(store, port)
+                                                         : std::make_unique<CheckoutServer>(store, socketPath);
+            if (journal) {
+                std::cerr << "Recovered " << journal->getRecoveredCarts().size() << " cart(s) from " << journalPath
+                          << "\n";
+                server->setJournal(journal);
+            }
+            server->setCatalogPath(dataPath);
+            runningServer = server.get();
+            std::signal(SIGINT, stopServer);
+            std::signal(SIGTERM, stopServer);
+            std::signal(SIGHUP, reloadServerCatalog);
+            std::cerr << "Serving checkout lanes on "
+                      << (socketPath.empty() ? "127.0.0.1:" + std::to_string(server->getPort()) : socketPath) << "\n";
+            server->run();
+            runningServer = nullptr;
+            if (metrics) {
+                printMetrics();
+            }
+            return EXIT_SUCCESS;
+        }
+
+        // Headless mode: no prompts, one result line per basket
+        if (!replayPath.empty()) {
+            std::ios::sync_with_stdio(false);
+            ReplayDriver driver(checkout.getCatalog(), DealStrategy::GREEDY, threads);
+            driver.setFormat(format);
+            if (replayPath == "-") {
+                driver.run(std::cin, std::cout);
+            } else {
+                std::ifstream replayFile(replayPath);
+                if (!replayFile) {
+                    std::cerr << "Cannot open replay file: " << replayPath << "\n";
+                    return EXIT_FAILURE;
+                }
+                driver.run(replayFile, std::cout);
+            }
+            if (metrics) {
+                std::cout.flush();
+                printMetrics();
+            }
+            return EXIT_SUCCESS;
+        }
 
         std::cout << "Welcome to the Supermarket Checkout System!\n";
         std::cout << "Type 'help' to see available commands and items.\n";
 
+        // The interactive checkout is lane 0; pick up where a crashed run left off
+        if (journal) {
+            std::size_t restored = checkout.restoreCart(journal->takeRecoveredCart(0));
+            if (restored > 0) {
+                std::cout << "Restored " << restored << " item(s) scanned before the last shutdown.\n";
+            }
+            checkout.setJournal(journal, 0);
+        }
+
         std::string input;
         while (true) {
             std::cout << "\nScan item (or 'done' to finish): ";
@@ -29,11 +211,24 @@ int main() {
             }
 
             checkout.scanItem(input);
+            if (journal) {
+                journal->commit();
+            }
         }
 
         checkout.applyDeals();
         checkout.generateReceipt();
 
+        // The basket is paid for; a restart should not bring it back
+        if (journal) {
+            checkout.newBasket();
+            journal->commit();
+        }
+        if (metrics) {
+            std::cout.flush();
+            printMetrics();
+        }
+
     } catch (const std::exception& e) {
         std::cerr << "An unexpected error occurred: " << e.what() << "\n";
         std::cerr << "Please contact support.\n";
@@ -41,4 +236,4 @@ int main() {
     }
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
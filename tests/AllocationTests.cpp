@@ -0,0 +1,169 @@
+// AllocationTests.cpp
+#include "catch.hpp"
+
+#include "BinaryCatalog.h"
+#include "Checkout.h"
+#include "Receipt.h"
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// The test binary counts every heap allocation made by the calling thread
+namespace {
+
+thread_local std::size_t allocationCount = 0;
+
+void* countedAllocate(std::size_t size) {
+    ++allocationCount;
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return countedAllocate(size);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+namespace {
+
+// Names longer than any small-string buffer, so a copy of one would allocate
+std::shared_ptr<const Catalog> allocationCatalog() {
+    return Catalog::fromJson(R"(
+    {
+      "items": [
+        {"id": "A1", "name": "Granny Smith Apples, loose, 1kg", "price": 1.00},
+        {"id": "B2", "name": "Fairtrade Bananas, bunch of six", "price": 0.50},
+        {"id": "C3", "name": "Cherry Tomatoes on the Vine, 250g", "price": 2.00},
+        {"id": "D4", "name": "Dark Chocolate 85% Cocoa, 100g", "price": 1.75}
+      ],
+      "deals": {
+        "deal_type_1": ["A1", "D4"],
+        "deal_type_2": [["A1", "B2", "C3"]]
+      }
+    }
+    )"_json);
+}
+
+} // namespace
+
+TEST_CASE("Pricing and printing a warm basket makes no heap allocations", "[Allocation]") {
+    Checkout checkout(allocationCatalog());
+    checkout.setSink(nullptr);
+    checkout.scanItem("A1 4");
+    checkout.scanItem("B2 2");
+    checkout.scanItem("C3");
+    checkout.scanItem("D4 6");
+
+    // The first pass sizes the scratch lists, the receipt and the text buffer
+    Receipt receipt;
+    std::string text;
+    checkout.applyDeals();
+    checkout.buildReceipt(receipt);
+    ReceiptWriter::writeText(receipt, text);
+    std::string expected = text;
+
+    // Rescanning lines already in the cart reprices them in place
+    std::size_t before = allocationCount;
+    checkout.scanItem("C3 1");
+    checkout.scanItem("c3 -1");
+    checkout.applyDeals();
+    checkout.buildReceipt(receipt);
+    text.clear();
+    ReceiptWriter::writeText(receipt, text);
+    std::size_t allocations = allocationCount - before;
+
+    REQUIRE(allocations == 0);
+    REQUIRE(text == expected);
+    REQUIRE(text.find("Granny Smith Apples, loose, 1kg x4") != std::string::npos);
+    REQUIRE(text.find("Deal Type 2 applied to Granny Smith Apples, loose, 1kg, Fairtrade Bananas, bunch of six, "
+                      "Cherry Tomatoes on the Vine, 250g (-$0.50)") != std::string::npos);
+
+    // The counter itself works
+    before = allocationCount;
+    std::string copy(receipt.catalog->getItem(0).getName());
+    REQUIRE(allocationCount - before == 1);
+}
+
+TEST_CASE("A lane pricing baskets it has seen before makes no heap allocations", "[Allocation]") {
+    const std::vector<std::vector<std::string>> baskets = {
+        {"A1 4", "B2 2", "C3", "D4 6"},
+        {"A1 3", "B2 3", "C3 3"},
+        {"D4 2", "A1", "D4 -1", "B2"},
+        {"C3 5", "A1 9", "B2 4", "D4 3", "C3 -2"},
+    };
+
+    for (DealStrategy strategy : {DealStrategy::GREEDY, DealStrategy::OPTIMAL}) {
+        Checkout checkout(allocationCatalog());
+        checkout.setSink(nullptr);
+        checkout.setDealStrategy(strategy);
+        Receipt receipt;
+        std::string text;
+
+        // The first round sizes every reused list and the basket arena; the second must not allocate
+        std::size_t allocations[2] = {0, 0};
+        for (std::size_t& roundAllocations : allocations) {
+            std::size_t before = allocationCount;
+            for (const std::vector<std::string>& basket : baskets) {
+                checkout.newBasket();
+                for (const std::string& line : basket) {
+                    checkout.scanItem(line);
+                }
+                checkout.applyDeals();
+                checkout.buildReceipt(receipt);
+                text.clear();
+                ReceiptWriter::writeText(receipt, text);
+            }
+            roundAllocations = allocationCount - before;
+        }
+
+        REQUIRE(allocations[0] > 0);
+        REQUIRE(allocations[1] == 0);
+    }
+}
+
+TEST_CASE("Loading a binary catalog makes no per-item heap allocations", "[Allocation]") {
+    // Allocations for a small and a large catalog; IDs and names are longer than any small-string buffer
+    std::string path = "allocation-test-catalog.bin";
+    std::size_t allocations[2] = {0, 0};
+    std::uint32_t itemCounts[2] = {10, 5000};
+    for (int i = 0; i < 2; ++i) {
+        json data = R"({"items": [], "deals": {}})"_json;
+        for (std::uint32_t item = 0; item < itemCounts[i]; ++item) {
+            data["items"].push_back({{"id", "SKU-LONG-IDENTIFIER-" + std::to_string(100000 + item)},
+                                     {"name", "Catalog item number " + std::to_string(item) + " with a long name"},
+                                     {"price", 1.25}});
+        }
+        BinaryCatalog::compile(data, path);
+
+        std::size_t before = allocationCount;
+        std::shared_ptr<const Catalog> catalog = Catalog::fromFile(path);
+        allocations[i] = allocationCount - before;
+        REQUIRE(catalog->getItemCount() == itemCounts[i]);
+        REQUIRE(catalog->getItem(itemCounts[i] - 1).getName().size() > 32);
+    }
+    REQUIRE(allocations[1] == allocations[0]);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,73 @@
+// BasketArenaTests.cpp
+#include "catch.hpp"
+
+#include "BasketArena.h"
+#include "DealSolver.h"
+#include <cstdint>
+#include <vector>
+
+TEST_CASE("BasketArena hands out aligned memory from its block", "[BasketArena]") {
+    BasketArena arena(256);
+    void* first = arena.allocate(3, 1);
+    void* second = arena.allocate(16, 16);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(second) % 16 == 0);
+    REQUIRE(static_cast<char*>(second) >= static_cast<char*>(first) + 3);
+    REQUIRE(arena.getUsed() >= 19);
+    REQUIRE(arena.getUsed() <= 256);
+
+    // Deallocation is a no-op; release() makes the whole block available again
+    arena.deallocate(second, 16, 16);
+    arena.release();
+    REQUIRE(arena.getUsed() == 0);
+    REQUIRE(arena.allocate(3, 1) == first);
+    REQUIRE(arena.getCapacity() == 256);
+}
+
+TEST_CASE("BasketArena grows its block after a basket overflows it", "[BasketArena]") {
+    BasketArena arena(64);
+    {
+        std::pmr::vector<std::uint64_t> values(&arena);
+        for (std::uint64_t i = 0; i < 100; ++i) {
+            values.push_back(i);
+        }
+        REQUIRE(values[99] == 99);
+        REQUIRE(arena.getUsed() > 64);
+    }
+    arena.release();
+    REQUIRE(arena.getCapacity() > 64);
+    REQUIRE(arena.getUsed() == 0);
+
+    // The same basket now fits without overflowing
+    std::size_t capacity = arena.getCapacity();
+    {
+        std::pmr::vector<std::uint64_t> values(&arena);
+        for (std::uint64_t i = 0; i < 100; ++i) {
+            values.push_back(i);
+        }
+        REQUIRE(arena.getUsed() <= capacity);
+    }
+    arena.release();
+    REQUIRE(arena.getCapacity() == capacity);
+}
+
+TEST_CASE("DealSolver allocates its result from the given arena", "[BasketArena]") {
+    Item apple("A1", "Apple", 1.00);
+    Item banana("B2", "Banana", 0.50);
+    Item cherry("C3", "Cherry", 2.00);
+    DealType1 appleThreeForTwo({0});
+    DealType2 mixAndMatch({0, 1, 2});
+
+    PricedBasket basket;
+    basket.setLine(0, 4, apple.getPrice());
+    basket.setLine(1, 1, banana.getPrice());
+    basket.setLine(2, 1, cherry.getPrice());
+
+    BasketArena arena;
+    DealSolver solver;
+    DealSolver::Result result = solver.solve(basket, {&appleThreeForTwo, &mixAndMatch}, &arena);
+    REQUIRE(result.sets.get_allocator().resource() == &arena);
+    REQUIRE(arena.getUsed() > 0);
+    REQUIRE(result.sets[0] == 1);
+    REQUIRE(result.sets[1] == 1);
+    REQUIRE(result.savings == Money::fromCents(150));
+}
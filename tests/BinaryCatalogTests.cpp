@@ -0,0 +1,82 @@
+// BinaryCatalogTests.cpp
+#include "catch.hpp"
+
+#include "BinaryCatalog.h"
+#include "Checkout.h"
+#include "TestCatalogs.h"
+#include <cstdio>
+#include <fstream>
+
+TEST_CASE("BinaryCatalog round-trips a JSON catalog", "[BinaryCatalog]") {
+    const std::string path = "binary_catalog_test.bin";
+    BinaryCatalog::compile(test::fruitCatalogData(), path);
+    REQUIRE(BinaryCatalog::isBinaryCatalog(path));
+
+    {
+        BinaryCatalog catalog(path);
+        REQUIRE(catalog.getItemCount() == 3);
+
+        // Records are sorted by ID
+        REQUIRE(catalog.getItem(0).id == "A1");
+        REQUIRE(catalog.getItem(2).id == "C3");
+
+        std::uint32_t banana = catalog.findItem("B2");
+        REQUIRE(banana == 1);
+        REQUIRE(catalog.getItem(banana).name == "Banana");
+        REQUIRE(catalog.getItem(banana).price == Money::fromCents(50));
+        REQUIRE(catalog.findItem("Z9") == BinaryCatalog::NO_ITEM);
+
+        REQUIRE(catalog.getDealType1Count() == 1);
+        REQUIRE(catalog.getDealType1Items()[0] == 0);
+        REQUIRE(catalog.getDealType2Count() == 1);
+        BinaryCatalog::DealType2View dealSet = catalog.getDealType2(0);
+        REQUIRE(dealSet.size == 3);
+        REQUIRE(dealSet.itemIndices[0] == 0);
+        REQUIRE(dealSet.itemIndices[2] == 2);
+    }
+
+    // A Checkout loaded from the image behaves like one loaded from JSON
+    Checkout fromBinary;
+    fromBinary.loadItemsAndDeals(path);
+    Checkout fromJson;
+    fromJson.loadItemsAndDeals(test::fruitCatalogData());
+    for (Checkout* checkout : {&fromBinary, &fromJson}) {
+        checkout->scanItem("A1 4");
+        checkout->scanItem("B2 1");
+        checkout->scanItem("C3 1");
+        checkout->applyDeals();
+    }
+    REQUIRE(fromBinary.getAppliedDeals() == fromJson.getAppliedDeals());
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("BinaryCatalog rejects corrupted images", "[BinaryCatalog]") {
+    const std::string path = "binary_catalog_corrupt.bin";
+    BinaryCatalog::compile(test::fruitCatalogData(), path);
+
+    // Flip a byte in the string table
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekg(-1, std::ios::end);
+        char last = 0;
+        file.read(&last, 1);
+        last ^= 0x20;
+        file.seekp(-1, std::ios::end);
+        file.write(&last, 1);
+    }
+    REQUIRE_THROWS_AS(BinaryCatalog(path), std::runtime_error);
+
+    // Unknown deal items are rejected at compile time
+    json badDeals = test::fruitCatalogData();
+    badDeals["deals"]["deal_type_1"] = {"Q9"};
+    REQUIRE_THROWS_AS(BinaryCatalog::compile(badDeals, path), InvalidDealException);
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("BinaryCatalog refuses catalogs with deal rules", "[BinaryCatalog]") {
+    json data = test::fruitCatalogData();
+    data["deals"]["rules"] = R"([{"kind": "n_for_m", "items": ["A1"], "n": 4, "m": 3}])"_json;
+    REQUIRE_THROWS_AS(BinaryCatalog::compile(data, "binary_catalog_rules_test.bin"), InvalidDealException);
+}
@@ -0,0 +1,93 @@
+// CatalogStoreTests.cpp
+#include "catch.hpp"
+
+#include "CatalogStore.h"
+#include "Checkout.h"
+#include "TestCatalogs.h"
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+TEST_CASE("CatalogStore publishes new catalogs", "[CatalogStore]") {
+    CatalogStore store(Catalog::fromJson(test::fruitCatalogData(1.00)));
+    REQUIRE(store.getVersion() == 1);
+
+    std::shared_ptr<const Catalog> pinned = store.current();
+    store.publish(Catalog::fromJson(test::fruitCatalogData(2.00)));
+    REQUIRE(store.getVersion() == 2);
+
+    // Readers holding the old catalog keep it; new readers see the replacement
+    REQUIRE(pinned->getItem(0).getPrice() == Money::fromCents(100));
+    REQUIRE(store.current()->getItem(0).getPrice() == Money::fromCents(200));
+
+    REQUIRE_THROWS_AS(store.publish(nullptr), std::invalid_argument);
+}
+
+TEST_CASE("CatalogStore keeps the current catalog when a reload fails", "[CatalogStore]") {
+    CatalogStore store(Catalog::fromJson(test::fruitCatalogData(1.00)));
+    std::shared_ptr<const Catalog> before = store.current();
+
+    REQUIRE_THROWS(store.reloadFromFile("no_such_catalog.json"));
+    REQUIRE_THROWS(store.reloadFromFileAsync("no_such_catalog.json").get());
+    REQUIRE(store.current() == before);
+    REQUIRE(store.getVersion() == 1);
+}
+
+TEST_CASE("Checkout sessions switch catalogs between baskets", "[CatalogStore]") {
+    const std::string path = "catalog_store_test.json";
+    std::ofstream(path) << test::fruitCatalogData(3.00).dump();
+
+    auto store = std::make_shared<CatalogStore>(Catalog::fromJson(test::fruitCatalogData(1.00)));
+    Checkout checkout(store);
+
+    std::ostringstream sink;
+    std::streambuf* original = std::cout.rdbuf(sink.rdbuf());
+    checkout.scanItem("A1 3");
+
+    // The reload lands while the basket is in progress
+    store->reloadFromFileAsync(path).get();
+    REQUIRE(store->getVersion() == 2);
+    checkout.applyDeals();
+    std::cout.rdbuf(original);
+
+    REQUIRE(checkout.getAppliedDeals() == std::vector<std::string>{"Deal Type 1 applied to 3 x Apple (-$1.00)"});
+
+    // The next basket picks up the new prices
+    checkout.newBasket();
+    REQUIRE(checkout.getCartQuantity("A1") == 0);
+    REQUIRE(checkout.getCatalog() == store->current());
+    REQUIRE(checkout.getCatalog()->getItem(0).getPrice() == Money::fromCents(300));
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("CatalogStore readers run while catalogs are published", "[CatalogStore]") {
+    CatalogStore store(Catalog::fromJson(test::fruitCatalogData(1.00)));
+    std::atomic<bool> stop(false);
+    std::atomic<bool> consistent(true);
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&]() {
+            while (!stop.load()) {
+                std::shared_ptr<const Catalog> catalog = store.current();
+                if (catalog->getItemCount() != 3 || catalog->findItem("B2") != 1) {
+                    consistent = false;
+                }
+            }
+        });
+    }
+    for (int i = 0; i < 200; ++i) {
+        store.publish(Catalog::fromJson(test::fruitCatalogData(1.00 + i)));
+    }
+    stop = true;
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+
+    REQUIRE(consistent);
+    REQUIRE(store.getVersion() == 201);
+}
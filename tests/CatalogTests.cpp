@@ -0,0 +1,144 @@
+// CatalogTests.cpp
+#include "catch.hpp"
+
+#include "Catalog.h"
+#include "Checkout.h"
+#include "CustomExceptions.h"
+#include "TestCatalogs.h"
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+TEST_CASE("Catalog indexes items and deals", "[Catalog]") {
+    std::shared_ptr<const Catalog> catalog = test::fruitCatalog();
+
+    REQUIRE(catalog->getItemCount() == 3);
+    REQUIRE(catalog->getItem(0).getId() == "A1");
+    REQUIRE(catalog->findItem("B2") == 1);
+    REQUIRE(catalog->findItem("b2") == ItemIndex::NOT_FOUND);
+    REQUIRE(catalog->findScannedItem("c3") == 2);
+    REQUIRE(catalog->findItem("Z9") == ItemIndex::NOT_FOUND);
+
+    // Deal Type 1 deals come first regardless of their order in the JSON
+    const auto& deals = catalog->getDeals();
+    REQUIRE(deals.size() == 2);
+    REQUIRE(deals[0]->getType() == DealType::TYPE1);
+    REQUIRE(deals[1]->getType() == DealType::TYPE2);
+    REQUIRE(catalog->getDealsForItem(0) == std::vector<std::uint32_t>{0, 1});
+    REQUIRE(catalog->getDealsForItem(1) == std::vector<std::uint32_t>{1});
+}
+
+TEST_CASE("Catalog compiles deal rules in stage order", "[Catalog]") {
+    json data = test::fruitCatalogData();
+    data["deals"]["rules"] = R"([
+      {"kind": "spend_threshold", "items": ["A1", "C3"], "tiers": [{"spend": 20.00, "percent_off": 10}, {"spend": 10.00, "percent_off": 5}]},
+      {"kind": "n_for_m", "items": ["B2", "C3"], "n": 3, "m": 2},
+      {"kind": "bundle", "items": ["B2", "C3"], "percent_off": 40, "name": "Pair deal"},
+      {"kind": "multi_buy", "items": ["B2"], "buy": 3, "get": 2, "percent_off": 25}
+    ])"_json;
+    std::shared_ptr<const Catalog> catalog = Catalog::fromJson(data);
+
+    // Single-item deals, then sets, then thresholds; load order within a stage
+    const auto& deals = catalog->getDeals();
+    REQUIRE(deals.size() == 7);
+    std::vector<std::string> names;
+    for (const auto& deal : deals) {
+        names.push_back(static_cast<const RuleDeal&>(*deal).getRule().name);
+    }
+    REQUIRE(names == std::vector<std::string>{"Deal Type 1", "Deal Type 1", "Deal Type 1", "Buy 3 get 2 at 25% off",
+                                              "Deal Type 2", "Pair deal", "Spend threshold"});
+
+    // A 3-for-2 rule is Deal Type 1; the tiers are sorted by threshold
+    REQUIRE(deals[1]->getType() == DealType::TYPE1);
+    REQUIRE(deals[3]->getType() == DealType::RULE);
+    const DealRule& spend = static_cast<const RuleDeal&>(*deals[6]).getRule();
+    REQUIRE(spend.op == DealRule::Op::TIERED_SPEND);
+    REQUIRE(spend.tiers[0].threshold == 1000);
+    REQUIRE(spend.tiers[1].percentOff == 10);
+    REQUIRE(catalog->getDealsForItem(2) == std::vector<std::uint32_t>{2, 4, 5, 6});
+}
+
+TEST_CASE("Catalog reports renamed rules of a classic shape as other rules", "[Catalog]") {
+    json data = test::fruitCatalogData();
+    data["deals"] = R"({"rules": [
+      {"kind": "multi_buy", "items": ["B2"], "buy": 2, "get": 1, "name": "Summer 3-for-2"},
+      {"kind": "bundle", "items": ["A1", "B2", "C3"], "name": "Picnic set"},
+      {"kind": "n_for_m", "items": ["C3"], "n": 3, "m": 2}
+    ]})"_json;
+    std::shared_ptr<const Catalog> catalog = Catalog::fromJson(data);
+
+    // Only rules that keep the classic name count as Deal Type 1 or Deal Type 2
+    const auto& deals = catalog->getDeals();
+    REQUIRE(deals.size() == 3);
+    REQUIRE(deals[0]->getType() == DealType::RULE);
+    REQUIRE(deals[1]->getType() == DealType::TYPE1);
+    REQUIRE(deals[2]->getType() == DealType::RULE);
+}
+
+TEST_CASE("Catalog rejects invalid data", "[Catalog]") {
+    json data = test::fruitCatalogData();
+    data["deals"]["deal_type_1"] = {"Z9"};
+    REQUIRE_THROWS_AS(Catalog::fromJson(data), InvalidDealException);
+
+    data = test::fruitCatalogData();
+    data.erase("items");
+    REQUIRE_THROWS_AS(Catalog::fromJson(data), InvalidItemException);
+
+    for (const char* rule : {R"({"kind": "multi_buy", "items": ["A1"], "buy": 2})",
+                             R"({"kind": "multi_buy", "items": ["A1"], "buy": 2, "get": 1, "percent_off": 0})",
+                             R"({"kind": "n_for_m", "items": ["A1"], "n": 3, "m": 3})",
+                             R"({"kind": "bundle", "items": ["A1", "A1"]})",
+                             R"({"kind": "bundle", "items": ["A1", "B2"], "discounted": 2})",
+                             R"({"kind": "tiered_bundle", "items": ["A1"], "tiers": []})",
+                             R"({"kind": "spend_threshold", "items": ["A1"], "tiers": [{"spend": 5.0}]})",
+                             R"({"kind": "free_lunch", "items": ["A1"]})",
+                             R"({"kind": "bundle", "items": ["A1", "Z9"]})"}) {
+        data = test::fruitCatalogData();
+        data["deals"]["rules"] = json::array({json::parse(rule)});
+        REQUIRE_THROWS_AS(Catalog::fromJson(data), InvalidDealException);
+    }
+
+    REQUIRE_THROWS_AS(Catalog::fromFile("no_such_catalog.json"), std::runtime_error);
+}
+
+TEST_CASE("Checkout sessions share one catalog across threads", "[Catalog]") {
+    std::shared_ptr<const Catalog> catalog = test::fruitCatalog();
+
+    // Scanning prints to std::cout, so the carts are filled up front and only pricing runs concurrently
+    const int threadCount = 8;
+    const int basketsPerThread = 50;
+    std::vector<std::vector<Checkout>> sessions(threadCount);
+    std::ostringstream sink;
+    std::streambuf* original = std::cout.rdbuf(sink.rdbuf());
+    for (std::vector<Checkout>& lane : sessions) {
+        for (int basket = 0; basket < basketsPerThread; ++basket) {
+            lane.emplace_back(catalog);
+            lane.back().scanItem("A1 4");
+            lane.back().scanItem("B2");
+            lane.back().scanItem("C3");
+        }
+    }
+    std::cout.rdbuf(original);
+
+    std::vector<std::thread> threads;
+    for (std::vector<Checkout>& lane : sessions) {
+        threads.emplace_back([&lane]() {
+            for (Checkout& checkout : lane) {
+                checkout.applyDeals();
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    const std::vector<std::string> expected = {"Deal Type 1 applied to 3 x Apple (-$1.00)",
+                                               "Deal Type 2 applied to Apple, Banana, Cherry (-$0.50)"};
+    bool allMatch = true;
+    for (const std::vector<Checkout>& lane : sessions) {
+        for (const Checkout& checkout : lane) {
+            allMatch = allMatch && checkout.getAppliedDeals() == expected && checkout.getCatalog() == catalog;
+        }
+    }
+    REQUIRE(allMatch);
+}
@@ -0,0 +1,346 @@
+// CheckoutServerTests.cpp
+#include "catch.hpp"
+
+#include "CheckoutServer.h"
+#include "OutputSink.h"
+#include "Receipt.h"
+#include "TestCatalogs.h"
+
+#ifdef __linux__
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <csignal>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <chrono>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+std::shared_ptr<CatalogStore> serverStore() {
+    return std::make_shared<CatalogStore>(test::fruitCatalog());
+}
+
+/**
+ * @brief Blocking lane client for the tests.
+ */
+class Lane {
+public:
+    explicit Lane(const std::string& socketPath) {
+        fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+        connected = ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+    }
+
+    explicit Lane(std::uint16_t port) {
+        fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        connected = ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+    }
+
+    ~Lane() {
+        ::close(fd);
+    }
+
+    // Sends one request and returns the response payload
+    std::string request(CheckoutServer::Command command, const std::string& argument = "") {
+        std::string frame(sizeof(std::uint32_t), '\0');
+        std::uint32_t length = static_cast<std::uint32_t>(argument.size() + 1);
+        std::memcpy(&frame[0], &length, sizeof(length));
+        frame += static_cast<char>(command);
+        frame += argument;
+        ::send(fd, frame.data(), frame.size(), 0);
+
+        std::string header = receive(sizeof(std::uint32_t));
+        std::memcpy(&length, header.data(), sizeof(length));
+        return receive(length);
+    }
+
+    std::string receive(std::size_t size) {
+        std::string data;
+        char buffer[4096];
+        while (data.size() < size) {
+            ssize_t received = ::recv(fd, buffer, std::min(sizeof(buffer), size - data.size()), 0);
+            if (received <= 0) {
+                break;
+            }
+            data.append(buffer, static_cast<std::size_t>(received));
+        }
+        return data;
+    }
+
+    int fd;
+    bool connected;
+};
+
+std::string laneNumber(std::uint32_t lane) {
+    return std::string(reinterpret_cast<const char*>(&lane), sizeof(lane));
+}
+
+CheckoutServer::TotalsRecord totalsOf(const std::string& response) {
+    CheckoutServer::TotalsRecord totals = {};
+    std::memcpy(&totals, response.data() + 1, sizeof(totals));
+    return totals;
+}
+
+} // namespace
+
+TEST_CASE("CheckoutServer serves lane sessions over a Unix domain socket", "[CheckoutServer]") {
+    std::string path = "/tmp/checkout-server-test-" + std::to_string(::getpid()) + ".sock";
+    CheckoutServer server(serverStore(), path);
+    std::thread loop([&server]() { server.run(); });
+
+    {
+        Lane lane(path);
+        Lane other(path);
+        REQUIRE(lane.connected);
+        REQUIRE(other.connected);
+
+        // A scan returns the running totals followed by its scan messages
+        std::string response = lane.request(CheckoutServer::Command::SCAN, "A1 3");
+        REQUIRE(response.size() == 1 + sizeof(CheckoutServer::TotalsRecord) + sizeof(BinarySink::Record));
+        REQUIRE(response[0] == static_cast<char>(CheckoutServer::Status::OK));
+        REQUIRE(totalsOf(response).units == 3);
+        REQUIRE(totalsOf(response).total == 200);
+
+        BinarySink::Record record;
+        std::memcpy(&record, response.data() + 1 + sizeof(CheckoutServer::TotalsRecord), sizeof(record));
+        REQUIRE(record.event == static_cast<std::uint8_t>(ScanEvent::QUANTITY_UPDATED));
+        REQUIRE(record.quantity == 3);
+
+        // Lanes have separate carts
+        other.request(CheckoutServer::Command::SCAN, "C3");
+        lane.request(CheckoutServer::Command::SCAN, "B2");
+        response = lane.request(CheckoutServer::Command::VOID_ITEM, "b2");
+        REQUIRE(totalsOf(response).units == 3);
+        REQUIRE(totalsOf(other.request(CheckoutServer::Command::TOTAL)).total == 200);
+
+        response = lane.request(CheckoutServer::Command::RECEIPT,
+                                std::string(1, static_cast<char>(CheckoutServer::ReceiptFormat::JSON_LINES)));
+        REQUIRE(response.substr(1, 14) == "{\"receipt\":1,\"");
+        REQUIRE(response.find("\"total\":2.00}") != std::string::npos);
+
+        // The receipt starts the next basket
+        REQUIRE(totalsOf(lane.request(CheckoutServer::Command::TOTAL)).units == 0);
+        REQUIRE(lane.request(static_cast<CheckoutServer::Command>(9))[0] ==
+                static_cast<char>(CheckoutServer::Status::BAD_REQUEST));
+    }
+
+    server.stop();
+    loop.join();
+}
+
+TEST_CASE("CheckoutServer serves lanes on a localhost TCP port", "[CheckoutServer]") {
+    CheckoutServer server(serverStore(), static_cast<std::uint16_t>(0));
+    REQUIRE(server.getPort() != 0);
+    std::thread loop([&server]() { server.run(); });
+
+    {
+        Lane lane(server.getPort());
+        REQUIRE(lane.connected);
+        lane.request(CheckoutServer::Command::SCAN, "A1 4");
+        lane.request(CheckoutServer::Command::SCAN, "B2");
+        lane.request(CheckoutServer::Command::SCAN, "C3");
+
+        std::string response = lane.request(CheckoutServer::Command::RECEIPT);
+        ReceiptWriter::BinaryHeader header;
+        std::memcpy(&header, response.data() + 1, sizeof(header));
+        REQUIRE(header.number == 1);
+        REQUIRE(header.lineCount == 3);
+        REQUIRE(header.savings == 150);
+    }
+
+    server.stop();
+    loop.join();
+}
+
+TEST_CASE("CheckoutServer stops reading from a lane that does not read its responses", "[CheckoutServer]") {
+    std::string path = "/tmp/checkout-server-test-" + std::to_string(::getpid()) + ".sock";
+    CheckoutServer server(serverStore(), path);
+    std::thread loop([&server]() { server.run(); });
+    {
+        Lane lane(path);
+        lane.request(CheckoutServer::Command::SCAN, "A1");
+
+        // Send TOTAL requests without reading until the server stops taking them for a while
+        std::string frame(sizeof(std::uint32_t), '\0');
+        std::uint32_t length = 1;
+        std::memcpy(&frame[0], &length, sizeof(length));
+        frame += static_cast<char>(CheckoutServer::Command::TOTAL);
+        std::string requests;
+        for (int i = 0; i < 1000; ++i) {
+            requests += frame;
+        }
+        std::size_t sent = 0;
+        bool stalled = false;
+        auto stallStart = std::chrono::steady_clock::now();
+        while (!stalled && sent < 1000000 * frame.size()) {
+            ssize_t result = ::send(lane.fd, requests.data() + sent % requests.size(),
+                                    requests.size() - sent % requests.size(), MSG_DONTWAIT);
+            if (result > 0) {
+                sent += static_cast<std::size_t>(result);
+                stallStart = std::chrono::steady_clock::now();
+            } else {
+                stalled = std::chrono::steady_clock::now() - stallStart > std::chrono::milliseconds(200);
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        REQUIRE(stalled);
+
+        // Reading the responses lets the server answer every request, in order
+        std::size_t complete = sent / frame.size();
+        std::size_t partial = sent % frame.size();
+        std::size_t responseSize = sizeof(std::uint32_t) + 1 + sizeof(CheckoutServer::TotalsRecord);
+        bool allTotals = true;
+        for (std::size_t answered = 0; answered < complete; ++answered) {
+            std::string response = lane.receive(responseSize);
+            allTotals = allTotals && response.size() == responseSize &&
+                        totalsOf(response.substr(sizeof(std::uint32_t))).units == 1;
+        }
+        REQUIRE(allTotals);
+        if (partial > 0) {
+            ::send(lane.fd, frame.data() + partial, frame.size() - partial, 0);
+            lane.receive(responseSize);
+        }
+        REQUIRE(totalsOf(lane.request(CheckoutServer::Command::TOTAL)).units == 1);
+    }
+    server.stop();
+    loop.join();
+}
+
+TEST_CASE("CheckoutServer reloads the catalog for the next basket", "[CheckoutServer]") {
+    std::string path = "/tmp/checkout-server-test-" + std::to_string(::getpid()) + ".sock";
+    std::string catalogPath = "checkout-server-test.json";
+    auto writeCatalog = [&catalogPath](const char* applePrice) {
+        std::ofstream(catalogPath) << R"({"items": [{"id": "A1", "name": "Apple", "price": )" << applePrice
+                                   << R"(}], "deals": {}})";
+    };
+    writeCatalog("1.00");
+
+    auto store = std::make_shared<CatalogStore>(Catalog::fromFile(catalogPath));
+    CheckoutServer server(store, path);
+    server.setCatalogPath(catalogPath);
+    std::thread loop([&server]() { server.run(); });
+    {
+        Lane lane(path);
+        REQUIRE(totalsOf(lane.request(CheckoutServer::Command::SCAN, "A1")).total == 100);
+
+        writeCatalog("1.50");
+        server.reloadCatalog();
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (store->getVersion() == 1 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        REQUIRE(store->getVersion() == 2);
+
+        // The basket in progress keeps its prices; the next one is priced from the reloaded file
+        REQUIRE(totalsOf(lane.request(CheckoutServer::Command::SCAN, "A1")).total == 200);
+        lane.request(CheckoutServer::Command::RECEIPT);
+        REQUIRE(totalsOf(lane.request(CheckoutServer::Command::SCAN, "A1")).total == 150);
+    }
+    server.stop();
+    loop.join();
+    std::remove(catalogPath.c_str());
+}
+
+TEST_CASE("CheckoutServer gives attached lanes their journaled carts back", "[CheckoutServer]") {
+    std::string path = "/tmp/checkout-server-test-" + std::to_string(::getpid()) + ".sock";
+    std::string journalPath = "checkout-server-test.wal";
+    std::remove(journalPath.c_str());
+
+    {
+        CheckoutServer server(serverStore(), path);
+        server.setJournal(std::make_shared<ScanJournal>(journalPath));
+        std::thread loop([&server]() { server.run(); });
+        {
+            Lane lane(path);
+            REQUIRE(totalsOf(lane.request(CheckoutServer::Command::ATTACH, laneNumber(3))).units == 0);
+            lane.request(CheckoutServer::Command::SCAN, "A1 2");
+
+            // A lane cannot be attached twice
+            Lane other(path);
+            REQUIRE(other.request(CheckoutServer::Command::ATTACH, laneNumber(3))[0] ==
+                    static_cast<char>(CheckoutServer::Status::BAD_REQUEST));
+        }
+        {
+            // Reconnecting mid-basket resumes the cart
+            Lane lane(path);
+            REQUIRE(totalsOf(lane.request(CheckoutServer::Command::ATTACH, laneNumber(3))).units == 2);
+            lane.request(CheckoutServer::Command::SCAN, "B2");
+            lane.request(CheckoutServer::Command::SCAN, "C3");
+        }
+        server.stop();
+        loop.join();
+    }
+
+    // The restarted daemon recovers the cart from the journal
+    CheckoutServer server(serverStore(), path);
+    server.setJournal(std::make_shared<ScanJournal>(journalPath));
+    std::thread loop([&server]() { server.run(); });
+    {
+        Lane lane(path);
+        CheckoutServer::TotalsRecord totals = totalsOf(lane.request(CheckoutServer::Command::ATTACH, laneNumber(3)));
+        REQUIRE(totals.units == 4);
+        REQUIRE(totals.total == 400);
+        lane.request(CheckoutServer::Command::RECEIPT);
+
+        Lane other(path);
+        REQUIRE(totalsOf(other.request(CheckoutServer::Command::ATTACH, laneNumber(4))).units == 0);
+    }
+    server.stop();
+    loop.join();
+    std::remove(journalPath.c_str());
+}
+
+TEST_CASE("CheckoutServer keeps serving when the journal cannot be committed", "[CheckoutServer]") {
+    std::string path = "/tmp/checkout-server-test-" + std::to_string(::getpid()) + ".sock";
+    std::string journalPath = "checkout-server-failed-test.wal";
+    std::remove(journalPath.c_str());
+
+    {
+        CheckoutServer server(serverStore(), path);
+        server.setJournal(std::make_shared<ScanJournal>(journalPath));
+        std::thread loop([&server]() { server.run(); });
+        {
+            Lane lane(path);
+            lane.request(CheckoutServer::Command::ATTACH, laneNumber(5));
+            REQUIRE(lane.request(CheckoutServer::Command::SCAN, "A1")[0] ==
+                    static_cast<char>(CheckoutServer::Status::OK));
+
+            // A file size limit makes the next commit fail part way through a record, like a full disk
+            std::streamoff committed = std::ifstream(journalPath, std::ios::binary | std::ios::ate).tellg();
+            rlimit original;
+            ::getrlimit(RLIMIT_FSIZE, &original);
+            rlimit limited = original;
+            limited.rlim_cur = static_cast<rlim_t>(committed) + 10;
+            auto previousHandler = std::signal(SIGXFSZ, SIG_IGN);
+            ::setrlimit(RLIMIT_FSIZE, &limited);
+            std::string response = lane.request(CheckoutServer::Command::SCAN, "B2");
+            ::setrlimit(RLIMIT_FSIZE, &original);
+            std::signal(SIGXFSZ, previousHandler);
+
+            // The scan was made but reported as not durable; the next commit writes it too
+            REQUIRE(response[0] == static_cast<char>(CheckoutServer::Status::JOURNAL_ERROR));
+            REQUIRE(totalsOf(response).units == 2);
+            REQUIRE(lane.request(CheckoutServer::Command::SCAN, "C3")[0] ==
+                    static_cast<char>(CheckoutServer::Status::OK));
+        }
+        server.stop();
+        loop.join();
+    }
+
+    ScanJournal journal(journalPath);
+    REQUIRE(journal.getRecoveredCarts().at(5).size() == 3);
+    std::remove(journalPath.c_str());
+}
+
+#endif
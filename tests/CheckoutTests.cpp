@@ -2,6 +2,8 @@
 #include "catch.hpp"
 #include "Checkout.h"
 #include "json.hpp"
+#include <random>
+#include <sstream>
 
 using json = nlohmann::json;
 
@@ -47,3 +49,207 @@ TEST_CASE_METHOD(CheckoutFixture, "Checkout process", "[Checkout]") {
     REQUIRE(checkout.getAppliedDeals()[0].find("Deal Type 1 applied to 3 x Apple") != std::string::npos);
     REQUIRE(checkout.getAppliedDeals()[1].find("Deal Type 2 applied to") != std::string::npos);
 }
+
+TEST_CASE_METHOD(CheckoutFixture, "Checkout cart quantities", "[Checkout]") {
+    // IDs are matched case-insensitively and quantities are clamped to [0, 100]
+    checkout.scanItem("a1 2");
+    checkout.scanItem("A1 150");
+    REQUIRE(checkout.getCartQuantity("A1") == 100);
+
+    checkout.scanItem("b2 1");
+    checkout.scanItem("B2 -5");
+    REQUIRE(checkout.getCartQuantity("B2") == 0);
+
+    checkout.scanItem("Z9 1");
+    REQUIRE(checkout.getCartQuantity("Z9") == 0);
+    REQUIRE(checkout.getCartQuantity("c3") == 0);
+}
+
+TEST_CASE("Checkout only applies deals touched by the cart, in type order", "[Checkout]") {
+    json data = R"(
+    {
+      "items": [
+        {"id": "A1", "name": "Apple", "price": 1.00},
+        {"id": "B2", "name": "Banana", "price": 0.50},
+        {"id": "C3", "name": "Cherry", "price": 2.00},
+        {"id": "D4", "name": "Date", "price": 3.00},
+        {"id": "E5", "name": "Elderberry", "price": 4.00}
+      ],
+      "deals": {
+        "deal_type_1": ["C3", "E5"],
+        "deal_type_2": [["B2", "D4", "E5"], ["A1", "B2", "C3"], ["A1", "D4", "E5"]]
+      }
+    }
+    )"_json;
+
+    Checkout checkout;
+    checkout.loadItemsAndDeals(data);
+    checkout.scanItem("B2 2");
+    checkout.scanItem("A1 1");
+    checkout.scanItem("C3 4");
+    checkout.applyDeals();
+
+    // Deal Type 1 on Cherry uses three of the four, leaving one for the A1/B2/C3 set
+    const std::vector<std::string>& appliedDeals = checkout.getAppliedDeals();
+    REQUIRE(appliedDeals.size() == 2);
+    REQUIRE(appliedDeals[0] == "Deal Type 1 applied to 3 x Cherry (-$2.00)");
+    REQUIRE(appliedDeals[1] == "Deal Type 2 applied to Apple, Banana, Cherry (-$0.50)");
+}
+
+TEST_CASE_METHOD(CheckoutFixture, "Checkout reports totals and can run quietly", "[Checkout]") {
+    std::ostringstream output;
+    checkout.setSink(std::make_shared<TextSink>(output));
+    checkout.scanItem("A1 4");
+    checkout.scanItem("C3");
+    REQUIRE(output.str() == "Updated Apple quantity to 4.\nUpdated Cherry quantity to 1.\n");
+
+    checkout.setSink(nullptr);
+    checkout.scanItem("B2");
+    checkout.applyDeals();
+    checkout.generateReceipt();
+    REQUIRE(output.str() == "Updated Apple quantity to 4.\nUpdated Cherry quantity to 1.\n");
+
+    Checkout::Totals totals = checkout.getTotals();
+    REQUIRE(totals.lines == 3);
+    REQUIRE(totals.units == 6);
+    REQUIRE(totals.preDiscount == Money::fromCents(650));
+    REQUIRE(totals.savings == Money::fromCents(150));
+    REQUIRE(totals.total == Money::fromCents(500));
+
+    checkout.newBasket();
+    REQUIRE(checkout.getCartQuantity("A1") == 0);
+    REQUIRE(checkout.getTotals().units == 0);
+    REQUIRE(checkout.getAppliedDeals().empty());
+}
+
+TEST_CASE_METHOD(CheckoutFixture, "Checkout keeps running totals on every scan", "[Checkout]") {
+    checkout.setSink(nullptr);
+
+    checkout.scanItem("A1 3");
+    REQUIRE(checkout.getTotals().total == Money::fromCents(200));
+    REQUIRE(checkout.getTotals().deals == 1);
+
+    // Banana and Cherry complete the set, but all three apples are taken by Deal Type 1
+    checkout.scanItem("B2");
+    checkout.scanItem("C3");
+    REQUIRE(checkout.getTotals().savings == Money::fromCents(100));
+
+    // A fourth apple frees the cheapest of the set
+    checkout.scanItem("A1");
+    REQUIRE(checkout.getTotals().savings == Money::fromCents(150));
+    REQUIRE(checkout.getTotals().deals == 2);
+
+    checkout.scanItem("B2 -1");
+    Checkout::Totals totals = checkout.getTotals();
+    REQUIRE(totals.lines == 2);
+    REQUIRE(totals.units == 5);
+    REQUIRE(totals.preDiscount == Money::fromCents(600));
+    REQUIRE(totals.savings == Money::fromCents(100));
+    REQUIRE(checkout.getAppliedDeals() == std::vector<std::string>{"Deal Type 1 applied to 3 x Apple (-$1.00)"});
+}
+
+namespace {
+
+// Scans random quantities and checks the running totals against a greedy pass over every deal
+void requireRunningTotalsMatchScratch(const std::shared_ptr<const Catalog>& catalog) {
+    Checkout checkout(catalog);
+    checkout.setSink(nullptr);
+    std::mt19937 random(42);
+    const std::vector<Item>& items = catalog->getItems();
+    bool allMatch = true;
+
+    for (int scan = 0; scan < 2000; ++scan) {
+        if (scan % 100 == 0) {
+            checkout.newBasket();
+        }
+        int quantity = static_cast<int>(random() % 9) - 3;
+        checkout.scanItem(std::string(items[random() % items.size()].getId()) + " " + std::to_string(quantity));
+
+        // Price the same cart in one greedy pass over every deal
+        PricedBasket lines;
+        for (std::uint32_t i = 0; i < items.size(); ++i) {
+            int inCart = checkout.getCartQuantity(items[i].getId());
+            if (inCart > 0) {
+                lines.setLine(i, inCart, items[i].getPrice());
+            }
+        }
+        std::vector<DealApplication> expected;
+        for (const std::shared_ptr<const Deal>& deal : catalog->getDeals()) {
+            deal->applyDeal(lines, expected);
+        }
+        Money total = lines.getFinalTotal();
+
+        const std::vector<DealApplication>& actual = checkout.getDealApplications();
+        bool match = actual.size() == expected.size() && checkout.getTotals().total == total &&
+                     checkout.getTotals().lines == static_cast<int>(lines.size());
+        for (std::size_t i = 0; match && i < actual.size(); ++i) {
+            match = actual[i].deal == expected[i].deal && actual[i].itemIndex == expected[i].itemIndex &&
+                    actual[i].sets == expected[i].sets && actual[i].discount == expected[i].discount;
+        }
+        allMatch = allMatch && match;
+    }
+    REQUIRE(allMatch);
+
+    // Finalizing a greedy basket changes nothing
+    Checkout::Totals before = checkout.getTotals();
+    checkout.applyDeals();
+    REQUIRE(checkout.getTotals().total == before.total);
+    REQUIRE(checkout.getTotals().deals == before.deals);
+}
+
+} // namespace
+
+TEST_CASE("Checkout running totals match pricing the basket from scratch", "[Checkout]") {
+    // Overlapping Deal Type 2 sets, so one scan can change deals on several other lines
+    std::shared_ptr<const Catalog> catalog = Catalog::fromJson(R"(
+    {
+      "items": [
+        {"id": "A1", "name": "Apple", "price": 1.00},
+        {"id": "B2", "name": "Banana", "price": 0.50},
+        {"id": "C3", "name": "Cherry", "price": 2.00},
+        {"id": "D4", "name": "Date", "price": 3.00},
+        {"id": "E5", "name": "Elderberry", "price": 4.00},
+        {"id": "F6", "name": "Fig", "price": 1.50},
+        {"id": "G7", "name": "Grape", "price": 2.50},
+        {"id": "H8", "name": "Honeydew", "price": 5.00}
+      ],
+      "deals": {
+        "deal_type_1": ["A1", "C3", "F6"],
+        "deal_type_2": [["A1", "B2", "C3"], ["B2", "D4", "E5"], ["C3", "E5", "G7"], ["F6", "G7", "H8"], ["A1", "D4", "H8"]]
+      }
+    }
+    )"_json);
+
+    requireRunningTotalsMatchScratch(catalog);
+}
+
+TEST_CASE("Checkout running totals match pricing from scratch with deal rules", "[Checkout]") {
+    // Every rule kind, overlapping the classic deals and each other
+    std::shared_ptr<const Catalog> catalog = Catalog::fromJson(R"(
+    {
+      "items": [
+        {"id": "A1", "name": "Apple", "price": 1.00},
+        {"id": "B2", "name": "Banana", "price": 0.50},
+        {"id": "C3", "name": "Cherry", "price": 2.00},
+        {"id": "D4", "name": "Date", "price": 3.00},
+        {"id": "E5", "name": "Elderberry", "price": 4.00},
+        {"id": "F6", "name": "Fig", "price": 1.50},
+        {"id": "G7", "name": "Grape", "price": 2.50},
+        {"id": "H8", "name": "Honeydew", "price": 5.00}
+      ],
+      "deals": {
+        "deal_type_1": ["A1"],
+        "deal_type_2": [["A1", "B2", "C3"]],
+        "rules": [
+          {"kind": "multi_buy", "items": ["C3", "D4"], "buy": 2, "get": 1, "percent_off": 50},
+          {"kind": "n_for_m", "items": ["F6"], "n": 5, "m": 4},
+          {"kind": "bundle", "items": ["C3", "E5", "G7", "H8"], "discounted": 2, "percent_off": 25},
+          {"kind": "tiered_bundle", "items": ["B2", "D4", "G7"], "tiers": [{"units": 3, "percent_off": 10}, {"units": 6, "percent_off": 20}]},
+          {"kind": "spend_threshold", "items": ["A1", "E5", "F6", "H8"], "tiers": [{"spend": 10.00, "percent_off": 5}]}
+        ]
+      }
+    }
+    )"_json);
+
+    requireRunningTotalsMatchScratch(catalog);
+}
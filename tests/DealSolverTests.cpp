@@ -0,0 +1,193 @@
+// DealSolverTests.cpp
+#include "catch.hpp"
+
+#include "Checkout.h"
+#include "DealSolver.h"
+
+namespace {
+
+json overlappingCatalog() {
+    return R"(
+    {
+      "items": [
+        {"id": "A1", "name": "Apple", "price": 1.00},
+        {"id": "B2", "name": "Banana", "price": 0.50},
+        {"id": "C3", "name": "Cherry", "price": 2.00},
+        {"id": "G1", "name": "Grapes", "price": 2.00},
+        {"id": "S1", "name": "Strawberries", "price": 2.50}
+      ],
+      "deals": {
+        "deal_type_1": ["A1", "C3"],
+        "deal_type_2": [["A1", "B2", "C3"], ["A1", "G1", "S1"]]
+      }
+    }
+    )"_json;
+}
+
+} // namespace
+
+TEST_CASE("DealSolver beats greedy when Deal Type 1 blocks a better Deal Type 2", "[DealSolver]") {
+    Item apple("A1", "Apple", 1.00);
+    Item grapes("G1", "Grapes", 2.00);
+    Item strawberries("S1", "Strawberries", 2.50);
+    DealType1 appleThreeForTwo({0});
+    DealType2 mixAndMatch({0, 1, 2});
+
+    PricedBasket basket;
+    basket.setLine(0, 3, apple.getPrice());
+    basket.setLine(1, 3, grapes.getPrice());
+    basket.setLine(2, 3, strawberries.getPrice());
+
+    DealSolver solver;
+    DealSolver::Result result = solver.solve(basket, {&appleThreeForTwo, &mixAndMatch});
+
+    // Greedy takes 3-for-2 on apples ($1.00); three mix-and-match sets save $3.00
+    REQUIRE(result.optimal);
+    REQUIRE(result.greedySavings == Money::fromCents(100));
+    REQUIRE(result.savings == Money::fromCents(300));
+    REQUIRE(result.sets[0] == 0);
+    REQUIRE(result.sets[1] == 3);
+
+    // Only one Deal Type 1 item per deal is supported
+    DealType1 twoItems({0, 1});
+    REQUIRE_THROWS_AS(solver.solve(basket, {&twoItems}), std::invalid_argument);
+}
+
+TEST_CASE("Checkout optimal strategy applies the best assignment", "[DealSolver]") {
+    Checkout greedy;
+    Checkout optimal;
+    greedy.loadItemsAndDeals(overlappingCatalog());
+    optimal.loadItemsAndDeals(overlappingCatalog());
+    optimal.setDealStrategy(DealStrategy::OPTIMAL);
+
+    for (Checkout* checkout : {&greedy, &optimal}) {
+        checkout->scanItem("A1 3");
+        checkout->scanItem("G1 3");
+        checkout->scanItem("S1 3");
+        checkout->applyDeals();
+    }
+
+    REQUIRE(greedy.getAppliedDeals().size() == 1);
+    REQUIRE(greedy.getAppliedDeals()[0] == "Deal Type 1 applied to 3 x Apple (-$1.00)");
+
+    REQUIRE(optimal.getAppliedDeals().size() == 3);
+    REQUIRE(optimal.getAppliedDeals()[0] == "Deal Type 2 applied to Apple, Grapes, Strawberries (-$1.00)");
+}
+
+TEST_CASE("Checkout optimal strategy keeps greedy receipts on ties", "[DealSolver]") {
+    Checkout greedy;
+    Checkout optimal;
+    greedy.loadItemsAndDeals(overlappingCatalog());
+    optimal.loadItemsAndDeals(overlappingCatalog());
+    optimal.setDealStrategy(DealStrategy::OPTIMAL);
+
+    for (Checkout* checkout : {&greedy, &optimal}) {
+        checkout->scanItem("A1 4");
+        checkout->scanItem("B2 1");
+        checkout->scanItem("C3 1");
+        checkout->applyDeals();
+    }
+
+    REQUIRE(optimal.getAppliedDeals() == greedy.getAppliedDeals());
+}
+
+TEST_CASE("DealSolver counts Deal Type 1 deals sharing an item once", "[DealSolver]") {
+    json data = R"(
+    {
+      "items": [
+        {"id": "A", "name": "Apple", "price": 1.00},
+        {"id": "B", "name": "Banana", "price": 1.00},
+        {"id": "C", "name": "Cherry", "price": 1.00},
+        {"id": "D", "name": "Date", "price": 1.00},
+        {"id": "E", "name": "Elderberry", "price": 1.00}
+      ],
+      "deals": {
+        "deal_type_1": ["A"],
+        "deal_type_2": [["A", "B", "C"], ["A", "D", "E"]],
+        "rules": [{"kind": "n_for_m", "n": 3, "m": 2, "items": ["A"]}]
+      }
+    }
+    )"_json;
+    Checkout optimal;
+    optimal.loadItemsAndDeals(data);
+    optimal.setDealStrategy(DealStrategy::OPTIMAL);
+    for (const char* scan : {"A 6", "B", "C", "D", "E"}) {
+        optimal.scanItem(scan);
+    }
+    optimal.applyDeals();
+
+    // Both sets plus one 3-for-2 on the four apples left; the repeated 3-for-2 adds nothing
+    REQUIRE(optimal.getTotals().savings == Money::fromCents(300));
+
+    Item apple("A1", "Apple", 1.00);
+    RuleDeal first({0}, DealRule::dealType1());
+    RuleDeal second({0}, DealRule::dealType1());
+    PricedBasket basket;
+    basket.setLine(0, 6, apple.getPrice());
+    DealSolver solver;
+    DealSolver::Result result = solver.solve(basket, {&first, &second});
+    REQUIRE(result.savings == Money::fromCents(200));
+    REQUIRE(result.sets[0] + result.sets[1] == 2);
+}
+
+TEST_CASE("Checkout optimal strategy prices baskets with other rules greedily", "[DealSolver]") {
+    json data = overlappingCatalog();
+    data["deals"]["rules"] = R"([{"kind": "multi_buy", "items": ["B2"], "buy": 1, "get": 1, "percent_off": 50}])"_json;
+    Checkout greedy;
+    Checkout optimal;
+    greedy.loadItemsAndDeals(data);
+    optimal.loadItemsAndDeals(data);
+    optimal.setDealStrategy(DealStrategy::OPTIMAL);
+
+    for (Checkout* checkout : {&greedy, &optimal}) {
+        checkout->scanItem("A1 3");
+        checkout->scanItem("G1 3");
+        checkout->scanItem("S1 3");
+        checkout->scanItem("B2 2");
+        checkout->applyDeals();
+    }
+    REQUIRE(optimal.getAppliedDeals() == greedy.getAppliedDeals());
+    REQUIRE(optimal.getTotals().total == greedy.getTotals().total);
+
+    // The solver itself does not model such rules
+    PricedBasket basket;
+    basket.setLine(0, 2, Money::fromDouble(0.50));
+    DealRule secondHalfPrice;
+    secondHalfPrice.groupUnits = 2;
+    secondHalfPrice.discountedUnits = 1;
+    secondHalfPrice.percentOff = 50;
+    RuleDeal halfPrice({0}, secondHalfPrice);
+    DealSolver solver;
+    REQUIRE_THROWS_AS(solver.solve(basket, {&halfPrice}), std::invalid_argument);
+}
+
+TEST_CASE("DealSolver respects its time budget", "[DealSolver]") {
+    // Many overlapping mix-and-match deals over the same items make the search space huge
+    std::vector<Item> catalog;
+    for (int i = 0; i < 12; ++i) {
+        catalog.emplace_back("I" + std::to_string(i), "Item " + std::to_string(i), 1.00 + 0.25 * i);
+    }
+    PricedBasket basket;
+    for (std::uint32_t i = 0; i < catalog.size(); ++i) {
+        basket.setLine(i, 100, catalog[i].getPrice());
+    }
+    std::vector<DealType2> mixAndMatch;
+    for (std::uint32_t a = 0; a < 12; ++a) {
+        for (std::uint32_t step = 1; step <= 5; ++step) {
+            mixAndMatch.emplace_back(std::vector<std::uint32_t>{a, (a + step) % 12, (a + 2 * step) % 12});
+        }
+    }
+    std::vector<const Deal*> deals;
+    for (const DealType2& deal : mixAndMatch) {
+        deals.push_back(&deal);
+    }
+
+    DealSolver solver(std::chrono::microseconds(2000));
+    auto start = std::chrono::steady_clock::now();
+    DealSolver::Result result = solver.solve(basket, deals);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // The fallback is never worse than greedy, and the search stops near the budget
+    REQUIRE(result.savings >= result.greedySavings);
+    REQUIRE(elapsed < std::chrono::milliseconds(200));
+}
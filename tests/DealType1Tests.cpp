@@ -8,34 +8,56 @@ TEST_CASE("DealType1 functionality", "[DealType1]") {
     Item item1("A1", "Apple", 1.00);
     Item item2("B2", "Banana", 0.50);
 
-    std::set<std::string> eligibleItems = {"A1"};
+    // Item indices: Apple is 0, Banana is 1
+    std::vector<std::uint32_t> eligibleItems = {0};
 
     DealType1 dealType1(eligibleItems);
 
-    // Create purchased items
-    std::vector<PurchasedItem> purchasedItems = {
-        PurchasedItem(&item1),
-        PurchasedItem(&item1),
-        PurchasedItem(&item1),
-        PurchasedItem(&item2) // Not eligible
-    };
+    // Create basket lines
+    PricedBasket basket;
+    basket.setLine(0, 3, item1.getPrice());
+    basket.setLine(1, 3, item2.getPrice()); // Not eligible
 
-    std::vector<std::string> appliedDeals;
+    std::vector<DealApplication> appliedDeals;
 
     // Apply the deal
-    dealType1.applyDeal(purchasedItems, appliedDeals);
+    dealType1.applyDeal(basket, appliedDeals);
 
     // Check that the deal was applied correctly
-    REQUIRE(purchasedItems[0].isUsedInDeal());
-    REQUIRE(purchasedItems[1].isUsedInDeal());
-    REQUIRE(purchasedItems[2].isUsedInDeal());
-    REQUIRE(purchasedItems[2].getFinalPrice() == Approx(0.0));
-    REQUIRE(purchasedItems[2].getDealType() == DealType::TYPE1);
+    REQUIRE(basket.isUsedInDeal(0));
+    REQUIRE(basket.getAvailableQuantity(0) == 0);
+    REQUIRE(basket.getDiscount(0) == Money::fromDouble(1.0));
+    REQUIRE(basket.getFinalPrice(0) == Money::fromDouble(2.0));
+    REQUIRE(basket.getDealType(0) == DealType::TYPE1);
 
     // Check that the non-eligible item was not affected
-    REQUIRE_FALSE(purchasedItems[3].isUsedInDeal());
+    REQUIRE_FALSE(basket.isUsedInDeal(1));
+    REQUIRE(basket.getFinalPrice(1) == Money::fromDouble(1.50));
 
     // Check that the applied deal is recorded
     REQUIRE(appliedDeals.size() == 1);
-    REQUIRE(appliedDeals[0].find("Deal Type 1 applied to 3 x Apple") != std::string::npos);
+    REQUIRE(appliedDeals[0].deal == &dealType1);
+    REQUIRE(appliedDeals[0].itemIndex == 0);
+    REQUIRE(appliedDeals[0].sets == 1);
+    REQUIRE(appliedDeals[0].discount == Money::fromDouble(1.00));
+    REQUIRE(dealType1.describe(appliedDeals[0], {item1, item2}) == "Deal Type 1 applied to 3 x Apple (-$1.00)");
+}
+
+TEST_CASE("DealType1 applies once per complete set of three", "[DealType1]") {
+    Item item1("A1", "Apple", 1.00);
+
+    DealType1 dealType1({0});
+
+    PricedBasket basket;
+    basket.setLine(0, 8, item1.getPrice());
+    std::vector<DealApplication> appliedDeals;
+
+    dealType1.applyDeal(basket, appliedDeals);
+
+    // Two sets of three; the remaining two units stay available for other deals
+    REQUIRE(basket.getDiscount(0) == Money::fromDouble(2.0));
+    REQUIRE(basket.getAvailableQuantity(0) == 2);
+    REQUIRE(basket.getFinalPrice(0) == Money::fromDouble(6.0));
+    REQUIRE(appliedDeals.size() == 1);
+    REQUIRE(appliedDeals[0].sets == 2);
 }
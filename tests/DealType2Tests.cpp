@@ -9,32 +9,84 @@ TEST_CASE("DealType2 functionality", "[DealType2]") {
     Item item2("B2", "Banana", 0.50);
     Item item3("C3", "Cherry", 2.00);
 
-    std::set<std::string> eligibleItems = {"A1", "B2", "C3"};
+    // Item indices: Apple is 0, Banana is 1, Cherry is 2
+    std::vector<std::uint32_t> eligibleItems = {0, 1, 2};
 
     DealType2 dealType2(eligibleItems);
 
-    // Create purchased items
-    std::vector<PurchasedItem> purchasedItems = {
-        PurchasedItem(&item1),
-        PurchasedItem(&item2),
-        PurchasedItem(&item3)
-    };
+    // Create basket lines
+    PricedBasket basket;
+    basket.setLine(0, 1, item1.getPrice());
+    basket.setLine(1, 1, item2.getPrice());
+    basket.setLine(2, 2, item3.getPrice());
 
-    std::vector<std::string> appliedDeals;
+    std::vector<DealApplication> appliedDeals;
 
     // Apply the deal
-    dealType2.applyDeal(purchasedItems, appliedDeals);
+    dealType2.applyDeal(basket, appliedDeals);
 
     // Check that the deal was applied correctly
-    REQUIRE(purchasedItems[0].isUsedInDeal());
-    REQUIRE(purchasedItems[1].isUsedInDeal());
-    REQUIRE(purchasedItems[2].isUsedInDeal());
+    REQUIRE(basket.isUsedInDeal(0));
+    REQUIRE(basket.isUsedInDeal(1));
+    REQUIRE(basket.isUsedInDeal(2));
 
     // The cheapest item (Banana) should be free
-    REQUIRE(purchasedItems[1].getFinalPrice() == Approx(0.0));
-    REQUIRE(purchasedItems[1].getDealType() == DealType::TYPE2);
+    REQUIRE(basket.getFinalPrice(1) == Money::fromDouble(0.0));
+    REQUIRE(basket.getDealType(1) == DealType::TYPE2);
 
     // Check that the applied deal is recorded
     REQUIRE(appliedDeals.size() == 1);
-    REQUIRE(appliedDeals[0].find("Deal Type 2 applied to") != std::string::npos);
+    REQUIRE(appliedDeals[0].itemIndex == 1);
+    REQUIRE(appliedDeals[0].sets == 1);
+    REQUIRE(appliedDeals[0].discount == Money::fromDouble(0.50));
+    REQUIRE(dealType2.describe(appliedDeals[0], {item1, item2, item3}) ==
+            "Deal Type 2 applied to Apple, Banana, Cherry (-$0.50)");
+}
+
+TEST_CASE("DealType2 is limited by the scarcest eligible item", "[DealType2]") {
+    Item item1("A1", "Apple", 1.00);
+    Item item2("B2", "Banana", 0.50);
+    Item item3("C3", "Cherry", 2.00);
+
+    DealType2 dealType2({0, 1, 2});
+
+    PricedBasket basket;
+    basket.setLine(0, 5, item1.getPrice());
+    basket.setLine(1, 4, item2.getPrice());
+    basket.setLine(2, 2, item3.getPrice());
+    std::vector<DealApplication> appliedDeals;
+
+    dealType2.applyDeal(basket, appliedDeals);
+
+    REQUIRE(basket.getAvailableQuantity(0) == 3);
+    REQUIRE(basket.getAvailableQuantity(1) == 2);
+    REQUIRE(basket.getAvailableQuantity(2) == 0);
+    REQUIRE(basket.getDiscount(1) == Money::fromDouble(1.00));
+    REQUIRE(appliedDeals.size() == 1);
+    REQUIRE(appliedDeals[0].sets == 2);
+
+    // Without all three eligible items nothing is applied
+    PricedBasket partial;
+    partial.setLine(0, 3, item1.getPrice());
+    partial.setLine(1, 3, item2.getPrice());
+    std::vector<DealApplication> noDeals;
+    dealType2.applyDeal(partial, noDeals);
+    REQUIRE(noDeals.empty());
+    REQUIRE_FALSE(partial.isUsedInDeal(0));
+}
+
+TEST_CASE("DealType2 can apply only when every eligible item is present", "[DealType2]") {
+    DealType2 dealType2({0, 65, 130});
+
+    PricedBasket basket;
+    basket.setLine(0, 1, Money::fromDouble(1.00));
+    basket.setLine(130, 1, Money::fromDouble(2.00));
+    REQUIRE_FALSE(dealType2.canApply(basket.getPresence()));
+
+    basket.setLine(65, 1, Money::fromDouble(0.50));
+    REQUIRE(dealType2.canApply(basket.getPresence()));
+
+    basket.setLine(0, 0, Money::fromDouble(1.00));
+    REQUIRE_FALSE(dealType2.canApply(basket.getPresence()));
+    REQUIRE_FALSE(DealType2({}).canApply(basket.getPresence()));
 }
@@ -0,0 +1,59 @@
+// ItemBitsetTests.cpp
+#include "catch.hpp"
+
+#include "ItemBitset.h"
+
+TEST_CASE("ItemBitset compiles a group into one mask per word", "[ItemBitset]") {
+    std::vector<ItemBitset::Word> group = ItemBitset::compile({130, 3, 0, 64});
+    REQUIRE(group.size() == 3);
+    REQUIRE(group[0].index == 0);
+    REQUIRE(group[0].mask == 0b1001);
+    REQUIRE(group[1].index == 1);
+    REQUIRE(group[1].mask == 1);
+    REQUIRE(group[2].index == 2);
+    REQUIRE(group[2].mask == 0b100);
+    REQUIRE(ItemBitset::compile({}).empty());
+}
+
+TEST_CASE("ItemBitset sets, resets and tests items", "[ItemBitset]") {
+    ItemBitset present;
+    REQUIRE_FALSE(present.test(5));
+    REQUIRE_FALSE(present.test(1000));
+
+    // Setting a high index grows the set
+    present.set(1000);
+    present.set(5);
+    REQUIRE(present.test(1000));
+    REQUIRE(present.test(5));
+    REQUIRE_FALSE(present.test(999));
+
+    present.reset(1000);
+    present.reset(2000);
+    REQUIRE_FALSE(present.test(1000));
+    REQUIRE(present.test(5));
+}
+
+TEST_CASE("ItemBitset checks whether it holds all or any of a group", "[ItemBitset]") {
+    ItemBitset present;
+    present.set(1);
+    present.set(2);
+    present.set(70);
+
+    std::vector<ItemBitset::Word> held = ItemBitset::compile({1, 2, 70});
+    std::vector<ItemBitset::Word> partial = ItemBitset::compile({1, 3, 70});
+    std::vector<ItemBitset::Word> beyond = ItemBitset::compile({1, 500});
+    REQUIRE(present.containsAll(held));
+    REQUIRE_FALSE(present.containsAll(partial));
+    REQUIRE_FALSE(present.containsAll(beyond));
+    REQUIRE(present.containsAll({}));
+
+    // One item can be counted as present without adding it
+    REQUIRE(present.containsAll(partial, 3));
+    REQUIRE(present.containsAll(beyond, 500));
+    REQUIRE_FALSE(present.containsAll(partial, 4));
+
+    REQUIRE(present.containsAny(partial));
+    REQUIRE(present.containsAny(beyond));
+    REQUIRE_FALSE(present.containsAny(ItemBitset::compile({0, 3, 500})));
+    REQUIRE_FALSE(present.containsAny({}));
+}
@@ -0,0 +1,44 @@
+// ItemIndexTests.cpp
+#include "catch.hpp"
+
+#include "ItemIndex.h"
+#include <string>
+
+TEST_CASE("ItemIndex packs IDs into ordered keys", "[ItemIndex]") {
+    REQUIRE(ItemIndex::pack("A1") != 0);
+    REQUIRE(ItemIndex::pack("a1", true) == ItemIndex::pack("A1"));
+    REQUIRE(ItemIndex::pack("a1") != ItemIndex::pack("A1"));
+
+    // Key order matches string order, including prefixes
+    REQUIRE(ItemIndex::pack("A") < ItemIndex::pack("A1"));
+    REQUIRE(ItemIndex::pack("A9") < ItemIndex::pack("B1"));
+    REQUIRE(ItemIndex::pack("ZZZZZZZZ") > ItemIndex::pack("ZZZZZZZY"));
+
+    // Empty and over-long IDs cannot be packed
+    REQUIRE(ItemIndex::pack("") == 0);
+    REQUIRE(ItemIndex::pack("ABCDEFGHI") == 0);
+}
+
+TEST_CASE("ItemIndex maps keys to dense indices", "[ItemIndex]") {
+    std::vector<std::uint64_t> keys;
+    for (int i = 0; i < 5000; ++i) {
+        keys.push_back(ItemIndex::pack("I" + std::to_string(i)));
+    }
+    keys.push_back(0);                       // Unpackable IDs are skipped
+    keys.push_back(ItemIndex::pack("I42"));  // Duplicates keep the first index
+
+    ItemIndex index;
+    index.build(keys);
+
+    bool allFound = true;
+    for (std::uint32_t i = 0; i < 5000; ++i) {
+        allFound = allFound && index.find(keys[i]) == i;
+    }
+    REQUIRE(allFound);
+    REQUIRE(index.find(ItemIndex::pack("I42")) == 42);
+    REQUIRE(index.find(ItemIndex::pack("X1")) == ItemIndex::NOT_FOUND);
+    REQUIRE(index.find(0) == ItemIndex::NOT_FOUND);
+
+    ItemIndex empty;
+    REQUIRE(empty.find(ItemIndex::pack("A1")) == ItemIndex::NOT_FOUND);
+}
@@ -10,5 +10,5 @@ TEST_CASE("Item class functionality", "[Item]") {
 
     REQUIRE(item.getId() == "A1");
     REQUIRE(item.getName() == "Apple");
-    REQUIRE(item.getPrice() == Approx(1.00));
+    REQUIRE(item.getPrice() == Money::fromDouble(1.00));
 }
@@ -0,0 +1,86 @@
+// LoadGeneratorTests.cpp
+#include "catch.hpp"
+
+#include "LoadGenerator.h"
+#include "ReplayDriver.h"
+#include "ScanParser.h"
+#include <set>
+#include <sstream>
+
+TEST_CASE("LoadGenerator item IDs are unique and scannable", "[LoadGenerator]") {
+    REQUIRE(LoadGenerator::itemId(0) == "A0");
+    REQUIRE(LoadGenerator::itemId(27) == "B1");
+    REQUIRE(LoadGenerator::itemId(LoadGenerator::MAX_ITEMS - 1).size() == 5);
+
+    std::set<std::string> ids;
+    bool scannable = true;
+    for (std::uint32_t n = 0; n < 50000; ++n) {
+        std::string id = LoadGenerator::itemId(n);
+        ids.insert(id);
+        scannable = scannable && parseScanLine(id).error == ScanParseError::NONE;
+    }
+    REQUIRE(ids.size() == 50000);
+    REQUIRE(scannable);
+}
+
+TEST_CASE("LoadGenerator catalogs follow the requested shape", "[LoadGenerator]") {
+    LoadGenerator::CatalogOptions options;
+    options.items = 2000;
+    options.priceMin = 1.00;
+    options.priceMax = 9.99;
+    options.priceDistribution = PriceDistribution::LOG_NORMAL;
+    options.dealType1Coverage = 0.25;
+    options.dealType2Density = 0.10;
+    options.dealType2Pool = 0.05;
+
+    json data = LoadGenerator::generateCatalog(options);
+    REQUIRE(data == LoadGenerator::generateCatalog(options));
+
+    std::shared_ptr<const Catalog> catalog = Catalog::fromJson(data);
+    REQUIRE(catalog->getItemCount() == 2000);
+    REQUIRE(data["deals"]["deal_type_1"].size() == 500);
+    REQUIRE(data["deals"]["deal_type_2"].size() == 200);
+
+    bool pricesInRange = true;
+    for (const Item& item : catalog->getItems()) {
+        pricesInRange = pricesInRange && item.getPrice() >= Money::fromCents(100) && item.getPrice() <= Money::fromCents(999);
+    }
+    REQUIRE(pricesInRange);
+
+    // Deal Type 2 sets only use items from the pool
+    std::set<std::string> dealType2Items;
+    for (const auto& dealSet : data["deals"]["deal_type_2"]) {
+        for (const auto& id : dealSet) {
+            dealType2Items.insert(id.get<std::string>());
+        }
+    }
+    REQUIRE(dealType2Items.size() <= 100);
+
+    options.items = 0;
+    REQUIRE_THROWS_AS(LoadGenerator::generateCatalog(options), std::invalid_argument);
+}
+
+TEST_CASE("LoadGenerator basket streams replay cleanly", "[LoadGenerator]") {
+    LoadGenerator::CatalogOptions catalogOptions;
+    catalogOptions.items = 500;
+    std::shared_ptr<const Catalog> catalog = Catalog::fromJson(LoadGenerator::generateCatalog(catalogOptions));
+
+    LoadGenerator::BasketOptions options;
+    options.baskets = 300;
+    options.removalRate = 0.2;
+    std::ostringstream stream;
+    LoadGenerator::generateBaskets(*catalog, options, stream);
+
+    std::ostringstream again;
+    LoadGenerator::generateBaskets(*catalog, options, again);
+    REQUIRE(stream.str() == again.str());
+    REQUIRE(stream.str().find(" -") != std::string::npos);
+
+    std::istringstream input(stream.str());
+    std::ostringstream output;
+    ReplayDriver driver(catalog);
+    REQUIRE(driver.run(input, output).baskets == 300);
+
+    Catalog empty;
+    REQUIRE_THROWS_AS(LoadGenerator::generateBaskets(empty, options, stream), std::invalid_argument);
+}
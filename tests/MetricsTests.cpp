@@ -0,0 +1,124 @@
+// MetricsTests.cpp
+#include "catch.hpp"
+
+#include "Checkout.h"
+#include "Metrics.h"
+#include <thread>
+
+namespace {
+
+std::size_t indexOf(MetricsPhase phase) {
+    return static_cast<std::size_t>(phase);
+}
+
+std::size_t indexOf(MetricsCounter counter) {
+    return static_cast<std::size_t>(counter);
+}
+
+} // namespace
+
+TEST_CASE("LatencyHistogram buckets values to within 1/32", "[Metrics]") {
+    // Exact below 32 ns
+    REQUIRE(LatencyHistogram::bucketOf(0) == 0);
+    REQUIRE(LatencyHistogram::bucketOf(31) == 31);
+    REQUIRE(LatencyHistogram::bucketOf(32) == 32);
+    REQUIRE(LatencyHistogram::bucketOf(64) == 64);
+    REQUIRE(LatencyHistogram::bucketOf(std::uint64_t(1) << 40) == LatencyHistogram::BUCKETS - 1);
+
+    for (std::uint64_t value : {33ull, 100ull, 1000ull, 12345ull, 999999ull, 5000000000ull}) {
+        std::uint32_t bucket = LatencyHistogram::bucketOf(value);
+        REQUIRE(LatencyHistogram::lowestValueOf(bucket) <= value);
+        REQUIRE(LatencyHistogram::highestValueOf(bucket) >= value);
+        REQUIRE(LatencyHistogram::highestValueOf(bucket) - LatencyHistogram::lowestValueOf(bucket) <= value / 32);
+        REQUIRE(LatencyHistogram::lowestValueOf(bucket + 1) == LatencyHistogram::highestValueOf(bucket) + 1);
+    }
+
+    LatencyHistogram histogram;
+    histogram.record(10);
+    histogram.record(10);
+    histogram.record(1000);
+    REQUIRE(histogram.getCount(10) == 2);
+    REQUIRE(histogram.getTotal() == 1020);
+    REQUIRE(histogram.getMaximum() == 1000);
+    histogram.reset();
+    REQUIRE(histogram.getCount(10) == 0);
+}
+
+TEST_CASE("Metrics merges the shards of every thread", "[Metrics]") {
+    Metrics::reset();
+    std::thread worker([]() {
+        for (int i = 0; i < 100; ++i) {
+            Metrics::record(MetricsPhase::LOOKUP, 1000);
+        }
+        Metrics::increment(MetricsCounter::SCANS, 100);
+    });
+    worker.join();
+    Metrics::record(MetricsPhase::LOOKUP, 50000);
+    Metrics::increment(MetricsCounter::SCANS);
+
+    Metrics::Snapshot snapshot = Metrics::snapshot();
+    const Metrics::PhaseSnapshot& lookup = snapshot.phases[indexOf(MetricsPhase::LOOKUP)];
+    REQUIRE(lookup.count == 101);
+    REQUIRE(lookup.total == 150000);
+    REQUIRE(lookup.p50 >= 1000);
+    REQUIRE(lookup.p50 <= 1000 + 1000 / 32);
+    REQUIRE(lookup.p999 == 50000);
+    REQUIRE(lookup.max == 50000);
+    REQUIRE(snapshot.counters[indexOf(MetricsCounter::SCANS)] == 101);
+
+    std::string json;
+    Metrics::writeJson(snapshot, json);
+    REQUIRE(json.find("\"lookup\":{\"count\":101,\"total_ns\":150000,") != std::string::npos);
+    REQUIRE(json.find("\"scans\":101") != std::string::npos);
+    Metrics::reset();
+    REQUIRE(Metrics::snapshot().phases[indexOf(MetricsPhase::LOOKUP)].count == 0);
+}
+
+TEST_CASE("Checkout records its phases only when metrics are enabled", "[Metrics]") {
+    Metrics::reset();
+    Checkout checkout(Catalog::fromJson(R"(
+    {
+      "items": [
+        {"id": "A1", "name": "Apple", "price": 1.00},
+        {"id": "B2", "name": "Banana", "price": 0.50},
+        {"id": "C3", "name": "Cherry", "price": 2.00}
+      ],
+      "deals": {
+        "deal_type_1": ["A1"],
+        "deal_type_2": [["A1", "B2", "C3"]]
+      }
+    }
+    )"_json));
+    checkout.setSink(nullptr);
+    checkout.scanItem("A1 3");
+    checkout.scanItem("B2");
+    checkout.scanItem("C3");
+    checkout.scanItem("Z9");
+    checkout.scanItem("A1 x");
+    checkout.applyDeals();
+    checkout.getReceipt();
+
+    Metrics::Snapshot snapshot = Metrics::snapshot();
+    std::string text;
+    Metrics::writeText(snapshot, text);
+    if (!Metrics::ENABLED) {
+        REQUIRE_FALSE(snapshot.enabled);
+        REQUIRE(snapshot.phases[indexOf(MetricsPhase::SCAN_ITEM)].count == 0);
+        REQUIRE(text.find("disabled") != std::string::npos);
+        return;
+    }
+    REQUIRE(snapshot.phases[indexOf(MetricsPhase::SCAN_ITEM)].count == 5);
+    REQUIRE(snapshot.phases[indexOf(MetricsPhase::PARSE)].count == 5);
+    REQUIRE(snapshot.phases[indexOf(MetricsPhase::LOOKUP)].count == 4);
+    REQUIRE(snapshot.phases[indexOf(MetricsPhase::PROCESS_SCANNED_ITEM)].count == 4);
+    REQUIRE(snapshot.phases[indexOf(MetricsPhase::DEAL_TYPE1)].count >= 1);
+    REQUIRE(snapshot.phases[indexOf(MetricsPhase::DEAL_TYPE2)].count >= 1);
+    REQUIRE(snapshot.phases[indexOf(MetricsPhase::APPLY_DEALS)].count == 1);
+    REQUIRE(snapshot.phases[indexOf(MetricsPhase::BUILD_RECEIPT)].count == 1);
+    REQUIRE(snapshot.counters[indexOf(MetricsCounter::SCANS)] == 5);
+    REQUIRE(snapshot.counters[indexOf(MetricsCounter::PARSE_ERRORS)] == 1);
+    REQUIRE(snapshot.counters[indexOf(MetricsCounter::ITEMS_NOT_FOUND)] == 1);
+    REQUIRE(snapshot.counters[indexOf(MetricsCounter::RECEIPTS)] == 1);
+    REQUIRE(text.find("process_scanned_item") != std::string::npos);
+    Metrics::reset();
+}
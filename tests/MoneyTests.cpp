@@ -0,0 +1,37 @@
+// MoneyTests.cpp
+#include "catch.hpp"
+
+#include "Money.h"
+#include <sstream>
+#include <iomanip>
+
+TEST_CASE("Money conversion and rounding", "[Money]") {
+    REQUIRE(Money::fromDouble(1.00).getCents() == 100);
+    REQUIRE(Money::fromDouble(0.1).getCents() == 10);
+    REQUIRE(Money::fromDouble(19.99).getCents() == 1999); // 19.99 * 100 is 1998.999..., rounded not truncated
+    REQUIRE(Money::fromDouble(0.125).getCents() == 13);  // Exact half rounds away from zero
+    REQUIRE(Money::fromDouble(-0.125).getCents() == -13);
+    REQUIRE_THROWS_AS(Money::fromDouble(1e300), std::out_of_range);
+}
+
+TEST_CASE("Money arithmetic is exact", "[Money]") {
+    Money total;
+    for (int i = 0; i < 1000000; ++i) {
+        total += Money::fromDouble(0.1);
+    }
+    REQUIRE(total == Money::fromCents(10000000));
+    REQUIRE(Money::fromCents(250) * 3 == Money::fromCents(750));
+    REQUIRE(Money::fromCents(250) - Money::fromCents(300) == -Money::fromCents(50));
+    REQUIRE(Money::fromCents(1) < Money::fromCents(2));
+}
+
+TEST_CASE("Money formatting", "[Money]") {
+    REQUIRE(Money().toString() == "0.00");
+    REQUIRE(Money::fromCents(5).toString() == "0.05");
+    REQUIRE(Money::fromCents(1205).toString() == "12.05");
+    REQUIRE(Money::fromCents(-50).toString() == "-0.50");
+
+    std::ostringstream oss;
+    oss << std::right << std::setw(10) << Money::fromCents(650);
+    REQUIRE(oss.str() == "      6.50");
+}
@@ -0,0 +1,122 @@
+// OutputSinkTests.cpp
+#include "catch.hpp"
+
+#include "Checkout.h"
+#include "OutputSink.h"
+#include <cstring>
+#include <sstream>
+
+namespace {
+
+/**
+ * @brief Sink that records the events it receives.
+ */
+class RecordingSink : public OutputSink {
+public:
+    std::vector<ScanEvent> events;
+    std::vector<int> quantities;
+    int textBlocks = 0;
+
+    void scanMessage(const ScanMessage& message) override {
+        events.push_back(message.event);
+        quantities.push_back(message.quantity);
+    }
+
+    void text(std::string_view) override {
+        ++textBlocks;
+    }
+};
+
+std::shared_ptr<const Catalog> sinkCatalog() {
+    return Catalog::fromJson(R"(
+    {
+      "items": [
+        {"id": "A1", "name": "Apple", "price": 1.00},
+        {"id": "B2", "name": "Banana", "price": 0.50}
+      ],
+      "deals": {}
+    }
+    )"_json);
+}
+
+} // namespace
+
+TEST_CASE("Checkout reports scan outcomes to its sink", "[OutputSink]") {
+    auto sink = std::make_shared<RecordingSink>();
+    Checkout checkout(sinkCatalog());
+    checkout.setSink(sink);
+
+    checkout.scanItem("A1 3");
+    checkout.scanItem("a1 200");
+    checkout.scanItem("B2 -1");
+    checkout.scanItem("Z9");
+    checkout.scanItem("A1 x");
+    checkout.scanItem("A1 99999999999");
+    checkout.scanItem("help");
+    checkout.applyDeals();
+    checkout.generateReceipt();
+
+    REQUIRE(sink->events == std::vector<ScanEvent>{ScanEvent::QUANTITY_UPDATED, ScanEvent::QUANTITY_CLAMPED,
+                                                   ScanEvent::QUANTITY_UPDATED, ScanEvent::ITEM_REMOVED,
+                                                   ScanEvent::ITEM_NOT_FOUND, ScanEvent::INVALID_FORMAT,
+                                                   ScanEvent::QUANTITY_OUT_OF_RANGE});
+    REQUIRE(sink->quantities[0] == 3);
+    REQUIRE(sink->quantities[2] == 100);
+    REQUIRE(sink->textBlocks == 2);
+}
+
+TEST_CASE("TextSink writes the interactive messages", "[OutputSink]") {
+    std::ostringstream output;
+    Checkout checkout(sinkCatalog());
+    checkout.setSink(std::make_shared<TextSink>(output));
+
+    checkout.scanItem("a1 101");
+    checkout.scanItem("b2 -1");
+    checkout.scanItem("z9");
+    REQUIRE(output.str() ==
+            "Total quantity for item ID 'A1' cannot exceed 100. Setting quantity to 100.\n"
+            "Updated Apple quantity to 100.\n"
+            "No items of ID 'B2' left in your cart.\n"
+            "Error: Item ID 'Z9' not found.\n"
+            "Type 'help' for a list of available items.\n");
+}
+
+TEST_CASE("TextSink buffers until full or flushed", "[OutputSink]") {
+    std::ostringstream output;
+    {
+        TextSink sink(output, 1024);
+        ScanMessage message{ScanEvent::QUANTITY_OUT_OF_RANGE};
+        sink.scanMessage(message);
+        sink.text("block\n");
+        REQUIRE(output.str().empty());
+
+        sink.flush();
+        REQUIRE(output.str() == "Quantity is out of acceptable range.\nblock\n");
+
+        sink.text("tail\n");
+    }
+    REQUIRE(output.str() == "Quantity is out of acceptable range.\nblock\ntail\n");
+}
+
+TEST_CASE("BinarySink writes fixed-size records", "[OutputSink]") {
+    std::ostringstream output;
+    Checkout checkout(sinkCatalog());
+    auto sink = std::make_shared<BinarySink>(output);
+    checkout.setSink(sink);
+
+    checkout.scanItem("B2 4");
+    checkout.scanItem("Q7");
+    checkout.scanItem("help");
+    sink->flush();
+
+    std::string bytes = output.str();
+    REQUIRE(bytes.size() == 2 * sizeof(BinarySink::Record));
+
+    BinarySink::Record records[2];
+    std::memcpy(records, bytes.data(), bytes.size());
+    REQUIRE(records[0].event == static_cast<std::uint8_t>(ScanEvent::QUANTITY_UPDATED));
+    REQUIRE(records[0].itemIndex == 1);
+    REQUIRE(records[0].quantity == 4);
+    REQUIRE(records[1].event == static_cast<std::uint8_t>(ScanEvent::ITEM_NOT_FOUND));
+    REQUIRE(records[1].itemIndex == 0xFFFFFFFFu);
+}
@@ -0,0 +1,80 @@
+// PricedBasketTests.cpp
+#include "catch.hpp"
+
+#include "Deal.h"
+#include "PricedBasket.h"
+
+TEST_CASE("PricedBasket line functionality", "[PricedBasket]") {
+    PricedBasket basket;
+    basket.setLine(7, 4, Money::fromDouble(1.00));
+
+    REQUIRE(basket.size() == 1);
+    REQUIRE(basket.find(7) == 0);
+    REQUIRE(basket.getItemIndex(0) == 7);
+    REQUIRE(basket.getQuantity(0) == 4);
+    REQUIRE(basket.getUnitPrice(0) == Money::fromDouble(1.00));
+    REQUIRE_FALSE(basket.isUsedInDeal(0));
+    REQUIRE(basket.getAvailableQuantity(0) == 4);
+    REQUIRE(basket.getFinalPrice(0) == Money::fromDouble(4.00));
+    REQUIRE(basket.getDealType(0) == DealType::NONE);
+
+    // Test applying a deal to the line
+    basket.useInDeal(0, 3);
+    REQUIRE(basket.isUsedInDeal(0));
+    REQUIRE(basket.getAvailableQuantity(0) == 1);
+
+    DealType1 threeForTwo({7});
+    basket.addFreeUnits(0, 1, threeForTwo);
+    REQUIRE(basket.getDiscount(0) == Money::fromDouble(1.00));
+    REQUIRE(basket.getFinalPrice(0) == Money::fromDouble(3.00));
+    REQUIRE(basket.getDealType(0) == DealType::TYPE1);
+    REQUIRE(basket.getDeal(0) == &threeForTwo);
+
+    // Setting the quantity again starts the line over
+    basket.setLine(7, 5, Money::fromDouble(1.00));
+    REQUIRE(basket.size() == 1);
+    REQUIRE_FALSE(basket.isUsedInDeal(0));
+    REQUIRE(basket.getDiscount(0) == Money());
+    REQUIRE(basket.getDealType(0) == DealType::NONE);
+    REQUIRE(basket.getDeal(0) == nullptr);
+}
+
+TEST_CASE("PricedBasket keeps lines sorted and sums its columns", "[PricedBasket]") {
+    PricedBasket basket;
+    basket.setLine(5, 2, Money::fromDouble(2.50));
+    basket.setLine(1, 3, Money::fromDouble(1.00));
+    basket.setLine(9, 1, Money::fromDouble(0.75));
+
+    REQUIRE(basket.getItemIndices() == std::vector<std::uint32_t>{1, 5, 9});
+    REQUIRE(basket.find(4) == PricedBasket::NPOS);
+    REQUIRE(basket.lowerBound(4) == 1);
+    REQUIRE(basket.getUnits() == 6);
+    REQUIRE(basket.getPreDiscountTotal() == Money::fromDouble(8.75));
+
+    basket.useInDeal(0, 3);
+    DealType1 threeForTwo({1});
+    DealType2 mixAndMatch({1, 5, 9});
+    basket.addFreeUnits(0, 1, threeForTwo);
+    basket.addFreeUnits(1, 1, mixAndMatch);
+    REQUIRE(basket.getDiscountTotal() == Money::fromDouble(3.50));
+    REQUIRE(basket.getFinalTotal() == Money::fromDouble(5.25));
+
+    // Clearing deals keeps the lines
+    basket.clearDeals();
+    REQUIRE(basket.getDiscountTotal() == Money());
+    REQUIRE(basket.getAvailableQuantity(0) == 3);
+    REQUIRE(basket.getFinalTotal() == Money::fromDouble(8.75));
+
+    // A zero quantity removes the line
+    basket.setLine(5, 0, Money::fromDouble(2.50));
+    REQUIRE(basket.getItemIndices() == std::vector<std::uint32_t>{1, 9});
+    REQUIRE(basket.getUnits() == 4);
+    REQUIRE_FALSE(basket.contains(5));
+    REQUIRE(basket.contains(9));
+
+    basket.clear();
+    REQUIRE(basket.empty());
+    REQUIRE_FALSE(basket.contains(1));
+    REQUIRE_FALSE(basket.getPresence().test(9));
+    REQUIRE(basket.getFinalTotal() == Money());
+}
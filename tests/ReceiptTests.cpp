@@ -0,0 +1,229 @@
+// ReceiptTests.cpp
+#include "catch.hpp"
+
+#include "Checkout.h"
+#include "Receipt.h"
+#include "ReplayDriver.h"
+#include <cstring>
+#include <sstream>
+
+namespace {
+
+std::shared_ptr<const Catalog> receiptCatalog() {
+    return Catalog::fromJson(R"(
+    {
+      "items": [
+        {"id": "A1", "name": "Apple", "price": 1.00},
+        {"id": "B2", "name": "Banana, ripe", "price": 0.50},
+        {"id": "C3", "name": "Cherry \"red\"", "price": 2.00}
+      ],
+      "deals": {
+        "deal_type_1": ["A1"],
+        "deal_type_2": [["A1", "B2", "C3"]]
+      }
+    }
+    )"_json);
+}
+
+// Apple x4 (one Type 1 set), Banana x1 and Cherry x1 (one Type 2 set with the fourth apple)
+Receipt pricedReceipt() {
+    Checkout checkout(receiptCatalog());
+    checkout.setSink(nullptr);
+    checkout.scanItem("A1 4");
+    checkout.scanItem("B2");
+    checkout.scanItem("C3");
+    checkout.applyDeals();
+
+    Receipt receipt = checkout.getReceipt();
+    receipt.number = 7;
+    return receipt;
+}
+
+} // namespace
+
+TEST_CASE("Receipt holds lines, deal applications and totals", "[Receipt]") {
+    Receipt receipt = pricedReceipt();
+
+    REQUIRE(receipt.lines.size() == 3);
+    REQUIRE(receipt.lines[0].itemIndex == 0);
+    REQUIRE(receipt.lines[0].quantity == 4);
+    REQUIRE(receipt.lines[0].preDiscount == Money::fromDouble(4.00));
+    REQUIRE(receipt.lines[0].discount == Money::fromDouble(1.00));
+    REQUIRE(receipt.lines[0].dealType == DealType::TYPE1);
+    REQUIRE(receipt.lines[1].discount == Money::fromDouble(0.50));
+    REQUIRE(receipt.lines[1].total == Money());
+    REQUIRE(receipt.lines[2].dealType == DealType::NONE);
+
+    REQUIRE(receipt.deals.size() == 2);
+    REQUIRE(receipt.deals[0].deal->getType() == DealType::TYPE1);
+    REQUIRE(receipt.deals[1].itemIndex == 1);
+    REQUIRE(receipt.units == 6);
+    REQUIRE(receipt.preDiscount == Money::fromDouble(6.50));
+    REQUIRE(receipt.savings == Money::fromDouble(1.50));
+    REQUIRE(receipt.total == Money::fromDouble(5.00));
+}
+
+TEST_CASE("ReceiptWriter writes the text receipt", "[Receipt]") {
+    std::string text;
+    ReceiptWriter::writeText(pricedReceipt(), text);
+    REQUIRE(text ==
+            "\n--- Customer Receipt ---\n"
+            "Apple x4                       $      4.00\n"
+            "  Discount (Type 1)           -$      1.00\n"
+            "Banana, ripe x1                $      0.50\n"
+            "  Discount (Type 2)           -$      0.50\n"
+            "Cherry \"red\" x1                $      2.00\n"
+            "\n--- Discounts Applied ---\n"
+            "Deal Type 1 applied to 3 x Apple (-$1.00)\n"
+            "Deal Type 2 applied to Apple, Banana, ripe, Cherry \"red\" (-$0.50)\n"
+            "\n"
+            "Total before discounts         $      6.50\n"
+            "Total savings                 -$      1.50\n"
+            "Total after discounts          $      5.00\n"
+            "Thank you for shopping with us!\n");
+}
+
+TEST_CASE("Receipt keeps items that share a name apart", "[Receipt]") {
+    Checkout checkout(Catalog::fromJson(R"(
+    {
+      "items": [
+        {"id": "A1", "name": "Milk", "price": 1.00},
+        {"id": "B2", "name": "Bread", "price": 2.00},
+        {"id": "C3", "name": "Milk", "price": 1.50}
+      ],
+      "deals": {
+        "deal_type_1": ["C3"]
+      }
+    }
+    )"_json));
+    checkout.setSink(nullptr);
+    checkout.scanItem("C3 3");
+    checkout.scanItem("A1 2");
+    checkout.scanItem("B2");
+    checkout.applyDeals();
+
+    // Ordered by name, then by item ID; each Milk keeps its own price and discount
+    Receipt receipt = checkout.getReceipt();
+    REQUIRE(receipt.lines.size() == 3);
+    REQUIRE(receipt.lines[0].itemIndex == 1);
+    REQUIRE(receipt.lines[1].itemIndex == 0);
+    REQUIRE(receipt.lines[1].preDiscount == Money::fromDouble(2.00));
+    REQUIRE(receipt.lines[1].discount == Money());
+    REQUIRE(receipt.lines[2].itemIndex == 2);
+    REQUIRE(receipt.lines[2].preDiscount == Money::fromDouble(4.50));
+    REQUIRE(receipt.lines[2].discount == Money::fromDouble(1.50));
+    REQUIRE(receipt.preDiscount == Money::fromDouble(8.50));
+    REQUIRE(receipt.total == Money::fromDouble(7.00));
+}
+
+TEST_CASE("ReceiptWriter writes JSON Lines and CSV", "[Receipt]") {
+    Receipt receipt = pricedReceipt();
+
+    std::string line;
+    ReceiptWriter::writeJsonLine(receipt, line);
+    json parsed = json::parse(line);
+    REQUIRE(line.back() == '\n');
+    REQUIRE(parsed["receipt"] == 7);
+    REQUIRE(parsed["lines"].size() == 3);
+    REQUIRE(parsed["lines"][2]["name"] == "Cherry \"red\"");
+    REQUIRE(parsed["lines"][0]["discount"] == 1.0);
+    REQUIRE(parsed["deals"][1]["type"] == "type2");
+    REQUIRE(parsed["deals"][1]["name"] == "Deal Type 2");
+    REQUIRE(parsed["deals"][1]["item"] == "B2");
+    REQUIRE(parsed["total"] == 5.0);
+
+    std::string csv;
+    ReceiptWriter::writeCsvHeader(csv);
+    ReceiptWriter::writeCsv(receipt, csv);
+    REQUIRE(csv ==
+            "receipt,item_id,name,quantity,unit_price,subtotal,discount,total,deal,deal_name\n"
+            "7,A1,Apple,4,1.00,4.00,1.00,3.00,type1,Deal Type 1\n"
+            "7,B2,\"Banana, ripe\",1,0.50,0.50,0.50,0.00,type2,Deal Type 2\n"
+            "7,C3,\"Cherry \"\"red\"\"\",1,2.00,2.00,0.00,2.00,none,\n");
+}
+
+TEST_CASE("ReceiptWriter writes fixed-size binary records", "[Receipt]") {
+    std::string bytes;
+    ReceiptWriter::writeBinary(pricedReceipt(), bytes);
+    REQUIRE(bytes.size() == sizeof(ReceiptWriter::BinaryHeader) + 3 * sizeof(ReceiptWriter::BinaryLine) +
+                                2 * sizeof(ReceiptWriter::BinaryDeal));
+
+    ReceiptWriter::BinaryHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    REQUIRE(std::memcmp(header.magic, "RCP1", 4) == 0);
+    REQUIRE(header.number == 7);
+    REQUIRE(header.lineCount == 3);
+    REQUIRE(header.dealCount == 2);
+    REQUIRE(header.total == 500);
+
+    ReceiptWriter::BinaryLine line;
+    std::memcpy(&line, bytes.data() + sizeof(header) + sizeof(line), sizeof(line));
+    REQUIRE(line.itemIndex == 1);
+    REQUIRE(line.discount == 50);
+    REQUIRE(line.dealType == static_cast<std::uint8_t>(DealType::TYPE2));
+
+    ReceiptWriter::BinaryDeal deal;
+    std::memcpy(&deal, bytes.data() + sizeof(header) + 3 * sizeof(line) + sizeof(deal), sizeof(deal));
+    REQUIRE(deal.dealType == static_cast<std::uint8_t>(DealType::TYPE2));
+    REQUIRE(deal.dealIndex == 1);
+}
+
+TEST_CASE("ReceiptWriter names the rules behind each discount", "[Receipt]") {
+    Checkout checkout(Catalog::fromJson(R"(
+    {
+      "items": [
+        {"id": "A1", "name": "Apple", "price": 1.00},
+        {"id": "B2", "name": "Banana", "price": 0.50}
+      ],
+      "deals": {
+        "rules": [
+          {"kind": "multi_buy", "items": ["A1"], "buy": 2, "get": 1, "percent_off": 50, "name": "Buy 2 apples get 1 half off"},
+          {"kind": "bundle", "items": ["A1", "B2"], "percent_off": 20, "name": "Fruit bowl"}
+        ]
+      }
+    }
+    )"_json));
+    checkout.setSink(nullptr);
+    checkout.scanItem("A1 4");
+    checkout.scanItem("B2");
+    checkout.applyDeals();
+    Receipt receipt = checkout.getReceipt();
+
+    // Both rules are of type "rule"; only their names tell them apart
+    std::string line;
+    ReceiptWriter::writeJsonLine(receipt, line);
+    json parsed = json::parse(line);
+    REQUIRE(parsed["deals"].size() == 2);
+    REQUIRE(parsed["deals"][0]["type"] == "rule");
+    REQUIRE(parsed["deals"][0]["name"] == "Buy 2 apples get 1 half off");
+    REQUIRE(parsed["deals"][1]["type"] == "rule");
+    REQUIRE(parsed["deals"][1]["name"] == "Fruit bowl");
+
+    std::string csv;
+    ReceiptWriter::writeCsv(receipt, csv);
+    REQUIRE(csv ==
+            "0,A1,Apple,4,1.00,4.00,0.50,3.50,rule,Buy 2 apples get 1 half off\n"
+            "0,B2,Banana,1,0.50,0.50,0.10,0.40,rule,Fruit bowl\n");
+
+    std::string bytes;
+    ReceiptWriter::writeBinary(receipt, bytes);
+    ReceiptWriter::BinaryDeal deals[2];
+    std::memcpy(deals, bytes.data() + sizeof(ReceiptWriter::BinaryHeader) + 2 * sizeof(ReceiptWriter::BinaryLine),
+                sizeof(deals));
+    REQUIRE(deals[0].dealIndex == 0);
+    REQUIRE(deals[1].dealIndex == 1);
+}
+
+TEST_CASE("ReplayDriver writes receipts in the chosen format", "[Receipt]") {
+    std::istringstream input("A1 4\nB2\nC3\n\nA1\n");
+    std::ostringstream output;
+    ReplayDriver driver(receiptCatalog());
+    driver.setFormat(ReplayDriver::Format::CSV);
+    driver.run(input, output);
+    REQUIRE(output.str() ==
+            "receipt,item_id,name,quantity,unit_price,subtotal,discount,total,deal,deal_name\n"
+            "1,A1,Apple,4,1.00,4.00,1.00,3.00,type1,Deal Type 1\n"
+            "1,B2,\"Banana, ripe\",1,0.50,0.50,0.50,0.00,type2,Deal Type 2\n"
+            "1,C3,\"Cherry \"\"red\"\"\",1,2.00,2.00,0.00,2.00,none,\n"
+            "2,A1,Apple,1,1.00,1.00,0.00,1.00,none,\n");
+}
@@ -0,0 +1,71 @@
+// ReplayDriverTests.cpp
+#include "catch.hpp"
+
+#include "ReplayDriver.h"
+#include "TestCatalogs.h"
+#include <sstream>
+
+TEST_CASE("ReplayDriver prices each basket in the log", "[ReplayDriver]") {
+    std::istringstream input(
+        "A1 4\n"
+        "b2\n"
+        "C3\n"
+        "done\n"
+        "\n"
+        "  \n"
+        "C3 2\n"
+        "Z9\n"
+        "help\n"
+        "C3 -1\n"
+        "\n"
+        "A1 3");
+    std::ostringstream output;
+
+    ReplayDriver driver(test::fruitCatalog());
+    ReplayDriver::Summary summary = driver.run(input, output);
+
+    REQUIRE(summary.baskets == 3);
+    REQUIRE(summary.scans == 8);
+    REQUIRE(output.str() ==
+            "{\"basket\":1,\"lines\":3,\"units\":6,\"subtotal\":6.50,\"savings\":1.50,\"total\":5.00,\"deals\":2}\n"
+            "{\"basket\":2,\"lines\":1,\"units\":1,\"subtotal\":2.00,\"savings\":0.00,\"total\":2.00,\"deals\":0}\n"
+            "{\"basket\":3,\"lines\":1,\"units\":3,\"subtotal\":3.00,\"savings\":1.00,\"total\":2.00,\"deals\":1}\n");
+}
+
+TEST_CASE("ReplayDriver writes nothing for an empty log", "[ReplayDriver]") {
+    std::istringstream input("\n\ndone\n");
+    std::ostringstream output;
+
+    ReplayDriver driver(test::fruitCatalog());
+    REQUIRE(driver.run(input, output).baskets == 0);
+    REQUIRE(output.str().empty());
+}
+
+TEST_CASE("Parallel replay matches single-threaded replay", "[ReplayDriver]") {
+    // Enough baskets to span several chunks and leave a partial batch at the end
+    std::string log;
+    const char* scans[] = {"A1 4", "B2", "C3 2", "a1 -1", "B2 3", "X7", "C3 100", "A1 0"};
+    for (int basket = 0; basket < 40000; ++basket) {
+        for (int line = 0; line <= basket % 5; ++line) {
+            log += scans[(basket + line * 3) % 8];
+            log += '\n';
+        }
+        log += basket % 7 == 0 ? "done\n" : "\n";
+    }
+
+    std::istringstream serialInput(log);
+    std::ostringstream serialOutput;
+    ReplayDriver serial(test::fruitCatalog());
+    ReplayDriver::Summary serialSummary = serial.run(serialInput, serialOutput);
+
+    std::istringstream parallelInput(log);
+    std::ostringstream parallelOutput;
+    ReplayDriver parallel(test::fruitCatalog(), DealStrategy::GREEDY, 4);
+    REQUIRE(parallel.getThreadCount() == 4);
+    ReplayDriver::Summary parallelSummary = parallel.run(parallelInput, parallelOutput);
+
+    REQUIRE(serialSummary.baskets == 40000);
+    REQUIRE(parallelSummary.baskets == serialSummary.baskets);
+    REQUIRE(parallelSummary.scans == serialSummary.scans);
+    REQUIRE(parallelOutput.str() == serialOutput.str());
+}
@@ -0,0 +1,192 @@
+// RuleDealTests.cpp
+#include "catch.hpp"
+
+#include "Deal.h"
+#include <random>
+
+namespace {
+
+DealRule multiBuy(int buy, int get, int percentOff, const std::string& name) {
+    DealRule rule;
+    rule.op = DealRule::Op::MULTI_BUY;
+    rule.groupUnits = buy + get;
+    rule.discountedUnits = get;
+    rule.percentOff = percentOff;
+    rule.name = name;
+    return rule;
+}
+
+// Same lines, deal state and applications, field by field
+bool sameResult(const PricedBasket& a, const std::vector<DealApplication>& aDeals, const PricedBasket& b,
+                const std::vector<DealApplication>& bDeals) {
+    if (a.size() != b.size() || aDeals.size() != bDeals.size()) {
+        return false;
+    }
+    for (std::size_t line = 0; line < a.size(); ++line) {
+        if (a.getAvailableQuantity(line) != b.getAvailableQuantity(line) ||
+            a.getDiscount(line) != b.getDiscount(line) || a.getDealType(line) != b.getDealType(line)) {
+            return false;
+        }
+    }
+    for (std::size_t i = 0; i < aDeals.size(); ++i) {
+        if (aDeals[i].itemIndex != bDeals[i].itemIndex || aDeals[i].sets != bDeals[i].sets ||
+            aDeals[i].discount != bDeals[i].discount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE("RuleDeal expresses Deal Type 1 and Deal Type 2", "[RuleDeal]") {
+    std::vector<Item> items = {Item("A1", "Apple", 1.00), Item("B2", "Banana", 0.50), Item("C3", "Cherry", 2.00),
+                               Item("D4", "Date", 0.50)};
+    DealType1 classicType1({0});
+    DealType2 classicType2({0, 1, 3});
+    RuleDeal ruleType1({0}, DealRule::dealType1());
+    RuleDeal ruleType2({0, 1, 3}, DealRule::dealType2());
+
+    REQUIRE(ruleType1.getType() == DealType::TYPE1);
+    REQUIRE(ruleType2.getType() == DealType::TYPE2);
+    REQUIRE(ruleType1.getStage() == classicType1.getStage());
+    REQUIRE(ruleType2.getStage() == classicType2.getStage());
+    REQUIRE_FALSE(ruleType1.needsEveryItem());
+    REQUIRE(ruleType2.needsEveryItem());
+
+    // Random baskets price, limit and print the same either way; Banana and Date tie for cheapest
+    std::mt19937 random(7);
+    bool allMatch = true;
+    for (int round = 0; round < 500; ++round) {
+        PricedBasket classic;
+        for (std::uint32_t i = 0; i < items.size(); ++i) {
+            int quantity = static_cast<int>(random() % 8);
+            if (quantity > 0) {
+                classic.setLine(i, quantity, items[i].getPrice());
+            }
+        }
+        PricedBasket rule = classic;
+        int maxSets = round % 2 == 0 ? std::numeric_limits<int>::max() : static_cast<int>(random() % 3);
+
+        std::vector<DealApplication> classicDeals;
+        std::vector<DealApplication> ruleDeals;
+        classicType1.applyDeal(classic, classicDeals, maxSets);
+        classicType2.applyDeal(classic, classicDeals, maxSets);
+        ruleType1.applyDeal(rule, ruleDeals, maxSets);
+        ruleType2.applyDeal(rule, ruleDeals, maxSets);
+
+        allMatch = allMatch && sameResult(classic, classicDeals, rule, ruleDeals);
+        for (std::size_t i = 0; allMatch && i < ruleDeals.size(); ++i) {
+            allMatch = classicDeals[i].deal->describe(classicDeals[i], items) ==
+                       ruleDeals[i].deal->describe(ruleDeals[i], items);
+        }
+    }
+    REQUIRE(allMatch);
+}
+
+TEST_CASE("RuleDeal multi-buy discounts part of each group of units", "[RuleDeal]") {
+    Item apple("A1", "Apple", 1.00);
+    RuleDeal buyTwoGetOneHalfOff({0}, multiBuy(2, 1, 50, "Buy 2 get 1 at 50% off"));
+    REQUIRE(buyTwoGetOneHalfOff.getType() == DealType::RULE);
+    REQUIRE(buyTwoGetOneHalfOff.getStage() == 0);
+
+    PricedBasket basket;
+    basket.setLine(0, 7, apple.getPrice());
+    std::vector<DealApplication> appliedDeals;
+    buyTwoGetOneHalfOff.applyDeal(basket, appliedDeals);
+
+    REQUIRE(basket.getAvailableQuantity(0) == 1);
+    REQUIRE(basket.getDiscount(0) == Money::fromDouble(1.00));
+    REQUIRE(basket.getDealType(0) == DealType::RULE);
+    REQUIRE(appliedDeals.size() == 1);
+    REQUIRE(appliedDeals[0].sets == 2);
+    REQUIRE(appliedDeals[0].discount == Money::fromDouble(0.50));
+    REQUIRE(buyTwoGetOneHalfOff.describe(appliedDeals[0], {apple}) ==
+            "Buy 2 get 1 at 50% off applied to 3 x Apple (-$0.50)");
+}
+
+TEST_CASE("RuleDeal bundle discounts the cheapest items of each set", "[RuleDeal]") {
+    std::vector<Item> items = {Item("A1", "Apple", 1.00), Item("B2", "Banana", 0.50), Item("C3", "Cherry", 2.00),
+                               Item("D4", "Date", 0.50)};
+    DealRule rule;
+    rule.op = DealRule::Op::BUNDLE;
+    rule.discountedUnits = 2;
+    rule.percentOff = 50;
+    rule.name = "Buy 4 different, 2 cheapest at 50% off";
+    RuleDeal bundle({0, 1, 2, 3}, rule);
+    REQUIRE(bundle.getType() == DealType::RULE);
+    REQUIRE(bundle.getStage() == 1);
+
+    PricedBasket basket;
+    basket.setLine(0, 2, items[0].getPrice());
+    basket.setLine(1, 3, items[1].getPrice());
+    basket.setLine(2, 2, items[2].getPrice());
+    REQUIRE_FALSE(bundle.canApply(basket.getPresence()));
+    std::vector<DealApplication> appliedDeals;
+    bundle.applyDeal(basket, appliedDeals);
+    REQUIRE(appliedDeals.empty());
+
+    // Banana and Date tie for cheapest and are both discounted; Apple is not
+    basket.setLine(3, 5, items[3].getPrice());
+    bundle.applyDeal(basket, appliedDeals);
+    REQUIRE(appliedDeals.size() == 1);
+    REQUIRE(appliedDeals[0].sets == 2);
+    REQUIRE(appliedDeals[0].itemIndex == 1);
+    REQUIRE(appliedDeals[0].discount == Money::fromDouble(0.50));
+    REQUIRE(basket.getDiscount(0) == Money());
+    REQUIRE(basket.getDiscount(1) == Money::fromDouble(0.50));
+    REQUIRE(basket.getDiscount(3) == Money::fromDouble(0.50));
+    REQUIRE(basket.getAvailableQuantity(3) == 3);
+    REQUIRE(bundle.describe(appliedDeals[0], items) ==
+            "Buy 4 different, 2 cheapest at 50% off applied to Apple, Banana, Cherry, Date (-$0.50)");
+}
+
+TEST_CASE("RuleDeal tiers discount every remaining unit once a threshold is reached", "[RuleDeal]") {
+    std::vector<Item> items = {Item("A1", "Apple", 1.00), Item("B2", "Banana", 0.50), Item("C3", "Cherry", 2.00)};
+    DealRule tieredRule;
+    tieredRule.op = DealRule::Op::TIERED_UNITS;
+    tieredRule.tiers = {{3, 10}, {6, 20}};
+    tieredRule.name = "Tiered bundle";
+    RuleDeal tiered({0, 1}, tieredRule);
+
+    DealRule spendRule;
+    spendRule.op = DealRule::Op::TIERED_SPEND;
+    spendRule.tiers = {{1000, 5}};
+    spendRule.name = "Spend threshold";
+    RuleDeal spend({0, 2}, spendRule);
+    REQUIRE(tiered.getStage() == 2);
+    REQUIRE_FALSE(spend.needsEveryItem());
+
+    PricedBasket basket;
+    basket.setLine(0, 1, items[0].getPrice());
+    basket.setLine(1, 1, items[1].getPrice());
+    std::vector<DealApplication> appliedDeals;
+    tiered.applyDeal(basket, appliedDeals);
+    REQUIRE(appliedDeals.empty());
+
+    // Three units reach the first tier; six reach the second
+    basket.setLine(1, 2, items[1].getPrice());
+    tiered.applyDeal(basket, appliedDeals);
+    REQUIRE(appliedDeals.size() == 1);
+    REQUIRE(appliedDeals[0].discount == Money::fromDouble(0.20));
+    basket.clearDeals();
+    basket.setLine(1, 5, items[1].getPrice());
+    appliedDeals.clear();
+    tiered.applyDeal(basket, appliedDeals);
+    REQUIRE(appliedDeals[0].discount == Money::fromDouble(0.70));
+    REQUIRE(basket.getDiscount(0) == Money::fromDouble(0.20));
+    REQUIRE(basket.getDiscount(1) == Money::fromDouble(0.50));
+    REQUIRE(tiered.describe(appliedDeals[0], items) == "Tiered bundle applied to Apple, Banana (-$0.70)");
+
+    // Units used by the tiered rule no longer count towards the spend threshold
+    basket.setLine(2, 4, items[2].getPrice());
+    appliedDeals.clear();
+    spend.applyDeal(basket, appliedDeals);
+    REQUIRE(appliedDeals.empty());
+    basket.setLine(2, 5, items[2].getPrice());
+    spend.applyDeal(basket, appliedDeals);
+    REQUIRE(appliedDeals.size() == 1);
+    REQUIRE(appliedDeals[0].itemIndex == 2);
+    REQUIRE(appliedDeals[0].discount == Money::fromDouble(0.50));
+    REQUIRE(basket.getAvailableQuantity(2) == 0);
+}
@@ -0,0 +1,187 @@
+// ScanJournalTests.cpp
+#include "catch.hpp"
+
+#include "Checkout.h"
+#include "ScanJournal.h"
+#include "TestCatalogs.h"
+#include <cstdio>
+#include <fstream>
+
+#ifdef __linux__
+#include <csignal>
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+std::string journalPath(const std::string& name) {
+    std::string path = "scan-journal-test-" + name + ".wal";
+    std::remove(path.c_str());
+    return path;
+}
+
+} // namespace
+
+TEST_CASE("ScanJournal recovers the carts still in progress", "[ScanJournal]") {
+    std::string path = journalPath("recover");
+    {
+        ScanJournal journal(path);
+        REQUIRE(journal.getRecoveredCarts().empty());
+        journal.recordQuantity(1, "A1", 2);
+        journal.recordQuantity(1, "B2", 1);
+        journal.recordQuantity(2, "C3", 4);
+        journal.recordQuantity(1, "A1", 5);
+        journal.recordQuantity(1, "B2", 0);
+        journal.recordQuantity(3, "A1", 1);
+        journal.recordBasketClosed(3);
+        REQUIRE(journal.hasPending());
+        journal.commit();
+        REQUIRE_FALSE(journal.hasPending());
+
+        // Left uncommitted when the process dies
+        journal.recordQuantity(2, "C3", 9);
+    }
+
+    ScanJournal journal(path);
+    const auto& carts = journal.getRecoveredCarts();
+    REQUIRE(carts.size() == 2);
+    REQUIRE(carts.at(1).size() == 1);
+    REQUIRE(carts.at(1)[0].itemId == "A1");
+    REQUIRE(carts.at(1)[0].quantity == 5);
+    REQUIRE(carts.at(2)[0].quantity == 9);
+
+    std::vector<ScanJournal::CartLine> cart = journal.takeRecoveredCart(2);
+    REQUIRE(cart.size() == 1);
+    REQUIRE(journal.takeRecoveredCart(2).empty());
+    std::remove(path.c_str());
+}
+
+TEST_CASE("ScanJournal cuts off a record torn by a crash", "[ScanJournal]") {
+    std::string path = journalPath("torn");
+    {
+        ScanJournal journal(path);
+        journal.recordQuantity(7, "A1", 3);
+        journal.recordQuantity(7, "C3", 1);
+        journal.commit();
+    }
+
+    // Half of a record, then a record whose bytes were not all written
+    {
+        std::string record;
+        ScanJournal::RecordHeader header = {};
+        header.lane = 7;
+        header.quantity = 50;
+        header.type = static_cast<std::uint8_t>(ScanJournal::RecordType::QUANTITY);
+        header.idLength = 2;
+        record.append(reinterpret_cast<const char*>(&header), sizeof(header));
+        record += "B2";
+        std::ofstream file(path, std::ios::binary | std::ios::app);
+        file.write(record.data(), static_cast<std::streamsize>(record.size()));
+    }
+    {
+        ScanJournal journal(path);
+        REQUIRE(journal.getRecoveredCarts().at(7).size() == 2);
+
+        // Records appended after recovery are not hidden behind the torn one
+        journal.recordQuantity(7, "B2", 2);
+    }
+
+    ScanJournal journal(path);
+    const std::vector<ScanJournal::CartLine>& cart = journal.getRecoveredCarts().at(7);
+    REQUIRE(cart.size() == 3);
+    REQUIRE(cart[2].itemId == "B2");
+    REQUIRE(cart[2].quantity == 2);
+    std::remove(path.c_str());
+}
+
+#ifdef __linux__
+TEST_CASE("ScanJournal cuts a failed commit back and writes it again", "[ScanJournal]") {
+    std::string path = journalPath("failed");
+    {
+        ScanJournal journal(path);
+        journal.recordQuantity(4, "A1", 1);
+        journal.commit();
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        std::streamoff committed = file.tellg();
+
+        // A file size limit lets the next commit write part of a record and then fail, like a full disk
+        rlimit original;
+        ::getrlimit(RLIMIT_FSIZE, &original);
+        rlimit limited = original;
+        limited.rlim_cur = static_cast<rlim_t>(committed) + 10;
+        auto previousHandler = std::signal(SIGXFSZ, SIG_IGN);
+        ::setrlimit(RLIMIT_FSIZE, &limited);
+        journal.recordQuantity(4, "B2", 2);
+        journal.recordQuantity(4, "C3", 3);
+        bool failed = false;
+        try {
+            journal.commit();
+        } catch (const std::runtime_error&) {
+            failed = true;
+        }
+        ::setrlimit(RLIMIT_FSIZE, &original);
+        std::signal(SIGXFSZ, previousHandler);
+
+        REQUIRE(failed);
+        REQUIRE(journal.hasPending());
+        REQUIRE(std::ifstream(path, std::ios::binary | std::ios::ate).tellg() == committed);
+        journal.commit();
+        REQUIRE_FALSE(journal.hasPending());
+    }
+
+    ScanJournal journal(path);
+    const std::vector<ScanJournal::CartLine>& cart = journal.getRecoveredCarts().at(4);
+    REQUIRE(cart.size() == 3);
+    REQUIRE(cart[2].itemId == "C3");
+    std::remove(path.c_str());
+}
+#endif
+
+TEST_CASE("ScanJournal rejects files that are not journals", "[ScanJournal]") {
+    std::string path = journalPath("invalid");
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "{\"items\": []}";
+    }
+    REQUIRE_THROWS_AS(ScanJournal(path), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Checkout rebuilds a journaled cart after a crash", "[ScanJournal]") {
+    std::string path = journalPath("checkout");
+    Checkout::Totals before;
+    {
+        auto journal = std::make_shared<ScanJournal>(path);
+        Checkout checkout(test::fruitCatalog());
+        checkout.setSink(nullptr);
+        checkout.setJournal(journal, 4);
+
+        // A finished basket is not recovered
+        checkout.scanItem("C3");
+        checkout.newBasket();
+
+        checkout.scanItem("A1 4");
+        checkout.scanItem("B2 2");
+        checkout.scanItem("C3");
+        checkout.scanItem("B2 -1");
+        checkout.voidItem("c3");
+        checkout.scanItem("C3 2");
+        journal->commit();
+        before = checkout.getTotals();
+    }
+
+    auto journal = std::make_shared<ScanJournal>(path);
+    Checkout checkout(test::fruitCatalog());
+    checkout.setSink(nullptr);
+    REQUIRE(checkout.restoreCart(journal->takeRecoveredCart(4)) == 3);
+    checkout.setJournal(journal, 4);
+
+    Checkout::Totals after = checkout.getTotals();
+    REQUIRE(after.units == before.units);
+    REQUIRE(after.total == before.total);
+    REQUIRE(after.deals == before.deals);
+    REQUIRE(checkout.getCartQuantity("A1") == 4);
+    REQUIRE(checkout.getCartQuantity("B2") == 1);
+    REQUIRE(checkout.getCartQuantity("C3") == 2);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,52 @@
+// ScanParserTests.cpp
+#include "catch.hpp"
+
+#include "ScanParser.h"
+
+TEST_CASE("parseScanLine accepts the ID [quantity] grammar", "[ScanParser]") {
+    ScanCommand command = parseScanLine("A1 3");
+    REQUIRE(command.error == ScanParseError::NONE);
+    REQUIRE(command.type == ScanCommandType::SCAN);
+    REQUIRE(command.itemId == "A1");
+    REQUIRE(command.quantity == 3);
+
+    // Quantity defaults to one
+    command = parseScanLine("b2");
+    REQUIRE(command.error == ScanParseError::NONE);
+    REQUIRE(command.itemId == "b2");
+    REQUIRE(command.quantity == 1);
+
+    // Surrounding whitespace, tabs and negative quantities
+    command = parseScanLine("  C3\t-2  ");
+    REQUIRE(command.itemId == "C3");
+    REQUIRE(command.quantity == -2);
+
+    // Whitespace between ID and quantity is optional
+    command = parseScanLine("A1-3");
+    REQUIRE(command.itemId == "A1");
+    REQUIRE(command.quantity == -3);
+
+    // A sixth character must start the quantity
+    command = parseScanLine("ABCDE5");
+    REQUIRE(command.itemId == "ABCDE");
+    REQUIRE(command.quantity == 5);
+
+    command = parseScanLine("A1 -2147483648");
+    REQUIRE(command.error == ScanParseError::NONE);
+    REQUIRE(command.quantity == -2147483647 - 1);
+
+    REQUIRE(parseScanLine(" help ").type == ScanCommandType::HELP);
+}
+
+TEST_CASE("parseScanLine reports structured errors", "[ScanParser]") {
+    for (const char* line : {"", "   ", "ABCDEF", "A1 -", "A1 +3", "A1 3x", "A1 - 3", "A_1", "A1 3 4", "HELP me"}) {
+        INFO(line);
+        REQUIRE(parseScanLine(line).error == ScanParseError::INVALID_FORMAT);
+    }
+
+    REQUIRE(parseScanLine("A1 2147483648").error == ScanParseError::QUANTITY_OUT_OF_RANGE);
+    REQUIRE(parseScanLine("A1 99999999999999999999999").error == ScanParseError::QUANTITY_OUT_OF_RANGE);
+
+    // Format errors take precedence over range errors, as with the regex grammar
+    REQUIRE(parseScanLine("A1 99999999999999999999x").error == ScanParseError::INVALID_FORMAT);
+}
@@ -0,0 +1,49 @@
+#ifndef TEST_CATALOGS_H
+#define TEST_CATALOGS_H
+
+#include <memory>
+#include "Catalog.h"
+#include "json.hpp"
+
+using json = nlohmann::json;
+
+namespace test {
+
+/**
+ * @brief Builds the catalog most tests use: Apple (A1), Banana (B2) and Cherry (C3).
+ *
+ * Apple is eligible for Deal Type 1 and the three items form one Deal Type 2 set. Items and
+ * the set are listed out of ID order, so loaders have to sort them.
+ *
+ * @param applePrice Price of Apple.
+ * @return The catalog data.
+ */
+inline json fruitCatalogData(double applePrice = 1.00) {
+    json data = R"(
+    {
+      "items": [
+        {"id": "C3", "name": "Cherry", "price": 2.00},
+        {"id": "A1", "name": "Apple", "price": 1.00},
+        {"id": "B2", "name": "Banana", "price": 0.50}
+      ],
+      "deals": {
+        "deal_type_1": ["A1"],
+        "deal_type_2": [["C3", "A1", "B2"]]
+      }
+    }
+    )"_json;
+    data["items"][1]["price"] = applePrice;
+    return data;
+}
+
+/**
+ * @brief Loads the catalog built by fruitCatalogData().
+ * @return The catalog.
+ */
+inline std::shared_ptr<const Catalog> fruitCatalog() {
+    return Catalog::fromJson(fruitCatalogData());
+}
+
+} // namespace test
+
+#endif // TEST_CATALOGS_H
@@ -0,0 +1,67 @@
+// WorkStealingPoolTests.cpp
+#include "catch.hpp"
+
+#include "WorkStealingPool.h"
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+
+TEST_CASE("WorkStealingPool runs every task exactly once", "[WorkStealingPool]") {
+    WorkStealingPool pool(4);
+    REQUIRE(pool.size() == 4);
+
+    for (std::size_t count : {0u, 1u, 3u, 1000u}) {
+        std::vector<std::atomic<int>> runs(count);
+        std::atomic<bool> workerInRange(true);
+        pool.parallelFor(count, [&](unsigned worker, std::size_t index) {
+            if (worker >= pool.size()) {
+                workerInRange = false;
+            }
+            ++runs[index];
+        });
+
+        bool exactlyOnce = true;
+        for (const std::atomic<int>& run : runs) {
+            exactlyOnce = exactlyOnce && run == 1;
+        }
+        REQUIRE(exactlyOnce);
+        REQUIRE(workerInRange);
+    }
+}
+
+TEST_CASE("WorkStealingPool idle workers steal queued tasks", "[WorkStealingPool]") {
+    WorkStealingPool pool(2);
+
+    // Worker 0's first block is slow, so worker 1 must take some of it
+    std::vector<unsigned> ranOn(16);
+    pool.parallelFor(16, [&](unsigned worker, std::size_t index) {
+        ranOn[index] = worker;
+        if (index < 8) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    });
+
+    bool stolen = false;
+    for (std::size_t i = 0; i < 8; ++i) {
+        stolen = stolen || ranOn[i] == 1;
+    }
+    REQUIRE(stolen);
+}
+
+TEST_CASE("WorkStealingPool rethrows task exceptions", "[WorkStealingPool]") {
+    WorkStealingPool pool(3);
+    std::atomic<int> completed(0);
+    REQUIRE_THROWS_AS(pool.parallelFor(100,
+                                       [&](unsigned, std::size_t index) {
+                                           if (index == 42) {
+                                               throw std::runtime_error("task failed");
+                                           }
+                                           ++completed;
+                                       }),
+                      std::runtime_error);
+    REQUIRE(completed == 99);
+
+    // The pool stays usable after a failed job
+    pool.parallelFor(10, [&](unsigned, std::size_t) { ++completed; });
+    REQUIRE(completed == 109);
+}
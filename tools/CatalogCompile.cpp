@@ -0,0 +1,53 @@
+// CatalogCompile.cpp
+#include "BinaryCatalog.h"
+#include "CustomExceptions.h"
+#include <fstream>
+#include <iostream>
+#include <string>
+
+/**
+ * @brief Converts a JSON catalog into the binary image format read by BinaryCatalog.
+ *
+ * Usage: catalog-compile <input.json> <output.bin>
+ */
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <input.json> <output.bin>\n";
+        return EXIT_FAILURE;
+    }
+
+    const std::string inputFile = argv[1];
+    const std::string outputFile = argv[2];
+
+    try {
+        std::ifstream file(inputFile);
+        if (!file) {
+            throw std::runtime_error("Cannot open data file: " + inputFile);
+        }
+
+        json data;
+        file >> data;
+
+        BinaryCatalog::compile(data, outputFile);
+
+        // Map the result to make sure it round-trips before reporting success
+        BinaryCatalog catalog(outputFile);
+        std::cout << "Compiled " << catalog.getItemCount() << " items, "
+                  << catalog.getDealType1Count() << " Deal Type 1 items and "
+                  << catalog.getDealType2Count() << " Deal Type 2 sets into " << outputFile << "\n";
+    } catch (const json::parse_error& e) {
+        std::cerr << "JSON Parsing Error: " << e.what() << "\n";
+        return EXIT_FAILURE;
+    } catch (const InvalidItemException& e) {
+        std::cerr << "Item Loading Error: " << e.what() << "\n";
+        return EXIT_FAILURE;
+    } catch (const InvalidDealException& e) {
+        std::cerr << "Deal Loading Error: " << e.what() << "\n";
+        return EXIT_FAILURE;
+    } catch (const std::exception& e) {
+        std::cerr << "Error compiling catalog: " << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
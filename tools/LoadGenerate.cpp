@@ -0,0 +1,182 @@
+// LoadGenerate.cpp
+#include "BinaryCatalog.h"
+#include "Catalog.h"
+#include "CustomExceptions.h"
+#include "LoadGenerator.h"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr << "Usage:\n"
+              << "  " << program << " catalog [options] <output.json|output.bin>\n"
+              << "      --items N              Number of items (default 1000)\n"
+              << "      --price-min X          Lowest price (default 0.25)\n"
+              << "      --price-max X          Highest price (default 25.00)\n"
+              << "      --price-dist D         uniform or lognormal (default uniform)\n"
+              << "      --deal1-coverage F     Fraction of items with Deal Type 1 (default 0.10)\n"
+              << "      --deal2-density F      Deal Type 2 sets per item (default 0.05)\n"
+              << "      --deal2-pool F         Fraction of items Deal Type 2 sets use (default 1.00)\n"
+              << "      --seed N               Random seed (default 1)\n"
+              << "  " << program << " baskets [options] <catalog> <output.txt|->\n"
+              << "      --baskets N            Number of baskets (default 1000)\n"
+              << "      --zipf S               Item popularity skew (default 1.0)\n"
+              << "      --lines X              Average scan lines per basket (default 8)\n"
+              << "      --max-quantity N       Largest quantity per line (default 5)\n"
+              << "      --removal-rate F       Chance of a removal after each line (default 0.05)\n"
+              << "      --seed N               Random seed (default 1)\n";
+}
+
+// Splits "--name value" pairs from the positional arguments
+bool parseArguments(int argc, char* argv[], std::map<std::string, std::string>& options,
+                    std::vector<std::string>& positional) {
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.size() > 2 && arg.compare(0, 2, "--") == 0) {
+            if (i + 1 >= argc) {
+                return false;
+            }
+            options[arg.substr(2)] = argv[++i];
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    return true;
+}
+
+double number(std::map<std::string, std::string>& options, const std::string& name, double fallback) {
+    auto it = options.find(name);
+    if (it == options.end()) {
+        return fallback;
+    }
+    std::size_t used = 0;
+    double value = std::stod(it->second, &used);
+    if (used != it->second.size()) {
+        throw std::invalid_argument("Invalid value for --" + name + ": " + it->second);
+    }
+    options.erase(it);
+    return value;
+}
+
+std::uint64_t count(std::map<std::string, std::string>& options, const std::string& name, std::uint64_t fallback) {
+    double value = number(options, name, static_cast<double>(fallback));
+    if (value < 0.0 || value > 1e15 || value != static_cast<double>(static_cast<std::uint64_t>(value))) {
+        throw std::invalid_argument("--" + name + " must be a whole number.");
+    }
+    return static_cast<std::uint64_t>(value);
+}
+
+bool hasExtension(const std::string& path, const std::string& extension) {
+    return path.size() >= extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+} // namespace
+
+/**
+ * @brief Generates synthetic catalogs and basket streams for benchmarks and soak tests.
+ *
+ * Catalogs are written as JSON, or compiled to a binary catalog when the output ends in `.bin`.
+ * Basket streams use the replay format read by `SupermarketCheckout --replay`.
+ */
+int main(int argc, char* argv[]) {
+    std::map<std::string, std::string> options;
+    std::vector<std::string> positional;
+    if (argc < 2 || !parseArguments(argc, argv, options, positional)) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    const std::string command = argv[1];
+
+    try {
+        if (command == "catalog" && positional.size() == 1) {
+            LoadGenerator::CatalogOptions catalogOptions;
+            std::uint64_t items = count(options, "items", catalogOptions.items);
+            if (items > LoadGenerator::MAX_ITEMS) {
+                throw std::invalid_argument("--items must be at most " + std::to_string(LoadGenerator::MAX_ITEMS) + ".");
+            }
+            catalogOptions.items = static_cast<std::uint32_t>(items);
+            catalogOptions.priceMin = number(options, "price-min", catalogOptions.priceMin);
+            catalogOptions.priceMax = number(options, "price-max", catalogOptions.priceMax);
+            catalogOptions.dealType1Coverage = number(options, "deal1-coverage", catalogOptions.dealType1Coverage);
+            catalogOptions.dealType2Density = number(options, "deal2-density", catalogOptions.dealType2Density);
+            catalogOptions.dealType2Pool = number(options, "deal2-pool", catalogOptions.dealType2Pool);
+            catalogOptions.seed = count(options, "seed", catalogOptions.seed);
+            if (options.count("price-dist")) {
+                const std::string& distribution = options["price-dist"];
+                if (distribution != "uniform" && distribution != "lognormal") {
+                    throw std::invalid_argument("Unknown price distribution: " + distribution);
+                }
+                catalogOptions.priceDistribution =
+                    distribution == "lognormal" ? PriceDistribution::LOG_NORMAL : PriceDistribution::UNIFORM;
+                options.erase("price-dist");
+            }
+            if (!options.empty()) {
+                throw std::invalid_argument("Unknown option: --" + options.begin()->first);
+            }
+
+            json data = LoadGenerator::generateCatalog(catalogOptions);
+            const std::string& outputFile = positional[0];
+            if (hasExtension(outputFile, ".bin")) {
+                BinaryCatalog::compile(data, outputFile);
+            } else {
+                std::ofstream file(outputFile);
+                if (!file) {
+                    throw std::runtime_error("Cannot write catalog: " + outputFile);
+                }
+                file << data.dump(2) << "\n";
+            }
+            std::cerr << "Generated " << data["items"].size() << " items, " << data["deals"]["deal_type_1"].size()
+                      << " Deal Type 1 items and " << data["deals"]["deal_type_2"].size() << " Deal Type 2 sets into "
+                      << outputFile << "\n";
+        } else if (command == "baskets" && positional.size() == 2) {
+            LoadGenerator::BasketOptions basketOptions;
+            basketOptions.baskets = count(options, "baskets", basketOptions.baskets);
+            basketOptions.zipfExponent = number(options, "zipf", basketOptions.zipfExponent);
+            basketOptions.meanLines = number(options, "lines", basketOptions.meanLines);
+            std::uint64_t maxQuantity = count(options, "max-quantity", static_cast<std::uint64_t>(basketOptions.maxQuantity));
+            if (maxQuantity > 100) {
+                throw std::invalid_argument("--max-quantity must be at most 100.");
+            }
+            basketOptions.maxQuantity = static_cast<int>(maxQuantity);
+            basketOptions.removalRate = number(options, "removal-rate", basketOptions.removalRate);
+            basketOptions.seed = count(options, "seed", basketOptions.seed);
+            if (!options.empty()) {
+                throw std::invalid_argument("Unknown option: --" + options.begin()->first);
+            }
+
+            std::shared_ptr<const Catalog> catalog = Catalog::fromFile(positional[0]);
+            if (positional[1] == "-") {
+                std::ios::sync_with_stdio(false);
+                LoadGenerator::generateBaskets(*catalog, basketOptions, std::cout);
+            } else {
+                std::ofstream file(positional[1]);
+                if (!file) {
+                    throw std::runtime_error("Cannot write baskets: " + positional[1]);
+                }
+                LoadGenerator::generateBaskets(*catalog, basketOptions, file);
+            }
+        } else {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    } catch (const json::parse_error& e) {
+        std::cerr << "JSON Parsing Error: " << e.what() << "\n";
+        return EXIT_FAILURE;
+    } catch (const InvalidItemException& e) {
+        std::cerr << "Item Loading Error: " << e.what() << "\n";
+        return EXIT_FAILURE;
+    } catch (const InvalidDealException& e) {
+        std::cerr << "Deal Loading Error: " << e.what() << "\n";
+        return EXIT_FAILURE;
+    } catch (const std::exception& e) {
+        std::cerr << "Error generating load: " << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}